@@ -3751,6 +3751,10 @@ Editor::history_changed ()
 			label = string_compose(S_("Command|Undo (%1)"), _session->next_undo());
 		}
 		undo_action->property_label() = label;
+
+		gchar* size = g_format_size (_session->history().memory_size ());
+		undo_action->set_tooltip (string_compose (_("Undo history: %1 operations, %2 in memory"), _session->undo_depth(), size));
+		g_free (size);
 	}
 
 	if (redo_action && _session) {
@@ -156,6 +156,7 @@ ExportDialog::init ()
 	/* Progress indicators */
 
 	progress_widget.pack_start (progress_bar, false, false, 6);
+	progress_widget.pack_start (stem_progress_label, false, false, 0);
 
 	/* Buttons */
 	cancel_button = add_button (Gtk::Stock::CANCEL, RESPONSE_CANCEL);
@@ -409,6 +410,7 @@ ExportDialog::show_progress ()
 	warning_widget.hide_all();
 	progress_widget.show ();
 	progress_widget.show_all_children ();
+	stem_progress_label.set_text ("");
 	progress_connection = Glib::signal_timeout().connect (sigc::mem_fun(*this, &ExportDialog::progress_timeout), 100);
 
 	gtk_main_iteration ();
@@ -546,6 +548,7 @@ ExportDialog::progress_timeout ()
 	}
 
 	progress_bar.set_text (status_text);
+	update_stem_progress ();
 
 	if (progress < previous_progress) {
 		// Work around gtk bug
@@ -563,6 +566,40 @@ ExportDialog::progress_timeout ()
 	return TRUE;
 }
 
+void
+ExportDialog::update_stem_progress ()
+{
+	ExportStatus::StemProgress stems;
+	{
+		Glib::Threads::Mutex::Lock lm (status->stem_lock ());
+		stems = status->stem_progress;
+	}
+
+	if (stems.empty ()) {
+		stem_progress_label.set_text ("");
+		return;
+	}
+
+	/* only show the stem that is furthest behind */
+	size_t                                     n_done  = 0;
+	ExportStatus::StemProgress::const_iterator slowest = stems.begin ();
+	for (ExportStatus::StemProgress::const_iterator i = stems.begin (); i != stems.end (); ++i) {
+		if (i->second >= 1.f) {
+			++n_done;
+		}
+		if (i->second < slowest->second) {
+			slowest = i;
+		}
+	}
+
+	if (n_done == stems.size ()) {
+		stem_progress_label.set_text (string_compose (_("%1 stems encoded"), stems.size ()));
+	} else {
+		stem_progress_label.set_text (string_compose (_("%1 of %2 stems encoded, '%3' is at %4%%"),
+		                                              n_done, stems.size (), slowest->first, (int) (100.f * slowest->second)));
+	}
+}
+
 void
 ExportDialog::add_error (string const & text)
 {
@@ -148,8 +148,11 @@ private:
 	/* Progress bar */
 
 	Gtk::ProgressBar        progress_bar;
+	Gtk::Label              stem_progress_label;
 	sigc::connection        progress_connection;
 
+	void update_stem_progress ();
+
 	float previous_progress; // Needed for gtk bug workaround
 
 	bool _initialized;
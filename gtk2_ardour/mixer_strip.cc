@@ -1153,6 +1153,12 @@ MixerStrip::build_route_ops_menu ()
 	denormal_menu_item = dynamic_cast<Gtk::CheckMenuItem *> (&items.back());
 	denormal_menu_item->set_active (_route->denormal_protection());
 
+	if (!_route->is_monitor ()) {
+		items.push_back (CheckMenuElem (_("Pipelined Processing"), sigc::mem_fun (*this, &RouteUI::toggle_pipelined)));
+		pipelined_menu_item = dynamic_cast<Gtk::CheckMenuItem *> (&items.back());
+		pipelined_menu_item->set_active (_route->pipelined());
+	}
+
 	/* note that this relies on selection being shared across editor and
 	 * mixer (or global to the backend, in the future), which is the only
 	 * sane thing for users anyway.
@@ -2393,6 +2393,18 @@ RCOptionEditor::RCOptionEditor ()
 
 	add_option (_("General"), new UndoOptions (_rc_config));
 
+	SpinOption<uint32_t>* hml = new SpinOption<uint32_t> (
+		"history-memory-limit",
+		_("Limit undo history memory to"),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::get_history_memory_limit),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::set_history_memory_limit),
+		0, 16384, 16, 256,
+		_("MiB")
+		);
+	Gtkmm2ext::UI::instance()->set_tip (hml->tip_widget(),
+					    _("When the undo history uses more memory than this, older undo information is moved to a temporary file, and if necessary the oldest operations are forgotten. 0 means no limit."));
+	add_option (_("General"), hml);
+
 	add_option (_("General"),
 	     new BoolOption (
 		     "verify-remove-last-capture",
@@ -2448,6 +2460,26 @@ RCOptionEditor::RCOptionEditor ()
 
 	add_option (_("General"), new OptionEditorHeading (_("Export")));
 
+	bo = new BoolOption (
+		"export-pipelined",
+			_("Encode in separate threads when exporting faster than realtime"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_export_pipelined),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_export_pipelined)
+			);
+	add_option (_("General"), bo);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+					    _("<b>When enabled</b> sample-rate conversion, analysis and encoding run in separate threads, concurrently for each format, so that the session can be processed while the previous data is encoded."));
+
+	bo = new BoolOption (
+		"export-single-pass",
+		_("Export overlapping time ranges in a single pass"),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::get_export_single_pass),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::set_export_single_pass)
+		);
+	add_option (_("General"), bo);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+					    _("<b>When enabled</b> time ranges that overlap are exported together when exporting faster than realtime, and the session is processed only once. <b>When disabled</b> the session is processed separately for each time range."));
+
 	add_option (_("General"),
 	     new BoolOption (
 		     "save-export-analysis-image",
@@ -3791,6 +3823,17 @@ These settings will only take effect after %1 is restarted.\n\
 				sigc::mem_fun (*this, &RCOptionEditor::plugin_scan_refresh)));
 
 	add_option (_("Plugins"), new PluginScanTimeOutSliderOption (_rc_config));
+
+	SpinOption<uint32_t>* psj = new SpinOption<uint32_t> (
+		"plugin-scan-jobs",
+		_("Concurrent plugin scans"),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::get_plugin_scan_jobs),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::set_plugin_scan_jobs),
+		0, 64, 1, 4
+		);
+	Gtkmm2ext::UI::instance()->set_tip (psj->tip_widget(),
+					    _("Number of VST plugins that are scanned at the same time, each in a separate process. 0 uses one scanner per CPU core, 1 scans one plugin at a time."));
+	add_option (_("Plugins"), psj);
 #endif
 
 	add_option (_("Plugins"), new OptionEditorHeading (_("General")));
@@ -3848,6 +3891,16 @@ These settings will only take effect after %1 is restarted.\n\
 	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
 					    _("<b>When enabled</b> plugins will be activated when they are added to tracks/busses. When disabled plugins will be left inactive when they are added to tracks/busses"));
 
+	bo = new BoolOption (
+		"plugin-sleep-when-silent",
+			_("Do not process plugins while their input is silent"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_plugin_sleep_when_silent),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_plugin_sleep_when_silent)
+			);
+	add_option (_("Plugins"), bo);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+					    _("<b>When enabled</b> effect plugins are not processed while their input is silent, once their tail (e.g. reverb decay) has ended. They resume as soon as the input is no longer silent or a plugin parameter changes. Instruments and plugins with a sidechain input are always processed."));
+
 	add_option (_("Plugins/GUI"), new OptionEditorHeading (_("Plugin GUI")));
 	add_option (_("Plugins/GUI"),
 	     new BoolOption (
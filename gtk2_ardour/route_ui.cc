@@ -194,6 +194,7 @@ RouteUI::init ()
 	_solo_release = 0;
 	_mute_release = 0;
 	denormal_menu_item = 0;
+	pipelined_menu_item = 0;
 	_step_edit_item = 0;
 	_rec_safe_item = 0;
 	_ignore_comment_edit = false;
@@ -293,6 +294,7 @@ RouteUI::reset ()
 	_color_picker.reset ();
 
 	denormal_menu_item = 0;
+	pipelined_menu_item = 0;
 }
 
 void
@@ -1840,6 +1842,14 @@ RouteUI::toggle_denormal_protection ()
 	}
 }
 
+void
+RouteUI::toggle_pipelined ()
+{
+	if (pipelined_menu_item) {
+		_route->set_pipelined (pipelined_menu_item->get_active ());
+	}
+}
+
 void
 RouteUI::denormal_protection_changed ()
 {
@@ -133,6 +133,7 @@ public:
 	void duplicate_selected_routes ();
 	void toggle_step_edit ();
 	void toggle_denormal_protection ();
+	void toggle_pipelined ();
 	void save_as_template ();
 
 	bool mute_press (GdkEventButton*);
@@ -256,6 +257,7 @@ protected:
 	void         show_playlist_steal_selector ();
 
 	Gtk::CheckMenuItem* denormal_menu_item;
+	Gtk::CheckMenuItem* pipelined_menu_item;
 
 	static void        set_showing_sends_to (boost::shared_ptr<ARDOUR::Route>);
 	static std::string program_port_prefix;
@@ -152,6 +152,84 @@ Amp::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end_sampl
 	}
 }
 
+void
+Amp::fuse (pframes_t nframes, gain_t* curve, bool& have_curve, gain_t& gain)
+{
+	if (!check_active()) {
+		_apply_gain_automation = false;
+		return;
+	}
+
+	const gain_t a = 156.825f / (gain_t)_session.nominal_sample_rate(); // 25 Hz LPF; see Amp::apply_gain for details
+
+	if (_apply_gain_automation) {
+
+		gain_t* gab = _gain_automation_buffer;
+		assert (gab);
+
+		if (nframes > 0) {
+			_gain_control->set_value_unchecked (gab[nframes -1]);
+		}
+
+		gain_t lpf = _current_gain;
+
+		if (have_curve) {
+			for (pframes_t nx = 0; nx < nframes; ++nx) {
+				curve[nx] *= lpf;
+				lpf += a * (gab[nx] - lpf);
+			}
+		} else {
+			for (pframes_t nx = 0; nx < nframes; ++nx) {
+				curve[nx] = lpf;
+				lpf += a * (gab[nx] - lpf);
+			}
+		}
+		have_curve = true;
+
+		if (fabsf (lpf) < GAIN_COEFF_SMALL) {
+			_current_gain = GAIN_COEFF_ZERO;
+		} else {
+			_current_gain = lpf;
+		}
+
+		_apply_gain_automation = false;
+
+	} else {
+
+		gain_t const target_gain = _gain_control->get_value();
+
+		if (fabsf (_current_gain - target_gain) >= GAIN_COEFF_DELTA) {
+
+			double lpf = _current_gain;
+
+			if (have_curve) {
+				for (pframes_t nx = 0; nx < nframes; ++nx) {
+					curve[nx] *= lpf;
+					lpf += a * (target_gain - lpf);
+				}
+			} else {
+				for (pframes_t nx = 0; nx < nframes; ++nx) {
+					curve[nx] = lpf;
+					lpf += a * (target_gain - lpf);
+				}
+			}
+			have_curve = true;
+
+			if (fabsf (lpf - target_gain) < GAIN_COEFF_DELTA) {
+				_current_gain = target_gain;
+			} else {
+				_current_gain = lpf;
+			}
+
+			_gain_control->Changed (false, PBD::Controllable::NoGroup);
+
+		} else {
+			_current_gain = target_gain;
+			gain *= target_gain;
+		}
+	}
+}
+
 gain_t
 Amp::apply_gain (BufferSet& bufs, samplecnt_t sample_rate, samplecnt_t nframes, gain_t initial, gain_t target, bool midi_amp)
 {
@@ -54,6 +54,15 @@ public:
 
 	void setup_gain_automation (samplepos_t start_sample, samplepos_t end_sample, samplecnt_t nframes);
 
+	/** Like run(), but instead of applying the gain to buffers, multiply it
+	 *  into @p curve or @p gain. Used by a route to apply consecutive gain
+	 *  stages in a single pass, MIDI is not handled.
+	 *  @param curve per-sample gain, only valid if @p have_curve is true
+	 *  @param have_curve set to true if the gain of this stage changes during the cycle
+	 *  @param gain multiplied by the gain of this stage if it is constant
+	 */
+	void fuse (pframes_t nframes, gain_t* curve, bool& have_curve, gain_t& gain);
+
 	XMLNode& state () const;
 	int set_state (const XMLNode&, int version);
 
@@ -71,6 +80,8 @@ public:
 		return _gain_control;
 	}
 
+	gain_t current_gain () const { return _current_gain; }
+
 private:
 	bool   _apply_gain_automation;
 	float  _current_gain;
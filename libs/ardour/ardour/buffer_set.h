@@ -135,6 +135,7 @@ public:
 	void read_from(const BufferSet& in, samplecnt_t nframes);
 	void read_from(const BufferSet& in, samplecnt_t nframes, DataType);
 	void merge_from(const BufferSet& in, samplecnt_t nframes);
+	void merge_from(const BufferSet& in, samplecnt_t nframes, DataType);
 
 	template <typename BS, typename B>
 	class iterator_base {
@@ -22,12 +22,21 @@
 #ifndef __ardour_export_graph_builder_h__
 #define __ardour_export_graph_builder_h__
 
+#include "pbd/g_atomic_compat.h"
+#include "pbd/ringbuffer.h"
+#include "pbd/semutils.h"
+
 #include "ardour/export_handler.h"
 #include "ardour/export_analysis.h"
 #include "ardour/export_smf_writer.h"
+#include "ardour/export_status.h"
 
+#include "audiographer/sink.h"
 #include "audiographer/utils/identity_vertex.h"
 
+#include <algorithm>
+#include <pthread.h>
+#include <set>
 #include <boost/ptr_container/ptr_list.hpp>
 #include <glibmm/threadpool.h>
 
@@ -46,6 +55,7 @@ namespace AudioGrapher {
 	template <typename T> class CmdPipeWriter;
 	template <typename T> class SilenceTrimmer;
 	template <typename T> class TmpFile;
+	template <typename T> class MappedTmpFile;
 	template <typename T> class Threader;
 	template <typename T> class AllocatingProcessContext;
 }
@@ -67,6 +77,25 @@ class LIBARDOUR_API ExportGraphBuilder
 	typedef std::map<std::string, AnalysisPtr> AnalysisMap;
 
 	struct AnyExport {
+		AnyExport (samplepos_t s, samplepos_t e) : start (s), end (e) {}
+
+		/* Part of the timespan in the cycle [pos, pos + cnt), the offset
+		 * is relative to pos. @return false if there is none.
+		 */
+		bool overlap (samplepos_t pos, samplecnt_t cnt, sampleoffset_t& off, samplecnt_t& n, bool& last) const {
+			samplepos_t const s = std::max (pos, start);
+			samplepos_t const e = std::min (pos + cnt, end);
+			if (s > e || (s == e && cnt > 0)) {
+				return false;
+			}
+			off  = s - pos;
+			n    = e - s;
+			last = e == end;
+			return true;
+		}
+		/* Timespan that is exported */
+		samplepos_t start;
+		samplepos_t end;
 		/* Audio export */
 		AudioGrapher::IdentityVertex<Sample> audio;
 		void add_output (AudioGrapher::Source<Sample>::SinkPtr output) {
@@ -75,6 +104,8 @@ class LIBARDOUR_API ExportGraphBuilder
 		void process (AudioGrapher::ProcessContext<Sample> const& c) {
 			audio.process (c);
 		}
+		/* Audio queued for the encoder thread (pipelined export) */
+		boost::shared_ptr<PBD::RingBuffer<Sample> > queue;
 		/* MIDI Export */
 		ExportSMFWriter midi;
 		void process (MidiBuffer const& buf, sampleoffset_t off, samplecnt_t cnt, bool last_cycle) {
@@ -83,14 +114,18 @@ class LIBARDOUR_API ExportGraphBuilder
 	};
 
 	typedef boost::shared_ptr<AnyExport> AnyExportPtr;
-	typedef std::map<ExportChannelPtr, AnyExportPtr> ChannelMap;
+	/* Channels are shared by timespans that are exported in the same pass */
+	typedef std::map<std::pair<ExportChannelPtr, boost::shared_ptr<ExportTimespan> >, AnyExportPtr> ChannelMap;
 
   public:
 
 	ExportGraphBuilder (Session const & session);
 	~ExportGraphBuilder ();
 
-	samplecnt_t process (samplecnt_t samples, bool last_cycle);
+	/** Process a cycle, @p pos is the position of its first sample,
+	 * only timespans that overlap the cycle are processed.
+	 */
+	samplecnt_t process (samplepos_t pos, samplecnt_t samples, bool last_cycle);
 	bool post_process (); // returns true when finished
 	bool need_postprocessing () const { return !intermediates.empty(); }
 	bool realtime() const { return _realtime; }
@@ -101,10 +136,10 @@ class LIBARDOUR_API ExportGraphBuilder
 	void set_current_timespan (boost::shared_ptr<ExportTimespan> span);
 	void add_config (FileSpec const & config, bool rt);
 	void get_analysis_results (AnalysisResults& results);
+	/** Fraction of each stem that was encoded, if stems are encoded concurrently */
+	void get_stem_progress (ExportStatus::StemProgress& progress) const;
 
-	std::vector<std::string> exported_files () const {
-		return _exported_files;
-	}
+	std::vector<std::string> exported_files (boost::shared_ptr<ExportTimespan> span) const;
 
   private:
 
@@ -113,13 +148,51 @@ class LIBARDOUR_API ExportGraphBuilder
 	}
 
 	void add_export_fn (std::string const& fn) {
-		_exported_files.push_back (fn);
+		_exported_files.push_back (std::make_pair (timespan, fn));
 	}
 
-	std::vector<std::string> _exported_files;
+	std::vector<std::pair<boost::shared_ptr<ExportTimespan>, std::string> > _exported_files;
 
 	void add_split_config (FileSpec const & config);
 
+	/* Pipelined export: process() only queues the data of audio channels,
+	 * the encoder thread runs the export graph.
+	 */
+	struct EncoderCycle {
+		samplepos_t pos;
+		samplecnt_t samples;
+		bool        last_cycle;
+	};
+
+	/* Channels that feed the same channel configurations are encoded
+	 * together, independent stems are encoded concurrently.
+	 */
+	class Stem : public AudioGrapher::Sink<Sample> {
+	  public:
+		Stem (ExportGraphBuilder & parent, std::string const& name, samplecnt_t length);
+		/* encodes the current cycle, the context is not used */
+		void process (AudioGrapher::ProcessContext<Sample> const&);
+		using AudioGrapher::Sink<Sample>::process;
+		void discard (EncoderCycle const&);
+
+		std::string               name;
+		std::vector<AnyExportPtr> channels;
+		samplecnt_t               length;
+		volatile samplecnt_t      encoded;
+
+	  private:
+		ExportGraphBuilder & parent;
+		std::vector<Sample>  buffer;
+	};
+
+	typedef boost::shared_ptr<Stem> StemPtr;
+
+	void start_encoder ();
+	void stop_encoder ();
+	void encoder_thread ();
+	void encode (EncoderCycle const&);
+	static void* _encoder_thread (void*);
+
 	class Encoder {
             public:
 		template <typename T> boost::shared_ptr<AudioGrapher::Sink<T> > init (FileSpec const & new_config);
@@ -211,11 +284,26 @@ class LIBARDOUR_API ExportGraphBuilder
 		typedef boost::shared_ptr<AudioGrapher::PeakReader> PeakReaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::LoudnessReader> LoudnessReaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::TmpFile<Sample> > TmpFilePtr;
+		typedef boost::shared_ptr<AudioGrapher::MappedTmpFile<Sample> > MappedTmpFilePtr;
 		typedef boost::shared_ptr<AudioGrapher::Threader<Sample> > ThreaderPtr;
 		typedef boost::shared_ptr<AudioGrapher::AllocatingProcessContext<Sample> > BufferPtr;
 
+		/* Writes the intermediate file and analyses the data concurrently,
+		 * post-processing starts once both are complete.
+		 */
+		class FirstPass : public AudioGrapher::Sink<Sample> {
+		  public:
+			FirstPass (Intermediate & parent) : parent (parent) {}
+			void process (AudioGrapher::ProcessContext<Sample> const&);
+			using AudioGrapher::Sink<Sample>::process;
+
+		  private:
+			Intermediate & parent;
+		};
+
 		void prepare_post_processing ();
 		void start_post_processing ();
+		samplecnt_t samples_written () const;
 
 		ExportGraphBuilder & parent;
 
@@ -228,6 +316,11 @@ class LIBARDOUR_API ExportGraphBuilder
 		TmpFilePtr      tmp_file;
 		ThreaderPtr     threader;
 
+		/* used instead of tmp_file when not exporting in realtime */
+		MappedTmpFilePtr mapped_file;
+		ThreaderPtr      analysis_threader;
+		FloatSinkPtr     first_pass;
+
 		LoudnessReaderPtr    loudness_reader;
 		boost::ptr_list<SFC> children;
 
@@ -246,6 +339,7 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	                                        private:
 		typedef boost::shared_ptr<AudioGrapher::SampleRateConverter> SRConverterPtr;
+		typedef boost::shared_ptr<AudioGrapher::Threader<Sample> > ThreaderPtr;
 
 		template<typename T>
 		void add_child_to_list (FileSpec const & new_config, boost::ptr_list<T> & list);
@@ -255,6 +349,7 @@ class LIBARDOUR_API ExportGraphBuilder
 		boost::ptr_list<SFC>  children;
 		boost::ptr_list<Intermediate> intermediate_children;
 		SRConverterPtr        converter;
+		ThreaderPtr           threader;
 		samplecnt_t           max_samples_out;
 	};
 
@@ -285,6 +380,11 @@ class LIBARDOUR_API ExportGraphBuilder
 		void remove_children (bool remove_out_files);
 		bool operator== (FileSpec const & other_config) const;
 
+		boost::shared_ptr<ExportTimespan> timespan () const { return _timespan; }
+		std::string name () const;
+		/* audio channels that feed this configuration */
+		std::vector<AnyExportPtr> const& inputs () const { return _inputs; }
+
 	                                        private:
 		typedef boost::shared_ptr<AudioGrapher::Interleaver<Sample> > InterleaverPtr;
 		typedef boost::shared_ptr<AudioGrapher::Chunker<Sample> > ChunkerPtr;
@@ -295,6 +395,8 @@ class LIBARDOUR_API ExportGraphBuilder
 		InterleaverPtr            interleaver;
 		ChunkerPtr                chunker;
 		samplecnt_t               max_samples_out;
+		std::vector<AnyExportPtr> _inputs;
+		boost::shared_ptr<ExportTimespan> _timespan;
 	};
 
 	Session const & session;
@@ -306,6 +408,7 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	// The sources of all data, each channel is read only once
 	ChannelMap channels;
+	std::set<boost::shared_ptr<ExportTimespan> > timespans;
 
 	samplecnt_t process_buffer_samples;
 
@@ -318,6 +421,21 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	Glib::ThreadPool     thread_pool;
 	Glib::Threads::Mutex engine_request_lock;
+
+	bool                                            _pipelined;
+	bool                                            _encoder_running;
+	pthread_t                                       _encoder_thread_id;
+	boost::shared_ptr<PBD::RingBuffer<EncoderCycle> > _encoder_cycles;
+	EncoderCycle                                    _encoder_cycle;
+	std::list<StemPtr>                              _stems;
+	boost::shared_ptr<AudioGrapher::Threader<Sample> > _stem_threader;
+	Glib::ThreadPool                                _stem_pool;
+	Glib::ThreadPool                                _analysis_pool;
+	PBD::Semaphore                                  _encoder_sem;
+	PBD::Semaphore                                  _encoder_space;
+	GATOMIC_QUAL gint                               _encoder_quit;
+	GATOMIC_QUAL gint                               _encoder_failed;
+	std::string                                     _encoder_error;
 };
 
 } // namespace ARDOUR
@@ -152,11 +152,18 @@ class LIBARDOUR_API ExportHandler : public ExportElementFactory, public sigc::tr
 	int  process_timespan (samplecnt_t samples);
 	int  post_process ();
 	void finish_timespan ();
+	bool can_share_pass (ExportTimespanPtr) const;
 
 	typedef std::pair<ConfigMap::iterator, ConfigMap::iterator> TimespanBounds;
 	ExportTimespanPtr     current_timespan;
 	TimespanBounds        timespan_bounds;
 
+	/* Overlapping timespans are exported in a single pass, current_timespan
+	 * is the first of them.
+	 */
+	std::vector<ExportTimespanPtr> pass_timespans;
+	samplepos_t                    pass_end;
+
 	PBD::ScopedConnection process_connection;
 	samplepos_t           process_position;
 
@@ -23,6 +23,7 @@
 #ifndef __ardour_export_status_h__
 #define __ardour_export_status_h__
 
+#include <map>
 #include <stdint.h>
 
 #include "ardour/libardour_visibility.h"
@@ -85,12 +86,18 @@ class LIBARDOUR_API ExportStatus {
 
 	AnalysisResults         result_map;
 
+	/* Stems that are encoded concurrently, fraction that was encoded by name */
+	typedef std::map<std::string, float> StemProgress;
+	StemProgress            stem_progress;
+	Glib::Threads::Mutex& stem_lock () { return _stem_lock; }
+
   private:
 	volatile bool          _aborted;
 	volatile bool          _errors;
 	volatile bool          _running;
 
 	Glib::Threads::Mutex   _run_lock;
+	Glib::Threads::Mutex   _stem_lock;
 };
 
 } // namespace ARDOUR
@@ -88,6 +88,12 @@ public:
 
 	static PBD::Signal2<int,std::string,std::vector<std::string> > AmbiguousFileName;
 
+	/** If @p yn is true, find() called from this thread fails on ambiguous
+	 * file names instead of emitting AmbiguousFileName. Used by threads
+	 * that cannot interact with the user.
+	 */
+	static void set_quiet_find_in_this_thread (bool yn);
+
 	void existence_check ();
 	virtual void prevent_deletion ();
 
@@ -94,6 +94,11 @@ public:
 	/* RTTasks */
 	void process_tasklist (RTTaskList const&);
 
+	/* called by RTSubTasks from a process thread */
+	bool  dispatch (ProcessNode*);
+	bool  run_queued ();
+	guint n_idle_threads () const;
+
 protected:
 	virtual void session_going_away ();
 
@@ -107,7 +112,8 @@ private:
 	void helper_thread ();
 
 	PBD::MPMCQueue<ProcessNode*> _trigger_queue;      ///< nodes that can be processed
-	GATOMIC_QUAL guint           _trigger_queue_size; ///< number of entries in trigger-queue
+	PBD::MPMCQueue<ProcessNode*> _subtask_queue;      ///< RTSubTasks helpers, see dispatch()
+	GATOMIC_QUAL guint           _trigger_queue_size; ///< number of entries in both queues
 
 	/** Start worker threads */
 	PBD::Semaphore _execution_sem;
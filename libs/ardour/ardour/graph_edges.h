@@ -66,8 +66,6 @@ private:
 	EdgeMapWithSends::iterator find_in_from_to_with_sends (GraphVertex, GraphVertex);
 	EdgeMapWithSends::iterator find_in_to_from_with_sends (GraphVertex, GraphVertex);
 
-	EdgeMapWithSends::const_iterator find_recursively_in_from_to_with_sends (GraphVertex, GraphVertex) const;
-
 	/** map of edges with from as `first' and to as `second' */
 	EdgeMap _from_to;
 	/** map of the same edges with to as `first' and from as `second' */
@@ -81,6 +79,7 @@ private:
 };
 
 bool topological_sort (GraphNodeList&, GraphEdges&);
+bool topological_sort (GraphNodeList&, GraphEdges&, std::set<GraphVertex> const& changed, bool& edges_changed);
 
 }
 
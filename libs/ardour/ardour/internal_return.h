@@ -49,6 +49,8 @@ protected:
 	XMLNode& state () const;
 
 private:
+	void merge_midi_from_sends (BufferSet&);
+
 	/** sends that we are receiving data from */
 	std::list<InternalSend*> _sends;
 	/** mutex to protect _sends */
@@ -62,6 +62,17 @@ public:
 		}
 		return false;
 	}
+
+	bool has_port (boost::shared_ptr<Port> p) const {
+		for (IOVector::const_iterator i = begin(); i != end(); ++i) {
+			boost::shared_ptr<const IO> io = i->lock();
+			if (!io) continue;
+			if (io->has_port (p)) {
+				return true;
+			}
+		}
+		return false;
+	}
 };
 
 } // namespace ARDOUR
@@ -389,6 +389,8 @@ class LIBARDOUR_API LV2Plugin : public ARDOUR::Plugin, public ARDOUR::Workee
 	void do_remove_preset (std::string);
 	void find_presets ();
 	void add_state (XMLNode *) const;
+	void deferred_restore ();
+	void deferred_restore_done ();
 };
 
 
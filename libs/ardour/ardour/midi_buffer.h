@@ -33,6 +33,7 @@
 
 namespace ARDOUR {
 
+class MidiBufferMerger;
 
 /** Buffer containing 8-bit unsigned char (MIDI) data. */
 class LIBARDOUR_API MidiBuffer : public Buffer, public Evoral::EventSink<samplepos_t>
@@ -47,6 +48,13 @@ public:
 	void read_from (const Buffer& src, samplecnt_t nframes, sampleoffset_t dst_offset = 0, sampleoffset_t src_offset = 0);
 	void merge_from (const Buffer& src, samplecnt_t nframes, sampleoffset_t dst_offset = 0, sampleoffset_t src_offset = 0);
 
+	/** Replace the contents of this buffer with all events of the
+	 * merger's sources, in time order (single pass, RT-safe).
+	 * This buffer must not be one of the sources.
+	 * @return false if not all events fit.
+	 */
+	bool read_from (MidiBufferMerger&);
+
 	void copy(const MidiBuffer& copy);
 	void copy(MidiBuffer const * const);
 
@@ -185,6 +193,7 @@ public:
 private:
 	friend class iterator_base< MidiBuffer, Evoral::Event<TimeType> >;
 	friend class iterator_base< const MidiBuffer, const Evoral::Event<TimeType> >;
+	friend class MidiBufferMerger;
 
 	static size_t align32 (size_t s) {
 #if defined(__arm__) || defined(__aarch64__)
@@ -198,6 +207,63 @@ private:
 	pframes_t _size;
 };
 
+/** k-way merge of time-ordered MidiBuffers.
+ *
+ * Unlike repeated MidiBuffer::merge_in_place() (which moves the data of
+ * the destination for every insertion), all sources are walked once using
+ * a min-heap. Events are referenced in place in their source buffers;
+ * ::next() hands out pointers, MidiBuffer::read_from() copies them.
+ *
+ * No memory is allocated, so this is RT-safe, but the number of sources
+ * is limited to max_sources.
+ */
+class LIBARDOUR_API MidiBufferMerger
+{
+public:
+	static const uint32_t max_sources = 64;
+
+	MidiBufferMerger () : _n_sources (0), _n_active (0), _started (false) {}
+
+	/** Add a source. Empty sources are ignored.
+	 * @return false if there are already max_sources sources.
+	 */
+	bool add (MidiBuffer const&);
+	void clear () { _n_sources = _n_active = 0; _started = false; }
+
+	uint32_t n_sources () const { return _n_sources; }
+
+	/** Retrieve the next event, in time order. Simultaneous events are
+	 * ordered by type as MidiBuffer::second_simultaneous_midi_byte_is_first()
+	 * requires (also across channels), otherwise by source.
+	 * The data remains valid until the source buffer is modified.
+	 * @return false once all sources are exhausted
+	 */
+	bool next (MidiBuffer::TimeType& time, Evoral::EventType& type, uint32_t& size, uint8_t const *& data);
+
+private:
+	struct Cursor {
+		MidiBuffer const* buffer;
+		size_t            offset;
+		uint32_t          index;
+
+		MidiBuffer::TimeType time () const {
+			return *(reinterpret_cast<MidiBuffer::TimeType const*>((uintptr_t)(buffer->_data + offset)));
+		}
+		uint8_t const* data () const {
+			return buffer->_data + offset + sizeof (MidiBuffer::TimeType) + sizeof (Evoral::EventType);
+		}
+	};
+
+	static int  simultaneous_rank (uint8_t);
+	static bool earlier (Cursor const&, Cursor const&);
+	void sift_down (uint32_t);
+
+	Cursor   _cursors[max_sources];
+	uint32_t _n_sources;
+	uint32_t _n_active;
+	bool     _started;
+};
+
 } // namespace ARDOUR
 
 #endif // __ardour_midi_buffer_h__
@@ -25,9 +25,14 @@
 
 #include <vector>
 #include <list>
+#include <map>
 
 #include <boost/utility.hpp>
 
+#include <glibmm/threads.h>
+
+#include "pbd/timing.h"
+
 #include "evoral/Parameter.h"
 
 #include "ardour/ardour.h"
@@ -41,6 +46,7 @@
 
 namespace Evoral {
 template<typename Time> class EventSink;
+template<typename Time> class EventList;
 class                         Beats;
 }
 
@@ -74,6 +80,20 @@ public:
 	void render (MidiChannelFilter*);
 	RTMidiBuffer* rendered();
 
+	/** Re-render only those parts of the RTMidiBuffer that have changed
+	 * since the last call to ::render() or ::render_incremental(), and
+	 * splice the result into the existing buffer. Falls back to a full
+	 * ::render() if the changed ranges are not known.
+	 */
+	void render_incremental (MidiChannelFilter*);
+
+	/** Force the next ::render_incremental() to render everything (e.g.
+	 * because the channel filter changed).
+	 */
+	void invalidate_rendered ();
+
+	bool get_render_stats (bool incremental, PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev) const;
+
 	int set_state (const XMLNode&, int version);
 
 	bool destroy_region (boost::shared_ptr<Region>);
@@ -90,13 +110,36 @@ public:
   protected:
 	void remove_dependents (boost::shared_ptr<Region> region);
 	void region_going_away (boost::weak_ptr<Region> region);
+	bool region_changed (const PBD::PropertyChange&, boost::shared_ptr<Region>);
+	void region_range_invalidated (Temporal::Range const &);
 
   private:
+	typedef std::list<boost::shared_ptr<MidiRegion> > MidiRegionList;
+
 	void dump () const;
+	void renderable_regions (MidiRegionList&);
+	void render_regions (MidiRegionList&, Evoral::EventList<samplepos_t>&, MidiChannelFilter*);
+	void update_rendered_layers ();
 
 	NoteMode     _note_mode;
 
 	RTMidiBuffer _rendered;
+	RTMidiBuffer _splice_buffer;
+
+	/* time ranges that need to be re-rendered, written by the GUI thread,
+	 * consumed by the butler via ::render_incremental()
+	 */
+	Glib::Threads::Mutex       _dirty_lock;
+	std::list<Temporal::Range> _dirty_ranges;
+	bool                       _render_all;
+
+	/* region layers at the time of the last render, used to detect
+	 * re-layering (which is not signalled per region).
+	 */
+	std::map<PBD::ID, layer_t> _rendered_layers;
+
+	PBD::TimingStats _render_stats;
+	PBD::TimingStats _incremental_render_stats;
 };
 
 } /* namespace ARDOUR */
@@ -243,6 +243,18 @@ class LIBARDOUR_API MidiSource : virtual public Source
 	 */
 	typedef std::map<Evoral::Parameter, AutoState> AutomationStateMap;
 	AutomationStateMap  _automation_state;
+
+  private:
+	/** (Short) events queued by midi_read() until their time is known */
+	struct PendingEvent {
+		Evoral::EventType type;
+		uint32_t          size;
+		uint8_t           buf[3];
+	};
+
+	static const size_t max_pending = 64;
+
+	static void write_pending (Evoral::EventSink<samplepos_t>&, Temporal::Beats const *, PendingEvent const *, size_t);
 };
 
 }
@@ -183,6 +183,8 @@ private:
 
 	void playlist_contents_changed ();
 	PBD::ScopedConnection playlist_content_change_connection;
+
+	void playback_filter_changed ();
 };
 
 } /* namespace ARDOUR*/
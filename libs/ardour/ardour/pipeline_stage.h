@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_pipeline_stage_h__
+#define __ardour_pipeline_stage_h__
+
+#include <vector>
+
+#include <boost/shared_array.hpp>
+
+#include "ardour/types.h"
+#include "ardour/processor.h"
+
+namespace ARDOUR {
+
+class BufferSet;
+class ChanCount;
+class Session;
+
+/** Boundary between two stages of a pipelined route.
+ *
+ * The processors before and after the stage can run concurrently,
+ * because the stage passes on the audio of the previous cycle. This adds
+ * one cycle of latency, which is reported as the stage's signal latency.
+ *
+ * When the processors are run one after another (or when bouncing),
+ * the stage is a plain delay of one cycle.
+ */
+class LIBARDOUR_API PipelineStage : public Processor {
+public:
+	PipelineStage (Session& s, const std::string& name);
+	~PipelineStage ();
+
+	bool set_name (const std::string& str);
+
+	/* processor interface */
+	bool display_to_user () const { return false; }
+	samplecnt_t signal_latency () const;
+	void run (BufferSet&, samplepos_t, samplepos_t, double, pframes_t, bool);
+	bool configure_io (ChanCount in, ChanCount out);
+	bool can_support_io_configuration (const ChanCount& in, ChanCount& out);
+	int  set_block_size (pframes_t);
+
+	/** @return true if the route can be split here, only audio can be passed on */
+	bool can_split () const { return _can_split; }
+
+	/** Store the output of the first stage, called by the first stage */
+	void write (BufferSet const&, pframes_t);
+	/** Retrieve the output of the previous cycle, called by the second stage */
+	void read (BufferSet&, pframes_t) const;
+	/** Move on, after both stages have completed */
+	void advance (pframes_t);
+
+protected:
+	XMLNode& state () const;
+
+private:
+	void allocate (ChanCount const&);
+
+	typedef std::vector<boost::shared_array<Sample> > AudioBuf;
+
+	AudioBuf    _buf;
+	samplecnt_t _period;
+	samplecnt_t _bsiz;
+	samplecnt_t _woff;
+	bool        _can_split;
+};
+
+} // namespace ARDOUR
+
+#endif // __ardour_pipeline_stage_h__
@@ -429,6 +429,11 @@ protected:
 	virtual void remove_dependents (boost::shared_ptr<Region> /*region*/) {}
 	virtual void region_going_away (boost::weak_ptr<Region> /*region*/) {}
 
+	/** Called whenever a region is added to or removed from the playlist,
+	 * with the time range it occupies.
+	 */
+	virtual void region_range_invalidated (Temporal::Range const &) {}
+
 	virtual XMLNode& state (bool) const;
 
 	bool add_region_internal (boost::shared_ptr<Region>, timepos_t const & position, ThawList& thawlist);
@@ -82,6 +82,25 @@ public:
 	XMLNode&    get_state () const;
 	virtual int set_state (const XMLNode&, int version);
 
+	/** While an instance of this class exists, plugins that support it
+	 * postpone the parts of set_state() which only concern the plugin
+	 * instance itself (e.g. a sampler or convolver loading its data).
+	 * run() does the postponed work of all plugins concurrently, which is
+	 * also done when the DeferredRestore goes out of scope.
+	 *
+	 * This must only be used by the main thread, while the plugins are not
+	 * yet processing (i.e. session load or route creation).
+	 */
+	class LIBARDOUR_API DeferredRestore {
+	public:
+		DeferredRestore ();
+		~DeferredRestore ();
+		void run ();
+
+	private:
+		static void restore (std::vector<Plugin*> const&, size_t);
+	};
+
 	virtual void set_insert_id (PBD::ID id) {}
 	virtual void set_state_dir (const std::string& d = "") {}
 
@@ -170,6 +189,11 @@ public:
 	/** the max possible latency a plugin will have */
 	virtual samplecnt_t max_latency () const { return 0; }
 
+	/** @return the duration of the plugin's output once its input became
+	 * silent (e.g. a reverb tail), -1 if unknown.
+	 */
+	virtual samplecnt_t signal_tailtime () const { return -1; }
+
 	virtual int  set_block_size (pframes_t nframes) = 0;
 	virtual bool requires_fixed_sized_buffers () const { return false; }
 	virtual bool inplace_broken () const { return false; }
@@ -390,6 +414,13 @@ protected:
 	 */
 	void state_changed ();
 
+	/** Called by set_state() to postpone restoring the plugin-internal state.
+	 * @return true if deferred_restore() will be called later,
+	 * false if the state has to be restored right away.
+	 */
+	bool defer_restore ();
+	bool restore_deferred () const { return _restore_deferred; }
+
 	ARDOUR::AudioEngine& _engine;
 	ARDOUR::Session&     _session;
 	PluginInfoPtr        _info;
@@ -408,6 +439,15 @@ private:
 	/** Add state to an existing XMLNode */
 	virtual void add_state (XMLNode*) const = 0;
 
+	/** Do the work postponed by set_state(). This is called concurrently
+	 * for different plugin instances.
+	 */
+	virtual void deferred_restore () {}
+	/** Called in the main thread once deferred_restore() has completed */
+	virtual void deferred_restore_done () {}
+
+	void finish_deferred_restore ();
+
 	bool             _have_presets;
 	MidiNoteTracker _tracker;
 	BufferSet        _pending_stop_events;
@@ -424,6 +464,7 @@ private:
 
 	PluginInsert* _pi;
 	uint32_t      _num;
+	bool          _restore_deferred;
 };
 
 struct PluginPreset {
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_plugin_index_h__
+#define __ardour_plugin_index_h__
+
+#include <map>
+#include <string>
+
+#include <glib.h>
+#include <stdint.h>
+
+#include "ardour/libardour_visibility.h"
+
+class XMLNode;
+class XMLTree;
+
+namespace ARDOUR {
+
+/** Binary index of plugin cache files.
+ *
+ * Every plugin that was scanned has an XML cache file (.v2i, .v3i, .auv2).
+ * Reading and parsing all of them dominates startup time with large plugin
+ * collections. The index keeps the parsed content of all cache files in a
+ * single file in a compact binary form, which is mapped into memory and
+ * only decoded for the entries that are used.
+ *
+ * An entry is valid as long as the size and modification time of its cache
+ * file match. Entries of changed cache files are re-parsed and replaced,
+ * entries that were not used since the index was loaded are dropped when
+ * it is saved.
+ */
+class LIBARDOUR_API PluginIndex
+{
+public:
+	PluginIndex ();
+	~PluginIndex ();
+
+	/** Map the index file at @p path. If the file is missing or invalid,
+	 * the index starts empty.
+	 */
+	void load (std::string const& path);
+
+	/** Write the index back to the file it was loaded from, if it changed */
+	int save ();
+
+	/** Read the cache file @p cache_file into @p tree, using the index
+	 * if it is up to date.
+	 * @param reparse ignore the index, e.g. after the file was just written
+	 * @return false if the cache file cannot be read
+	 */
+	bool read (std::string const& cache_file, XMLTree& tree, bool reparse = false);
+
+	size_t size () const { return _entries.size (); }
+	/** @return number of cache files that had to be parsed since load() */
+	size_t n_parsed () const { return _n_parsed; }
+
+private:
+	struct Entry {
+		Entry () : mtime (0), size (0), mapped (0), len (0), used (false) {}
+
+		char const* data () const { return mapped ? mapped : owned.data (); }
+		size_t      length () const { return mapped ? len : owned.size (); }
+
+		int64_t     mtime;
+		int64_t     size;
+		char const* mapped; /* points into the index file */
+		uint32_t    len;
+		std::string owned;  /* entries that were added since the index was loaded */
+		bool        used;
+	};
+
+	void unmap ();
+
+	std::string                  _path;
+	GMappedFile*                 _map;
+	std::map<std::string, Entry> _entries;
+	bool                         _dirty;
+	size_t                       _n_parsed;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_plugin_index_h__ */
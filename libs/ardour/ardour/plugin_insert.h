@@ -27,6 +27,7 @@
 #include <vector>
 #include <string>
 
+#include <boost/function.hpp>
 #include <boost/weak_ptr.hpp>
 #include <boost/enable_shared_from_this.hpp>
 
@@ -55,6 +56,7 @@ namespace ARDOUR {
 class Session;
 class Route;
 class Plugin;
+class RTSubTasks;
 
 /** Plugin inserts: send data through a plugin
  */
@@ -414,7 +416,11 @@ private:
 
 	void automate_and_run (BufferSet& bufs, samplepos_t start, samplepos_t end, double speed, pframes_t nframes);
 	void connect_and_run (BufferSet& bufs, samplepos_t start, samplecnt_t end, double speed, pframes_t nframes, samplecnt_t offset, bool with_auto);
+	void run_instance (size_t);
 	void bypass (BufferSet& bufs, pframes_t nframes);
+	bool can_sleep () const;
+	bool sleeping (BufferSet& bufs, samplepos_t start, pframes_t nframes);
+	void check_sleep (BufferSet& bufs, pframes_t nframes);
 	void inplace_silence_unconnected (BufferSet&, const PinMappings&, samplecnt_t nframes, samplecnt_t offset) const;
 
 	void create_automatable_parameters ();
@@ -427,6 +433,7 @@ private:
 
 	bool sanitize_maps ();
 	bool check_inplace ();
+	bool check_parallel_instances () const;
 	void mapping_changed ();
 
 	boost::shared_ptr<Plugin> plugin_factory (boost::shared_ptr<Plugin>);
@@ -449,6 +456,30 @@ private:
 	PBD::TimingStats  _timing_stats;
 	GATOMIC_QUAL gint _stat_reset;
 	GATOMIC_QUAL gint _flush;
+
+	samplecnt_t       _silent_samples; ///< duration of silent input while awake
+	bool              _asleep;
+	GATOMIC_QUAL gint _wake;
+
+	/* replicated instances, processed in parallel */
+	struct InstanceArgs {
+		BufferSet*         bufs;
+		samplepos_t        start;
+		samplepos_t        end;
+		double             speed;
+		PinMappings const* in_map;
+		PinMappings const* out_map;
+		pframes_t          nframes;
+		samplecnt_t        offset;
+	};
+
+	boost::shared_ptr<RTSubTasks>  _subtasks;
+	boost::function<void (size_t)> _run_instance;
+	InstanceArgs                   _instance_args;
+	bool                           _parallel_instances; ///< instances do not share output buffers
+	bool                           _ran_parallel;       ///< instances were processed in parallel in the last cycle
+	PBD::microseconds_t            _run_cost;           ///< duration of the last cycle
+	GATOMIC_QUAL gint              _instance_failed;
 };
 
 } // namespace ARDOUR
@@ -51,6 +51,8 @@ namespace PBD {
 namespace ARDOUR {
 
 class Plugin;
+class PluginIndex;
+class PluginScanQueue;
 
 #ifdef VST3_SUPPORT
 struct VST3Info;
@@ -304,6 +306,15 @@ private:
 
 	bool no_timeout () const { return _cancel_scan_timeout_one || _cancel_scan_timeout_all; }
 
+	/* concurrent out-of-process scans, see plugin-scan-jobs */
+	boost::shared_ptr<PluginScanQueue> _scan_queue;
+
+	size_t scanner_jobs () const;
+	int    scanner_timeout () const;
+	void   run_scan_queue (std::string const& type_name);
+	bool   scan_queued (std::string const& path) const;
+	bool   scan_queue_result (std::string const& path, PSLEPtr) const;
+
 	void detect_name_ambiguities (ARDOUR::PluginInfoList*);
 	void detect_type_ambiguities (ARDOUR::PluginInfoList&);
 
@@ -318,6 +329,9 @@ private:
 	void load_scanlog ();
 	void save_scanlog ();
 
+	/* parsed content of all plugin cache files */
+	PluginIndex* _plugin_index;
+
 	std::string sanitize_tag (const std::string) const;
 
 	void ladspa_refresh ();
@@ -347,6 +361,7 @@ private:
 #if (defined WINDOWS_VST_SUPPORT || defined MACVST_SUPPORT || defined LXVST_SUPPORT)
 	bool vst2_plugin (std::string const& module_path, ARDOUR::PluginType, VST2Info const&);
 	bool run_vst2_scanner_app (std::string bundle_path, PSLEPtr) const;
+	void vst2_prescan (std::vector<std::string> const&, bool cache_only);
 	int vst2_discover (std::string path, ARDOUR::PluginType, bool cache_only = false);
 #endif
 
@@ -355,6 +370,7 @@ private:
 #ifdef VST3_SUPPORT
 	void vst3_plugin (std::string const&, std::string const&, VST3Info const&);
 	bool run_vst3_scanner_app (std::string bundle_path, PSLEPtr) const;
+	void vst3_prescan (std::vector<std::string> const&, bool cache_only);
 #endif
 
 	int ladspa_discover (std::string path);
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_plugin_scan_queue_h__
+#define __ardour_plugin_scan_queue_h__
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <glibmm/threads.h>
+
+#include "pbd/signals.h"
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR {
+
+class SystemExec;
+
+/** Run out-of-process plugin scanners concurrently.
+ *
+ * Every job runs one scanner process for a single plugin, at most
+ * max_jobs of them at the same time. A job that crashes, hangs or cannot
+ * be started does not affect any other job.
+ *
+ * The queue does not block: the caller drives it by calling process()
+ * every 100ms (one timeout tick), and handles user-interaction in between.
+ */
+class LIBARDOUR_API PluginScanQueue
+{
+public:
+	enum Result {
+		Pending,
+		Running,
+		Done,
+		Failed,
+		TimedOut,
+		Cancelled
+	};
+
+	/** @param max_jobs number of scanners to run concurrently (at least 1)
+	 * @param timeout per job timeout in deciseconds, <= 0 for no timeout
+	 */
+	PluginScanQueue (size_t max_jobs, int timeout);
+	~PluginScanQueue ();
+
+	/** Queue a scan, @p path identifies the job */
+	void add (std::string const& path, std::string const& command, std::vector<std::string> const& args);
+
+	/** Reap finished jobs, count down timeouts and start pending jobs.
+	 * @return true while jobs are pending or running
+	 */
+	bool process ();
+
+	/** Change the timeout, running jobs start over when the timeout is enabled */
+	void set_timeout (int timeout);
+	/** Do not time out jobs that are currently running */
+	void skip_timeout_running ();
+
+	/** Terminate running jobs, and continue with pending ones */
+	void cancel_running ();
+	/** Terminate running jobs, and drop all pending ones. Jobs that were
+	 * not started remain Pending.
+	 */
+	void cancel_all ();
+
+	/** @return the smallest remaining timeout of all running jobs, or
+	 * negative time since the oldest job was started if none can time out.
+	 */
+	int remaining_timeout () const;
+
+	size_t n_jobs () const { return _jobs.size (); }
+	size_t n_done () const { return _n_done; }
+	size_t n_running () const { return _running.size (); }
+	/** @return the largest number of jobs that were ever running at the same time */
+	size_t max_concurrency () const { return _max_concurrency; }
+	/** @return path of the job that was started last */
+	std::string const& last_started () const { return _last_started; }
+
+	Result result (std::string const& path) const;
+	/** @return output of the scanner, or an error message if it could not be started */
+	std::string log (std::string const& path) const;
+
+	std::vector<std::string> paths () const;
+
+	/** Emitted with the job's path, right before its scanner is launched */
+	PBD::Signal1<void, std::string> JobStarted;
+
+private:
+	struct Job {
+		Job (std::string const& p, std::string const& c, std::vector<std::string> const& a)
+			: path (p), command (c), args (a), result (Pending), timeout (0), notime (false) {}
+
+		std::string const              path;
+		std::string const              command;
+		std::vector<std::string> const args;
+
+		Result      result;
+		std::string log;
+		int         timeout;
+		bool        notime;
+
+		boost::shared_ptr<SystemExec> exec;
+		PBD::ScopedConnection         output_connection;
+	};
+
+	typedef boost::shared_ptr<Job> JobPtr;
+
+	void start (JobPtr);
+	void finish (JobPtr, Result);
+	void job_output (std::string, Job*);
+
+	std::map<std::string, JobPtr> _jobs;
+	std::list<JobPtr>             _pending;
+	std::list<JobPtr>             _running;
+
+	size_t      _max_jobs;
+	int         _timeout;
+	size_t      _n_done;
+	size_t      _max_concurrency;
+	std::string _last_started;
+
+	mutable Glib::Threads::Mutex _log_lock;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_plugin_scan_queue_h__ */
@@ -40,6 +40,10 @@ public:
 		return _control;
 	}
 
+	/* used by a route to apply consecutive gain stages in a single pass */
+	bool fuse (uint32_t n_audio);
+	gain_t fused_gain (uint32_t chn) const { return _current_gain[chn]; }
+
 protected:
 	XMLNode& state () const;
 
@@ -31,6 +31,7 @@
 #include <set>
 #include <string>
 
+#include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
 
@@ -96,6 +97,8 @@ class SoloIsolateControl;
 class PhaseControl;
 class MonitorControl;
 class TriggerBox;
+class PipelineStage;
+class RTSubTasks;
 
 class LIBARDOUR_API Route : public Stripable,
                             public GraphNode,
@@ -215,6 +218,13 @@ public:
 	boost::shared_ptr<Amp> amp() const  { return _amp; }
 	boost::shared_ptr<Amp> trim() const { return _trim; }
 	boost::shared_ptr<PolarityProcessor> polarity() const { return _polarity; }
+
+	/** Apply the gain of consecutive polarity and gain stages, in processing
+	 *  order, in a single pass over the buffers.
+	 *  @param curve space for @p nframes gain coefficients
+	 *  @return false if the stages have to be run one by one this cycle
+	 */
+	static bool apply_fused_gain_stages (BufferSet&, std::vector<boost::shared_ptr<Processor> > const&, gain_t* curve, pframes_t nframes);
 	boost::shared_ptr<PeakMeter>       peak_meter()       { return _meter; }
 	boost::shared_ptr<const PeakMeter> peak_meter() const { return _meter; }
 	boost::shared_ptr<PeakMeter> shared_peak_meter() const { return _meter; }
@@ -320,6 +330,12 @@ public:
 
 	bool strict_io () const { return _strict_io; }
 	bool set_strict_io (bool);
+
+	/** A pipelined route splits its plugins into two stages that are
+	 * processed concurrently, at the cost of one cycle of latency.
+	 */
+	bool pipelined () const { return _pipelined; }
+	void set_pipelined (bool);
 	/** reset plugin-insert configuration to default, disable customizations.
 	 *
 	 * This is equivalent to calling
@@ -707,6 +723,7 @@ protected:
 	bool _volume_applies_to_output;
 
 	boost::shared_ptr<DelayLine> _delayline;
+	boost::shared_ptr<PipelineStage> _pipeline;
 
 	bool is_internal_processor (boost::shared_ptr<Processor>) const;
 
@@ -757,6 +774,21 @@ private:
 	pframes_t latency_preroll (pframes_t nframes, samplepos_t& start_sample, samplepos_t& end_sample);
 
 	void run_route (samplepos_t start_sample, samplepos_t end_sample, pframes_t nframes, bool gain_automation_ok, bool run_disk_reader);
+
+	struct ProcessArgs {
+		BufferSet*   bufs;
+		samplepos_t  start_sample;
+		samplepos_t  end_sample;
+		double       speed;
+		pframes_t    nframes;
+		MonitorState ms;
+		bool         run_disk_reader;
+		bool         run_disk_writer;
+	};
+
+	void run_processors (ProcessArgs const&, ProcessorList::const_iterator, ProcessorList::const_iterator, samplecnt_t latency);
+	void run_pipeline_stage (size_t);
+	bool run_fused_gain_stages (BufferSet&, ProcessorList::const_iterator&, ProcessorList::const_iterator, pframes_t);
 	void fill_buffers_with_input (BufferSet& bufs, boost::shared_ptr<IO> io, pframes_t nframes);
 
 	void reset_instrument_info ();
@@ -796,6 +828,7 @@ private:
 
 	int64_t _track_number;
 	bool    _strict_io;
+	bool    _pipelined;
 	bool    _in_configure_processors;
 	bool    _initial_io_setup;
 	bool    _in_sidechain_setup;
@@ -810,6 +843,17 @@ private:
 
 	RoutePinWindowProxy*   _pinmgr_proxy;
 	PatchChangeGridDialog* _patch_selector_dialog;
+
+	/* pipelined processing, see run_pipeline_stage() */
+	boost::shared_ptr<RTSubTasks>   _pipeline_tasks;
+	boost::function<void (size_t)>  _run_pipeline_stage;
+	ProcessArgs                     _pipeline_args;
+	ProcessorList::const_iterator   _pipeline_pos;
+	samplecnt_t                     _pipeline_latency;
+	BufferSet                       _pipeline_bufs;
+
+	/* consecutive polarity, trim and fader, see run_fused_gain_stages() */
+	std::vector<boost::shared_ptr<Processor> > _fused_gain_stages;
 };
 
 } // namespace ARDOUR
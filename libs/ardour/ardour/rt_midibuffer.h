@@ -63,6 +63,13 @@ class LIBARDOUR_API RTMidiBuffer : public Evoral::EventSink<samplepos_t>
 	uint32_t write (TimeType time, Evoral::EventType type, uint32_t size, const uint8_t* buf);
 	uint32_t read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiNoteTracker& tracker, samplecnt_t offset = 0);
 
+	/* Replace all events with timestamps in the closed range [start, end]
+	 * with the contents of @p src (which must only contain events within
+	 * that range). The caller must hold the write lock (see
+	 * WriteProtectRender) and the buffer must not be reversed.
+	 */
+	void splice (TimeType start, TimeType end, RTMidiBuffer const & src);
+
 	void dump (uint32_t);
 	void reverse ();
 	bool reversed() const;
@@ -119,7 +126,9 @@ class LIBARDOUR_API RTMidiBuffer : public Evoral::EventSink<samplepos_t>
 
 	uint32_t alloc_blob (uint32_t size);
 	uint32_t store_blob (uint32_t size, uint8_t const * data);
+	void     compact_pool ();
 	uint32_t _pool_size;
+	uint32_t _pool_garbage;
 	uint32_t _pool_capacity;
 	uint8_t* _pool;
 
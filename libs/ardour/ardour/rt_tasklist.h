@@ -22,6 +22,8 @@
 #include <boost/function.hpp>
 #include <vector>
 
+#include "pbd/g_atomic_compat.h"
+
 #include "ardour/libardour_visibility.h"
 #include "ardour/rt_task.h"
 
@@ -45,5 +47,48 @@ private:
 	boost::shared_ptr<Graph> _graph;
 };
 
+/** Split the work of a graph-node (e.g. a route), into sub-tasks that are
+ * processed concurrently by idle process threads.
+ *
+ * Unlike RTTaskList this can be used while the graph is running. The
+ * calling thread takes part, and processes queued sub-tasks (but not
+ * routes) while waiting for its own sub-tasks to complete.
+ */
+class LIBARDOUR_API RTSubTasks
+{
+public:
+	RTSubTasks (boost::shared_ptr<Graph>);
+
+	/** Call @p f for 0 .. @p n - 1, return when all calls have completed.
+	 * Calls are not ordered. Must be called from a process thread.
+	 * @p f must remain valid until this returns.
+	 */
+	void process (size_t n, boost::function<void (size_t)> const& f);
+
+	/** @return true if there are idle process threads to share the work */
+	bool can_process () const;
+
+private:
+	class Helper : public ProcessNode
+	{
+	public:
+		Helper (RTSubTasks* p) : _parent (p) {}
+		void prep (GraphChain const*) {}
+		void run (GraphChain const*);
+
+	private:
+		RTSubTasks* _parent;
+	};
+
+	void work ();
+
+	boost::shared_ptr<Graph>              _graph;
+	std::vector<Helper>                   _helpers;
+	boost::function<void (size_t)> const* _f;
+	size_t                                _n;
+	GATOMIC_QUAL gint                     _next;
+	GATOMIC_QUAL gint                     _pending;
+};
+
 } // namespace ARDOUR
 #endif
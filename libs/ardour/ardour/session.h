@@ -107,6 +107,7 @@ class Parser;
 
 namespace PBD {
 class Controllable;
+class Thread;
 }
 
 namespace luabridge {
@@ -173,6 +174,7 @@ class SceneChanger;
 class SessionDirectory;
 class SessionMetadata;
 class SessionPlaylists;
+class StateJournal;
 class SoloMuteRelease;
 class Source;
 class Speakers;
@@ -327,6 +329,7 @@ public:
 	}
 
 	boost::shared_ptr<RTTaskList> rt_tasklist () { return _rt_tasklist; }
+	boost::shared_ptr<Graph> process_graph () { return _process_graph; }
 
 	RouteList get_routelist (bool mixer_order = false, PresentationInfo::Flag fl = PresentationInfo::MixerRoutes) const;
 
@@ -747,7 +750,11 @@ public:
 	void remove_routes (boost::shared_ptr<RouteList>);
 	void remove_route (boost::shared_ptr<Route>);
 
-	void resort_routes ();
+	/** Sort routes and rebuild the process graph.
+	 *  @param incremental only re-evaluate connections of routes whose ports
+	 *  were (dis)connected since the last sort, if possible.
+	 */
+	void resort_routes (bool incremental = false);
 
 	AudioEngine & engine() { return _engine; }
 	AudioEngine const & engine () const { return _engine; }
@@ -1388,7 +1395,7 @@ protected:
 	void set_sample_rate (samplecnt_t nframes);
 
 	friend class Route;
-	void update_latency_compensation (bool force, bool called_from_backend);
+	void update_latency_compensation (bool force, bool called_from_backend, bool incremental = false);
 
 	/* transport API */
 
@@ -1476,7 +1483,9 @@ private:
 
 	void update_latency (bool playback);
 	void set_owned_port_public_latency (bool playback);
-	bool update_route_latency (bool reverse, bool apply_to_delayline, bool* delayline_update_needed);
+	bool update_route_latency (bool reverse, bool apply_to_delayline, RouteList* delayline_update_needed, boost::shared_ptr<RouteList> subgraph = boost::shared_ptr<RouteList> ());
+	boost::shared_ptr<RouteList> take_latency_dirty_routes (bool incremental);
+	boost::shared_ptr<RouteList> downstream_routes (RouteList const&);
 	void initialize_latencies ();
 	void set_worst_output_latency ();
 	void set_worst_input_latency ();
@@ -1606,6 +1615,14 @@ private:
 
 	Glib::Threads::Mutex save_state_lock;
 	Glib::Threads::Mutex save_source_lock;
+	Glib::Threads::Mutex save_thread_lock;
+
+	/* pending (auto-)saves are written to disk by this thread */
+	PBD::Thread* _save_thread;
+	void wait_for_background_save ();
+
+	/* changes since the last full pending save */
+	StateJournal* _state_journal;
 	Glib::Threads::Mutex peak_cleanup_lock;
 
 	int        load_options (const XMLNode&);
@@ -1768,12 +1785,23 @@ private:
 	AutoConnectQueue     _auto_connect_queue;
 	GATOMIC_QUAL guint   _latency_recompute_pending;
 
+	/* Routes whose processor latency changed since the last
+	 * latency recompute. Unless the whole graph is dirty, only
+	 * these are updated, and the next capture latency callback
+	 * is limited to the routes they feed.
+	 */
+	Glib::Threads::Mutex                _latency_dirty_lock;
+	std::vector<boost::weak_ptr<Route> > _latency_dirty_routes;
+	bool                                _latency_dirty_all;
+	boost::shared_ptr<RouteList>        _latency_subgraph;
+
 	void get_physical_ports (std::vector<std::string>& inputs, std::vector<std::string>& outputs, DataType type,
 	                         MidiPortFlags include = MidiPortFlags (0),
 	                         MidiPortFlags exclude = MidiPortFlags (0));
 
 	void auto_connect (const AutoConnectRequest&);
 	void queue_latency_recompute ();
+	void queue_route_latency_recompute (boost::weak_ptr<Route>);
 
 	/* SessionEventManager interface */
 
@@ -2015,6 +2043,8 @@ private:
 
 	boost::shared_ptr<Source> XMLSourceFactory (const XMLNode&);
 
+	void add_history_commands (UndoTransaction&, XMLNode const&);
+
 	/* PLAYLISTS */
 
 	void remove_playlist (boost::weak_ptr<Playlist>);
@@ -2283,16 +2313,36 @@ private:
 	 * and solo/mute computations.
 	 */
 	GraphEdges _current_route_graph;
+	/** Protects _current_route_graph against concurrent re-sorting,
+	 * for readers outside of the thread that sorts the routes.
+	 */
+	mutable Glib::Threads::Mutex _route_graph_lock;
+
+	/* Ports that were (dis)connected since the routes were last sorted.
+	 * Unless the whole graph is dirty, an incremental resort only
+	 * re-evaluates the edges to and from the routes that own them.
+	 */
+	Glib::Threads::Mutex                _graph_dirty_lock;
+	std::vector<boost::weak_ptr<Port> > _graph_dirty_ports;
+	bool                                _graph_dirty_all;
+	/** The route list that _current_route_graph was made for */
+	boost::weak_ptr<RouteList>          _sorted_routes;
+
+	void port_connected_or_disconnected (boost::weak_ptr<Port>, boost::weak_ptr<Port>);
+	void set_graph_dirty ();
+	bool take_graph_dirty_routes (boost::shared_ptr<RouteList>, std::set<GraphVertex>&, bool incremental);
 
 	friend class IOPlug;
 	boost::shared_ptr<Graph>      _process_graph;
 	boost::shared_ptr<GraphChain> _graph_chain;
 	boost::shared_ptr<GraphChain> _io_graph_chain[2];
 
-	void resort_routes_using (boost::shared_ptr<RouteList>);
+	void resort_routes_using (boost::shared_ptr<RouteList>, bool incremental = false);
 	void resort_io_plugs ();
 
 	bool rechain_process_graph (GraphNodeList&);
+	bool rechain_process_graph (GraphNodeList&, std::set<GraphVertex> const& changed);
+	void set_process_graph (GraphNodeList const&, GraphEdges const&);
 	bool rechain_ioplug_graph (bool);
 
 	void ensure_route_presentation_info_gap (PresentationInfo::order_t, uint32_t gap_size);
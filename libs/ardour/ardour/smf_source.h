@@ -111,6 +111,7 @@ public:
 	                          timecnt_t const &            cnt);
 
 	void load_model_unlocked (bool force_reload=false);
+	bool load_model_from_file ();
 
 };
 
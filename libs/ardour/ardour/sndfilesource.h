@@ -27,6 +27,8 @@
 
 #include <sndfile.h>
 
+#include "pbd/g_atomic_compat.h"
+
 #include "ardour/audiofilesource.h"
 #include "ardour/broadcast_info.h"
 #include "ardour/progress.h"
@@ -60,6 +62,8 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 
 	~SndFileSource ();
 
+	XMLNode& get_state () const;
+
 	float sample_rate () const;
 	int update_header (samplepos_t when, struct tm&, time_t);
 	int flush_header ();
@@ -91,6 +95,16 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 
 	void init_sndfile ();
 	int open();
+	bool use_cached_file_info (const XMLNode&);
+
+	/* read-only files are opened on demand, and the least recently used
+	 * ones are closed again when there are more than
+	 * Config->get_max_open_audio_files() open.
+	 */
+	mutable GATOMIC_QUAL gint _last_used;
+	void mark_used () const;
+	static void add_open_file (SndFileSource*);
+	static void remove_open_file (SndFileSource*);
 	int setup_broadcast_info (samplepos_t when, struct tm&, time_t);
 	void file_closed ();
 
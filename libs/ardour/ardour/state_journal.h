@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_state_journal_h__
+#define __ardour_state_journal_h__
+
+#include <string>
+
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include "ardour/libardour_visibility.h"
+
+class XMLNode;
+class XMLTree;
+
+namespace ARDOUR {
+
+/** Journal of changes to a session state tree.
+ *
+ * A journaled state consists of a base snapshot, written in full, and an
+ * append-only log of changes relative to it. Every record in the log holds
+ * the complete state of each top-level node, or of each direct child of a
+ * section whose children all have IDs (Routes, Playlists, Sources, ...),
+ * that changed since the previous record. Deleted children are recorded by
+ * ID.
+ *
+ * The base is stamped with a generation number. Records of a different
+ * generation are ignored when the journal is applied, so a stale log left
+ * behind by an interrupted compaction can never be applied to a newer base.
+ */
+class LIBARDOUR_API StateJournal
+{
+public:
+	StateJournal ();
+
+	/** Forget the base, the next save needs to be a full one */
+	void reset ();
+
+	/** Use @p tree as base for future records, and stamp it with a new
+	 * generation. @p tree must be written in full by the caller, who
+	 * needs to reset() the journal if that fails.
+	 */
+	void set_base (boost::shared_ptr<XMLTree> tree);
+
+	/** Append the difference between the current base and @p tree to the
+	 * journal at @p path. On success, @p tree becomes the new base.
+	 *
+	 * @return 0 on success (including when nothing changed), 1 if a full
+	 * save is needed instead (no base, the layout of the tree changed, or
+	 * the journal is due for compaction), -1 on error.
+	 */
+	int append (boost::shared_ptr<XMLTree> tree, std::string const& path);
+
+	size_t n_records () const { return _records; }
+
+	/** Apply the records of the journal at @p path to @p root, which must
+	 * be the base it was written for.
+	 * @return the number of records applied, or -1 on error
+	 */
+	static int apply (XMLNode& root, std::string const& path);
+
+	static const size_t max_records = 64;
+	static const size_t max_size    = 4 * 1024 * 1024;
+
+private:
+	boost::shared_ptr<XMLTree> _base;
+	uint32_t                   _generation;
+	size_t                     _records;
+	size_t                     _size;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_state_journal_h__ */
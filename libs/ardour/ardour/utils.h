@@ -32,6 +32,7 @@
 #include <string>
 #include <cmath>
 
+#include "boost/function.hpp"
 #include "boost/shared_ptr.hpp"
 
 #if __APPLE__
@@ -110,6 +111,13 @@ LIBARDOUR_API bool matching_unsuffixed_filename_exists_in (const std::string& di
 
 LIBARDOUR_API uint32_t how_many_dsp_threads ();
 
+/** Call @p f (n) for n = 0 .. @p count - 1, using up to @p max_threads
+ * threads (including the calling thread, 0: one per CPU), but no more than
+ * one thread per @p min_per_thread calls. Calls are not ordered.
+ * Returns when all calls have completed.
+ */
+LIBARDOUR_API void parallel_for (size_t count, boost::function<void (size_t)> const& f, uint32_t max_threads = 0, size_t min_per_thread = 1);
+
 LIBARDOUR_API std::string compute_sha1_of_file (std::string path);
 
 template<typename T> boost::shared_ptr<ControlList> route_list_to_control_list (boost::shared_ptr<RouteList> rl, boost::shared_ptr<T> (Stripable::*get_control)() const) {
@@ -160,6 +160,7 @@ public:
 
 	/* API for Ardour -- Setup/Processing */
 	uint32_t plugin_latency ();
+	uint32_t plugin_tailtime ();
 	bool     set_block_size (int32_t);
 	bool     activate ();
 	bool     deactivate ();
@@ -284,6 +285,7 @@ private:
 	bool                        _add_to_selection;
 
 	boost::optional<uint32_t> _plugin_latency;
+	boost::optional<uint32_t> _plugin_tailtime;
 
 	int _n_bus_in;
 	int _n_bus_out;
@@ -363,6 +365,8 @@ public:
 
 	int set_block_size (pframes_t);
 
+	samplecnt_t signal_tailtime () const;
+
 	void set_owner (ARDOUR::SessionObject* o);
 
 	void add_slave (boost::shared_ptr<Plugin>, bool);
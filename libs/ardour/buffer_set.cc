@@ -464,10 +464,16 @@ BufferSet::merge_from (const BufferSet& in, samplecnt_t nframes)
 	*/
 
 	for (DataType::iterator t = DataType::begin(); t != DataType::end(); ++t) {
-		BufferSet::iterator o = begin(*t);
-		for (BufferSet::const_iterator i = in.begin(*t); i != in.end(*t) && o != end (*t); ++i, ++o) {
-			o->merge_from (*i, nframes);
-		}
+		merge_from (in, nframes, *t);
+	}
+}
+
+void
+BufferSet::merge_from (const BufferSet& in, samplecnt_t nframes, DataType type)
+{
+	BufferSet::iterator o = begin(type);
+	for (BufferSet::const_iterator i = in.begin(type); i != in.end(type) && o != end (type); ++i, ++o) {
+		o->merge_from (*i, nframes);
 	}
 }
 
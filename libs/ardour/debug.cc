@@ -61,6 +61,7 @@ PBD::DebugBits PBD::DEBUG::LatencyIO = PBD::new_debug_bit ("latencyio");
 PBD::DebugBits PBD::DEBUG::LatencyRoute = PBD::new_debug_bit ("latencyroute");
 PBD::DebugBits PBD::DEBUG::LaunchControlXL = PBD::new_debug_bit("launchcontrolxl");
 PBD::DebugBits PBD::DEBUG::Layering = PBD::new_debug_bit ("layering");
+PBD::DebugBits PBD::DEBUG::LoadState = PBD::new_debug_bit ("loadstate");
 PBD::DebugBits PBD::DEBUG::MTC = PBD::new_debug_bit ("mtc");
 PBD::DebugBits PBD::DEBUG::MackieControl = PBD::new_debug_bit ("mackiecontrol");
 PBD::DebugBits PBD::DEBUG::MidiClock = PBD::new_debug_bit ("midiclock");
@@ -83,6 +84,7 @@ PBD::DebugBits PBD::DEBUG::ProcessThreads = PBD::new_debug_bit ("processthreads"
 PBD::DebugBits PBD::DEBUG::Processors = PBD::new_debug_bit ("processors");
 PBD::DebugBits PBD::DEBUG::Push2 = PBD::new_debug_bit ("push2");
 PBD::DebugBits PBD::DEBUG::MIDISurface = PBD::new_debug_bit ("midisurface");
+PBD::DebugBits PBD::DEBUG::SaveState = PBD::new_debug_bit ("savestate");
 PBD::DebugBits PBD::DEBUG::Selection = PBD::new_debug_bit ("selection");
 PBD::DebugBits PBD::DEBUG::SessionEvents = PBD::new_debug_bit ("sessionevents");
 PBD::DebugBits PBD::DEBUG::Slave = PBD::new_debug_bit ("slave");
@@ -770,7 +770,12 @@ DiskReader::overwrite_existing_midi ()
 		minsert.start ();
 #endif
 
-		midi_playlist ()->render (filter);
+		if (g_atomic_int_get (&_pending_overwrite) & PlaylistChanged) {
+			/* new playlist, nothing to reuse */
+			midi_playlist ()->render (filter);
+		} else {
+			midi_playlist ()->render_incremental (filter);
+		}
 		assert (midi_playlist ()->rendered ());
 
 #ifdef PROFILE_MIDI_IO
@@ -28,8 +28,10 @@
 #include <glibmm/timer.h>
 
 #include "pbd/uuid.h"
+#include "pbd/error.h"
 #include "pbd/file_utils.h"
 #include "pbd/cpus.h"
+#include "pbd/pthread_utils.h"
 
 #include "audiographer/process_context.h"
 #include "audiographer/general/chunker.h"
@@ -37,6 +39,7 @@
 #include "audiographer/general/demo_noise.h"
 #include "audiographer/general/interleaver.h"
 #include "audiographer/general/limiter.h"
+#include "audiographer/general/mapped_tmp_file.h"
 #include "audiographer/general/normalizer.h"
 #include "audiographer/general/analyser.h"
 #include "audiographer/general/peak_reader.h"
@@ -47,7 +50,6 @@
 #include "audiographer/general/threader.h"
 #include "audiographer/sndfile/tmp_file.h"
 #include "audiographer/sndfile/tmp_file_rt.h"
-#include "audiographer/sndfile/tmp_file_sync.h"
 #include "audiographer/sndfile/sndfile_writer.h"
 
 #include "ardour/audioengine.h"
@@ -58,11 +60,14 @@
 #include "ardour/export_graph_builder.h"
 #include "ardour/export_timespan.h"
 #include "ardour/filesystem_paths.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session_directory.h"
 #include "ardour/session_metadata.h"
 #include "ardour/sndfile_helpers.h"
 #include "ardour/system_exec.h"
 
+#include "pbd/i18n.h"
+
 using namespace AudioGrapher;
 using std::string;
 
@@ -71,23 +76,43 @@ namespace ARDOUR {
 ExportGraphBuilder::ExportGraphBuilder (Session const & session)
 	: session (session)
 	, thread_pool (hardware_concurrency())
+	, _pipelined (false)
+	, _encoder_running (false)
+	, _stem_pool (hardware_concurrency())
+	, _analysis_pool (hardware_concurrency())
+	, _encoder_sem ("export_encoder", 0)
+	, _encoder_space ("export_encoder_space", 0)
 {
 	process_buffer_samples = session.engine().samples_per_cycle();
+	g_atomic_int_set (&_encoder_quit, 0);
+	g_atomic_int_set (&_encoder_failed, 0);
 }
 
 ExportGraphBuilder::~ExportGraphBuilder ()
 {
+	stop_encoder ();
 }
 
 samplecnt_t
-ExportGraphBuilder::process (samplecnt_t samples, bool last_cycle)
+ExportGraphBuilder::process (samplepos_t pos, samplecnt_t samples, bool last_cycle)
 {
 	assert(samples <= process_buffer_samples);
 
-	sampleoffset_t off = 0;
+	if (g_atomic_int_get (&_encoder_failed)) {
+		stop_encoder ();
+		throw ExportFailed (_encoder_error);
+	}
+
+	ExportChannelPtr chan;
+	Buffer const*    buf = 0;
+	sampleoffset_t   off = 0;
+
 	for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it) {
-		Buffer const* buf;
-		it->first->read (buf, samples);
+		/* the map is sorted by channel, read each channel only once */
+		if (it->first.first != chan) {
+			chan = it->first.first;
+			chan->read (buf, samples);
+		}
 
 		if (session.remaining_latency_preroll () >= _master_align + samples) {
 			/* Skip processing during pre-roll, only read/write export ringbuffers */
@@ -100,22 +125,287 @@ ExportGraphBuilder::process (samplecnt_t samples, bool last_cycle)
 			assert (off < samples);
 		}
 
+		if (_pipelined && !_encoder_running) {
+			start_encoder ();
+		}
+
+		sampleoffset_t o;
+		samplecnt_t    n;
+		bool           last;
+
+		if (!it->second->overlap (pos, samples - off, o, n, last)) {
+			continue;
+		}
+
+		o += off;
+
 		AudioBuffer const* ab = dynamic_cast<AudioBuffer const*> (buf);
 		MidiBuffer const*  mb;
-		if (ab) {
+		if (ab && it->second->queue) {
+			/* the queue has room for all cycles the encoder may lag behind,
+			 * a short write would misalign all following cycles.
+			 */
+			if (it->second->queue->write (&ab->data ()[o], n) != (guint) n) {
+				assert (0);
+				throw ExportFailed ("Export encoder queue overflow.");
+			}
+		} else if (ab) {
 			Sample const* process_buffer = ab->data ();
-			ConstProcessContext<Sample> context(&process_buffer[off], samples - off, 1);
-			if (last_cycle) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
+			ConstProcessContext<Sample> context(&process_buffer[o], n, 1);
+			if (last) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
 			it->second->process (context);
 		}
 		if  ((mb = dynamic_cast<MidiBuffer const*> (buf))) {
-			it->second->process (*mb, off, samples - off, last_cycle);
+			it->second->process (*mb, o, n, last);
+		}
+	}
+
+	if (_encoder_running) {
+		EncoderCycle c = { pos, samples - off, last_cycle };
+		_encoder_cycles->write (&c, 1);
+		_encoder_sem.signal ();
+
+		if (last_cycle) {
+			/* post-processing and finish_timespan() need the complete graph */
+			stop_encoder ();
+			if (g_atomic_int_get (&_encoder_failed)) {
+				throw ExportFailed (_encoder_error);
+			}
+		} else {
+			/* wait for the encoder to catch up, so that the next cycle fits */
+			while (_encoder_cycles->write_space () == 0) {
+				_encoder_space.wait ();
+			}
 		}
 	}
 
 	return samples - off;
 }
 
+void
+ExportGraphBuilder::start_encoder ()
+{
+	/* number of cycles that can be queued */
+	const guint n_cycles = 32;
+
+	/* The cycle queue holds n_cycles - 1 cycles (a RingBuffer keeps one
+	 * slot empty), and the encoder may be busy with one more. The audio
+	 * queue needs room for all of those plus the cycle being written, and
+	 * also keeps one slot empty, so add a cycle to be on the safe side.
+	 */
+	for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it) {
+		if (it->first.first->audio ()) {
+			it->second->queue.reset (new PBD::RingBuffer<Sample> ((n_cycles + 1) * process_buffer_samples));
+		}
+	}
+
+	/* Group the audio channels into stems: channels that feed the same
+	 * channel configuration (directly or via another one) are encoded
+	 * by the same thread, since they share the graph.
+	 */
+	std::map<AnyExport*, StemPtr> stem_of;
+
+	_stems.clear ();
+
+	for (ChannelConfigList::const_iterator cc = channel_configs.begin(); cc != channel_configs.end(); ++cc) {
+		if (cc->inputs ().empty ()) {
+			continue;
+		}
+
+		StemPtr stem;
+
+		for (std::vector<AnyExportPtr>::const_iterator i = cc->inputs ().begin(); i != cc->inputs ().end(); ++i) {
+			std::map<AnyExport*, StemPtr>::iterator s = stem_of.find (i->get ());
+			if (s == stem_of.end () || s->second == stem) {
+				continue;
+			}
+			if (!stem) {
+				stem = s->second;
+				continue;
+			}
+			/* merge stems */
+			StemPtr other (s->second);
+			for (std::vector<AnyExportPtr>::const_iterator j = other->channels.begin(); j != other->channels.end(); ++j) {
+				stem->channels.push_back (*j);
+				stem_of[j->get ()] = stem;
+			}
+			stem->name += ", " + other->name;
+			_stems.remove (other);
+		}
+
+		if (!stem) {
+			std::string name = cc->name ();
+			if (timespans.size () > 1) {
+				name = cc->timespan ()->name () + ": " + name;
+			}
+			stem.reset (new Stem (*this, name, cc->timespan ()->get_length ()));
+			_stems.push_back (stem);
+		}
+
+		for (std::vector<AnyExportPtr>::const_iterator i = cc->inputs ().begin(); i != cc->inputs ().end(); ++i) {
+			if (stem_of.find (i->get ()) == stem_of.end ()) {
+				stem->channels.push_back (*i);
+				stem_of[i->get ()] = stem;
+			}
+		}
+	}
+
+	if (_stems.size () > 1) {
+		/* this runs in the encoder thread, and must not share the pool with
+		 * the per-format Threaders that are used by each stem. */
+		_stem_threader.reset (new Threader<Sample> (_stem_pool));
+		for (std::list<StemPtr>::const_iterator i = _stems.begin(); i != _stems.end(); ++i) {
+			_stem_threader->add_output (*i);
+		}
+	}
+
+	_encoder_cycles.reset (new PBD::RingBuffer<EncoderCycle> (n_cycles));
+	_encoder_sem.reset ();
+	_encoder_space.reset ();
+	g_atomic_int_set (&_encoder_quit, 0);
+	g_atomic_int_set (&_encoder_failed, 0);
+
+	if (pthread_create_and_store ("ExportEncoder", &_encoder_thread_id, _encoder_thread, this)) {
+		PBD::error << _("Cannot start export encoder thread, encoding in the process thread") << endmsg;
+		for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it) {
+			it->second->queue.reset ();
+		}
+		_encoder_cycles.reset ();
+		_stem_threader.reset ();
+		_stems.clear ();
+		_pipelined = false;
+		return;
+	}
+
+	_encoder_running = true;
+}
+
+void
+ExportGraphBuilder::stop_encoder ()
+{
+	if (!_encoder_running) {
+		return;
+	}
+
+	/* the encoder thread processes all queued cycles before it quits */
+	g_atomic_int_set (&_encoder_quit, 1);
+	_encoder_sem.signal ();
+	pthread_join (_encoder_thread_id, NULL);
+
+	_encoder_running = false;
+
+	for (ChannelMap::iterator it = channels.begin(); it != channels.end(); ++it) {
+		it->second->queue.reset ();
+	}
+	_encoder_cycles.reset ();
+	_stem_threader.reset ();
+}
+
+void*
+ExportGraphBuilder::_encoder_thread (void* arg)
+{
+	pthread_set_name ("ExportEncoder");
+	static_cast<ExportGraphBuilder*> (arg)->encoder_thread ();
+	return 0;
+}
+
+void
+ExportGraphBuilder::encoder_thread ()
+{
+	EncoderCycle c;
+
+	for (;;) {
+		_encoder_sem.wait ();
+
+		/* check before reading, all cycles were queued before quit was set */
+		const bool quit = g_atomic_int_get (&_encoder_quit);
+
+		while (_encoder_cycles->read (&c, 1) == 1) {
+			if (g_atomic_int_get (&_encoder_failed)) {
+				/* discard data, the export is aborted by the next process() call */
+				for (std::list<StemPtr>::const_iterator i = _stems.begin(); i != _stems.end(); ++i) {
+					(*i)->discard (c);
+				}
+			} else {
+				try {
+					encode (c);
+				} catch (std::exception& e) {
+					_encoder_error = e.what ();
+					g_atomic_int_set (&_encoder_failed, 1);
+				}
+			}
+			_encoder_space.signal ();
+		}
+
+		if (quit) {
+			break;
+		}
+	}
+}
+
+void
+ExportGraphBuilder::encode (EncoderCycle const& c)
+{
+	_encoder_cycle = c;
+
+	/* the stems use the current cycle, the context only triggers them */
+	Sample dummy = 0;
+	ConstProcessContext<Sample> context (&dummy, 0, 1);
+
+	if (_stem_threader) {
+		_stem_threader->process (context);
+	} else if (!_stems.empty ()) {
+		_stems.front ()->process (context);
+	}
+}
+
+/* Stem */
+
+ExportGraphBuilder::Stem::Stem (ExportGraphBuilder & parent, std::string const& name, samplecnt_t length)
+	: name (name)
+	, length (length)
+	, encoded (0)
+	, parent (parent)
+	, buffer (parent.process_buffer_samples)
+{
+}
+
+void
+ExportGraphBuilder::Stem::process (ProcessContext<Sample> const&)
+{
+	EncoderCycle const& c (parent._encoder_cycle);
+	samplecnt_t         cnt = 0;
+
+	for (std::vector<AnyExportPtr>::const_iterator i = channels.begin(); i != channels.end(); ++i) {
+		sampleoffset_t o;
+		samplecnt_t    n;
+		bool           last;
+		if (!(*i)->overlap (c.pos, c.samples, o, n, last)) {
+			continue;
+		}
+		(*i)->queue->read (&buffer[0], n);
+		ConstProcessContext<Sample> context (&buffer[0], n, 1);
+		if (last) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
+		(*i)->process (context);
+		cnt = n;
+	}
+
+	encoded = encoded + cnt;
+}
+
+void
+ExportGraphBuilder::Stem::discard (EncoderCycle const& c)
+{
+	for (std::vector<AnyExportPtr>::const_iterator i = channels.begin(); i != channels.end(); ++i) {
+		sampleoffset_t o;
+		samplecnt_t    n;
+		bool           last;
+		if ((*i)->overlap (c.pos, c.samples, o, n, last)) {
+			(*i)->queue->increment_read_idx (n);
+		}
+	}
+}
+
 bool
 ExportGraphBuilder::post_process ()
 {
@@ -143,9 +433,12 @@ ExportGraphBuilder::get_postprocessing_cycle_count() const
 void
 ExportGraphBuilder::reset ()
 {
+	stop_encoder ();
 	timespan.reset();
+	timespans.clear ();
 	channel_configs.clear ();
 	channels.clear ();
+	_stems.clear ();
 	intermediates.clear ();
 	analysis_map.clear();
 	_exported_files.clear();
@@ -156,6 +449,8 @@ ExportGraphBuilder::reset ()
 void
 ExportGraphBuilder::cleanup (bool remove_out_files/*=false*/)
 {
+	stop_encoder ();
+
 	ChannelConfigList::iterator iter = channel_configs.begin();
 
 	while (iter != channel_configs.end() ) {
@@ -168,6 +463,7 @@ void
 ExportGraphBuilder::set_current_timespan (boost::shared_ptr<ExportTimespan> span)
 {
 	timespan = span;
+	timespans.insert (span);
 }
 
 void
@@ -188,6 +484,7 @@ ExportGraphBuilder::add_config (FileSpec const & config, bool rt)
 	}
 
 	_realtime = rt;
+	_pipelined = !rt && Config->get_export_pipelined ();
 
 	/* If the sample rate is "session rate", change it to the real value.
 	 * However, we need to copy it to not change the config which is saved...
@@ -234,11 +531,34 @@ ExportGraphBuilder::get_analysis_results (AnalysisResults& results) {
 	}
 }
 
+void
+ExportGraphBuilder::get_stem_progress (ExportStatus::StemProgress& progress) const
+{
+	if (_stems.size () < 2) {
+		return;
+	}
+	for (std::list<StemPtr>::const_iterator i = _stems.begin(); i != _stems.end(); ++i) {
+		progress[(*i)->name] = (*i)->length > 0 ? (float) (*i)->encoded / (*i)->length : 1.f;
+	}
+}
+
+std::vector<std::string>
+ExportGraphBuilder::exported_files (boost::shared_ptr<ExportTimespan> span) const
+{
+	std::vector<std::string> rv;
+	for (std::vector<std::pair<boost::shared_ptr<ExportTimespan>, std::string> >::const_iterator i = _exported_files.begin(); i != _exported_files.end(); ++i) {
+		if (i->first == span) {
+			rv.push_back (i->second);
+		}
+	}
+	return rv;
+}
+
 void
 ExportGraphBuilder::add_split_config (FileSpec const & config)
 {
 	for (ChannelConfigList::iterator it = channel_configs.begin(); it != channel_configs.end(); ++it) {
-		if (*it == config) {
+		if (*it == config && it->timespan () == timespan) {
 			it->add_child (config);
 			return;
 		}
@@ -285,7 +605,8 @@ ExportGraphBuilder::Encoder::init (FileSpec const & new_config)
 void
 ExportGraphBuilder::Encoder::add_child (FileSpec const & new_config)
 {
-	filenames.push_back (new_config.filename);
+	/* filenames are shared by timespans, keep the current one */
+	filenames.push_back (ExportFilenamePtr (new ExportFilename (*new_config.filename)));
 }
 
 void
@@ -649,37 +970,45 @@ ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, Fil
 
 	config = new_config;
 	uint32_t const channels = config.channel_config->get_n_chans();
-	max_samples_out = 4086 - (4086 % channels); // TODO good chunk size
-
-	buffer.reset (new AllocatingProcessContext<Sample> (max_samples_out, channels));
 
 	peak_reader.reset (new PeakReader ());
 	loudness_reader.reset (new LoudnessReader (config.format->sample_rate(), channels, max_samples));
 	threader.reset (new Threader<Sample> (parent.thread_pool));
 
-	int format = ExportFormatBase::F_RAW | ExportFormatBase::SF_Float;
-
 	if (parent._realtime) {
+		max_samples_out = 4086 - (4086 % channels); // TODO good chunk size
+		buffer.reset (new AllocatingProcessContext<Sample> (max_samples_out, channels));
+
+		int format = ExportFormatBase::F_RAW | ExportFormatBase::SF_Float;
 		tmp_file.reset (new TmpFileRt<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
+
+		tmp_file->FileWritten.connect_same_thread (post_processing_connection,
+		                                           boost::bind (&Intermediate::prepare_post_processing, this));
+		tmp_file->FileFlushed.connect_same_thread (post_processing_connection,
+		                                           boost::bind (&Intermediate::start_post_processing, this));
+
+		peak_reader->add_output (loudness_reader);
+		loudness_reader->add_output (tmp_file);
 	} else {
-		tmp_file.reset (new TmpFileSync<float> (&tmpfile_path_buf[0], format, channels, config.format->sample_rate()));
-	}
+		/* the mapped file is read without copying, use large chunks */
+		max_samples_out = 65536 - (65536 % channels);
 
-	tmp_file->FileWritten.connect_same_thread (post_processing_connection,
-	                                           boost::bind (&Intermediate::prepare_post_processing, this));
-	tmp_file->FileFlushed.connect_same_thread (post_processing_connection,
-	                                           boost::bind (&Intermediate::start_post_processing, this));
+		mapped_file.reset (new MappedTmpFile<float> (&tmpfile_path_buf[0], channels));
 
-	add_child (new_config);
+		analysis_threader.reset (new Threader<Sample> (parent._analysis_pool));
+		analysis_threader->add_output (mapped_file);
+		first_pass.reset (new FirstPass (*this));
+	}
 
-	peak_reader->add_output (loudness_reader);
-	loudness_reader->add_output (tmp_file);
+	add_child (new_config);
 }
 
 ExportGraphBuilder::FloatSinkPtr
 ExportGraphBuilder::Intermediate::sink ()
 {
-	if (use_peak) {
+	if (first_pass) {
+		return first_pass;
+	} else if (use_peak) {
 		return peak_reader;
 	} else if (use_loudness) {
 		return loudness_reader;
@@ -691,6 +1020,15 @@ ExportGraphBuilder::Intermediate::sink ()
 void
 ExportGraphBuilder::Intermediate::add_child (FileSpec const & new_config)
 {
+	if (analysis_threader) {
+		if (new_config.format->normalize () && !use_peak) {
+			analysis_threader->add_output (peak_reader);
+		}
+		if (new_config.format->normalize_loudness () && !use_loudness) {
+			analysis_threader->add_output (loudness_reader);
+		}
+	}
+
 	use_peak     |= new_config.format->normalize ();
 	use_loudness |= new_config.format->normalize_loudness ();
 
@@ -725,17 +1063,38 @@ ExportGraphBuilder::Intermediate::operator== (FileSpec const & other_config) con
 unsigned
 ExportGraphBuilder::Intermediate::get_postprocessing_cycle_count() const
 {
-	return static_cast<unsigned>(std::ceil(static_cast<float>(tmp_file->get_samples_written()) /
+	return static_cast<unsigned>(std::ceil(static_cast<float>(samples_written ()) /
 	                                       max_samples_out));
 }
 
+samplecnt_t
+ExportGraphBuilder::Intermediate::samples_written () const
+{
+	return mapped_file ? mapped_file->get_samples_written () : tmp_file->get_samples_written ();
+}
+
 bool
 ExportGraphBuilder::Intermediate::process()
 {
+	if (mapped_file) {
+		return mapped_file->read (max_samples_out) != max_samples_out;
+	}
 	samplecnt_t samples_read = tmp_file->read (*buffer);
 	return samples_read != buffer->samples();
 }
 
+void
+ExportGraphBuilder::Intermediate::FirstPass::process (ProcessContext<Sample> const& c)
+{
+	/* returns once the file was written and all analysers are done */
+	parent.analysis_threader->process (c);
+
+	if (c.has_flag (ProcessContext<Sample>::EndOfInput)) {
+		parent.prepare_post_processing ();
+		parent.start_post_processing ();
+	}
+}
+
 void
 ExportGraphBuilder::Intermediate::prepare_post_processing()
 {
@@ -748,7 +1107,11 @@ ExportGraphBuilder::Intermediate::prepare_post_processing()
 		}
 	}
 
-	tmp_file->add_output (threader);
+	if (mapped_file) {
+		mapped_file->add_output (threader);
+	} else {
+		tmp_file->add_output (threader);
+	}
 	parent.intermediates.push_back (this);
 }
 
@@ -756,10 +1119,14 @@ void
 ExportGraphBuilder::Intermediate::start_post_processing()
 {
 	for (boost::ptr_list<SFC>::iterator i = children.begin(); i != children.end(); ++i) {
-		(*i).set_duration (tmp_file->get_samples_written() / config.channel_config->get_n_chans());
+		(*i).set_duration (samples_written () / config.channel_config->get_n_chans());
 	}
 
-	tmp_file->seek (0, SEEK_SET);
+	if (mapped_file) {
+		mapped_file->rewind ();
+	} else {
+		tmp_file->seek (0, SEEK_SET);
+	}
 
 	/* called in disk-thread when exporting in realtime,
 	 * to enable freewheeling for post-proc.
@@ -791,6 +1158,12 @@ ExportGraphBuilder::SRC::SRC (ExportGraphBuilder & parent, FileSpec const & new_
 	converter->init (parent.session.nominal_sample_rate(), format.sample_rate(), format.src_quality());
 	max_samples_out = converter->allocate_buffers (max_samples);
 
+	if (parent._pipelined) {
+		/* encode formats concurrently, this runs in the encoder thread */
+		threader.reset (new Threader<Sample> (parent.thread_pool));
+		converter->add_output (threader);
+	}
+
 	add_child (new_config);
 }
 
@@ -816,7 +1189,11 @@ ExportGraphBuilder::SRC::remove_children (bool remove_out_files)
 	boost::ptr_list<SFC>::iterator sfc_iter = children.begin();
 
 	while (sfc_iter != children.end() ) {
-		converter->remove_output (sfc_iter->sink() );
+		if (threader) {
+			threader->remove_output (sfc_iter->sink() );
+		} else {
+			converter->remove_output (sfc_iter->sink() );
+		}
 		sfc_iter->remove_children (remove_out_files);
 		sfc_iter = children.erase (sfc_iter);
 	}
@@ -824,7 +1201,11 @@ ExportGraphBuilder::SRC::remove_children (bool remove_out_files)
 	boost::ptr_list<Intermediate>::iterator norm_iter = intermediate_children.begin();
 
 	while (norm_iter != intermediate_children.end() ) {
-		converter->remove_output (norm_iter->sink() );
+		if (threader) {
+			threader->remove_output (norm_iter->sink() );
+		} else {
+			converter->remove_output (norm_iter->sink() );
+		}
 		norm_iter->remove_children (remove_out_files);
 		norm_iter = intermediate_children.erase (norm_iter);
 	}
@@ -843,7 +1224,11 @@ ExportGraphBuilder::SRC::add_child_to_list (FileSpec const & new_config, boost::
 	}
 
 	list.push_back (new T (parent, new_config, max_samples_out));
-	converter->add_output (list.back().sink ());
+	if (threader) {
+		threader->add_output (list.back().sink ());
+	} else {
+		converter->add_output (list.back().sink ());
+	}
 }
 
 bool
@@ -931,6 +1316,7 @@ ExportGraphBuilder::SilenceHandler::operator== (FileSpec const & other_config) c
 
 ExportGraphBuilder::ChannelConfig::ChannelConfig (ExportGraphBuilder & parent, FileSpec const & new_config, ChannelMap & channel_map)
 	: parent (parent)
+	, _timespan (parent.timespan)
 {
 	typedef ExportChannelConfiguration::ChannelList ChannelList;
 
@@ -953,10 +1339,12 @@ ExportGraphBuilder::ChannelConfig::ChannelConfig (ExportGraphBuilder & parent, F
 	unsigned chan = 0;
 	unsigned n_audio = 0;
 	for (ChannelList::const_iterator it = channel_list.begin(); it != channel_list.end(); ++it, ++chan) {
-		ChannelMap::iterator map_it = channel_map.find (*it);
+		ChannelMap::key_type key (*it, parent.timespan);
+		ChannelMap::iterator map_it = channel_map.find (key);
 		if (map_it == channel_map.end()) {
+			AnyExportPtr ae (new AnyExport (parent.timespan->get_start (), parent.timespan->get_end ()));
 			std::pair<ChannelMap::iterator, bool> result_pair =
-				channel_map.insert (std::make_pair (*it, AnyExportPtr (new AnyExport ())));
+				channel_map.insert (std::make_pair (key, ae));
 			assert (result_pair.second);
 			map_it = result_pair.first;
 		}
@@ -969,6 +1357,7 @@ ExportGraphBuilder::ChannelConfig::ChannelConfig (ExportGraphBuilder & parent, F
 		if ((*it)->audio ()) {
 			++n_audio;
 			map_it->second->add_output (interleaver->input (chan));
+			_inputs.push_back (map_it->second);
 		}
 	}
 
@@ -1015,4 +1404,13 @@ ExportGraphBuilder::ChannelConfig::operator== (FileSpec const & other_config) co
 	return config.channel_config == other_config.channel_config;
 }
 
+std::string
+ExportGraphBuilder::ChannelConfig::name () const
+{
+	if (!config.channel_config->name ().empty ()) {
+		return config.channel_config->name ();
+	}
+	return _timespan->name ();
+}
+
 } // namespace ARDOUR
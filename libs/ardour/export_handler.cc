@@ -22,6 +22,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+
 #include "pbd/gstdio_compat.h"
 #include <glibmm.h>
 #include <glibmm/convert.h>
@@ -39,6 +41,7 @@
 #include "ardour/export_status.h"
 #include "ardour/export_format_specification.h"
 #include "ardour/export_filename.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/soundcloud_upload.h"
 #include "ardour/system_exec.h"
 #include "pbd/openuri.h"
@@ -116,6 +119,7 @@ ExportHandler::ExportHandler (Session & session)
   , graph_builder (new ExportGraphBuilder (session))
   , export_status (session.get_export_status ())
   , post_processing (false)
+  , pass_end (0)
   , cue_tracknum (0)
   , cue_indexnum (0)
 {
@@ -185,38 +189,76 @@ ExportHandler::start_timespan ()
 		return -1;
 	}
 
-	export_status->timespan++;
-
 	/* finish_timespan pops the config_map entry that has been done, so
 	   this is the timespan to do this time
 	*/
 	current_timespan = config_map.begin()->first;
 
-	export_status->total_samples_current_timespan = current_timespan->get_length();
-	export_status->timespan_name = current_timespan->name();
+	/* Timespans that overlap are exported in a single pass */
+	pass_timespans.clear ();
+	pass_timespans.push_back (current_timespan);
+
+	samplepos_t pass_start = current_timespan->get_start ();
+	pass_end               = current_timespan->get_end ();
+
+	if (can_share_pass (current_timespan)) {
+		bool added;
+		do {
+			added = false;
+			for (ConfigMap::iterator it = config_map.begin(); it != config_map.end(); it = config_map.upper_bound (it->first)) {
+				ExportTimespanPtr ts = it->first;
+				if (std::find (pass_timespans.begin(), pass_timespans.end(), ts) != pass_timespans.end()) {
+					continue;
+				}
+				if (ts->get_start () >= pass_end || ts->get_end () <= pass_start || !can_share_pass (ts)) {
+					continue;
+				}
+				pass_timespans.push_back (ts);
+				pass_start = std::min (pass_start, ts->get_start ());
+				pass_end   = std::max (pass_end, ts->get_end ());
+				added      = true;
+			}
+		} while (added);
+	}
+
+	samplecnt_t pass_samples = 0;
+	std::string pass_name;
+	for (std::vector<ExportTimespanPtr>::const_iterator ts = pass_timespans.begin(); ts != pass_timespans.end(); ++ts) {
+		pass_samples += (*ts)->get_length ();
+		pass_name += (pass_name.empty () ? "" : ", ") + (*ts)->name ();
+	}
+
+	export_status->timespan += pass_timespans.size ();
+	/* overlapping parts are only processed once */
+	export_status->total_samples -= pass_samples - (pass_end - pass_start);
+	export_status->total_samples_current_timespan = pass_end - pass_start;
+	export_status->timespan_name = pass_name;
 	export_status->processed_samples_current_timespan = 0;
 
 	/* Register file configurations to graph builder */
 
-	/* Here's the config_map entries that use this timespan */
-	timespan_bounds = config_map.equal_range (current_timespan);
 	graph_builder->reset ();
-	graph_builder->set_current_timespan (current_timespan);
-	handle_duplicate_format_extensions();
 	bool realtime = current_timespan->realtime ();
 	bool region_export = true;
-	for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
-		// Filenames can be shared across timespans
-		FileSpec & spec = it->second;
-		spec.filename->set_timespan (it->first);
-		switch (spec.channel_config->region_processing_type ()) {
-			case RegionExportChannelFactory::None:
-				region_export = false;
-				break;
-			default:
-				break;
+
+	for (std::vector<ExportTimespanPtr>::const_iterator ts = pass_timespans.begin(); ts != pass_timespans.end(); ++ts) {
+		/* Here's the config_map entries that use this timespan */
+		timespan_bounds = config_map.equal_range (*ts);
+		graph_builder->set_current_timespan (*ts);
+		handle_duplicate_format_extensions();
+		for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
+			// Filenames can be shared across timespans
+			FileSpec & spec = it->second;
+			spec.filename->set_timespan (it->first);
+			switch (spec.channel_config->region_processing_type ()) {
+				case RegionExportChannelFactory::None:
+					region_export = false;
+					break;
+				default:
+					break;
+			}
+			graph_builder->add_config (spec, realtime);
 		}
-		graph_builder->add_config (spec, realtime);
 	}
 
 	// ExportDialog::update_realtime_selection does not allow this
@@ -226,11 +268,28 @@ ExportHandler::start_timespan ()
 
 	post_processing = false;
 	session.ProcessExport.connect_same_thread (process_connection, boost::bind (&ExportHandler::process, this, _1));
-	process_position = current_timespan->get_start();
+	process_position = pass_start;
 	// TODO check if it's a RegionExport.. set flag to skip  process_without_events()
 	return session.start_audio_export (process_position, realtime, region_export);
 }
 
+bool
+ExportHandler::can_share_pass (ExportTimespanPtr timespan) const
+{
+	if (!Config->get_export_single_pass () || timespan->realtime () || timespan->get_length () <= 0) {
+		return false;
+	}
+
+	/* region export reads the regions directly, starting at the timespan */
+	std::pair<ConfigMap::const_iterator, ConfigMap::const_iterator> bounds = config_map.equal_range (timespan);
+	for (ConfigMap::const_iterator it = bounds.first; it != bounds.second; ++it) {
+		if (it->second.channel_config->region_processing_type () != RegionExportChannelFactory::None) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void
 ExportHandler::handle_duplicate_format_extensions()
 {
@@ -293,7 +352,7 @@ ExportHandler::process_timespan (samplecnt_t samples)
 	/* update position */
 
 	samplecnt_t samples_to_read = 0;
-	samplepos_t const end = current_timespan->get_end();
+	samplepos_t const end = pass_end;
 
 	bool const last_cycle = (process_position + samples >= end);
 
@@ -305,11 +364,14 @@ ExportHandler::process_timespan (samplecnt_t samples)
 	}
 
 	/* Do actual processing */
-	samplecnt_t ret = graph_builder->process (samples_to_read, last_cycle);
+	samplecnt_t ret = graph_builder->process (process_position, samples_to_read, last_cycle);
 	if (ret > 0) {
 		process_position += ret;
 		export_status->processed_samples += ret;
 		export_status->processed_samples_current_timespan += ret;
+
+		Glib::Threads::Mutex::Lock sl (export_status->stem_lock ());
+		graph_builder->get_stem_progress (export_status->stem_progress);
 	}
 
 	/* Start post-processing/normalizing if necessary */
@@ -375,150 +437,160 @@ ExportHandler::finish_timespan ()
 	 * for a single config, config_map iterator below does not yet
 	 * take that into account.
 	 */
-	for (auto const& f : graph_builder->exported_files ()) {
-		Session::Exported (current_timespan->name(), f, config_map.begin()->second.format->reimport(), current_timespan->get_start ()); /* EMIT SIGNAL */
+	for (std::vector<ExportTimespanPtr>::const_iterator ts = pass_timespans.begin(); ts != pass_timespans.end(); ++ts) {
+		bool reimport = config_map.find (*ts)->second.format->reimport();
+		for (auto const& f : graph_builder->exported_files (*ts)) {
+			Session::Exported ((*ts)->name(), f, reimport, (*ts)->get_start ()); /* EMIT SIGNAL */
+		}
 	}
 
-	while (config_map.begin() != timespan_bounds.second) {
+	for (std::vector<ExportTimespanPtr>::const_iterator ts = pass_timespans.begin(); ts != pass_timespans.end(); ++ts) {
 
-		// XXX single timespan+format may produce multiple files
-		// e.g export selection == session
-		// -> TagLib::FileRef is null
+		current_timespan = *ts;
+		timespan_bounds  = config_map.equal_range (current_timespan);
 
-		FileSpec& config = config_map.begin()->second;
-		ExportFormatSpecPtr fmt = config.format;
-		config.filename->set_channel_config (config.channel_config);
-		std::string filename = config.filename->get_path (fmt);
+		while (timespan_bounds.first != timespan_bounds.second) {
 
-		if (fmt->type () == ExportFormatBase::T_None) {
-			graph_builder->reset ();
-			config_map.erase (config_map.begin());
-			continue;
-		}
+			// XXX single timespan+format may produce multiple files
+			// e.g export selection == session
+			// -> TagLib::FileRef is null
 
-		if (fmt->with_cue()) {
-			export_cd_marker_file (current_timespan, fmt, filename, CDMarkerCUE);
-		}
+			FileSpec& config = timespan_bounds.first->second;
+			ExportFormatSpecPtr fmt = config.format;
+			config.filename->set_timespan (current_timespan);
+			config.filename->set_channel_config (config.channel_config);
+			std::string filename = config.filename->get_path (fmt);
 
-		if (fmt->with_toc()) {
-			export_cd_marker_file (current_timespan, fmt, filename, CDMarkerTOC);
-		}
+			if (fmt->type () == ExportFormatBase::T_None) {
+				graph_builder->reset ();
+				config_map.erase (timespan_bounds.first++);
+				continue;
+			}
 
-		if (fmt->with_mp4chaps()) {
-			export_cd_marker_file (current_timespan, fmt, filename, MP4Chaps);
-		}
+			if (fmt->with_cue()) {
+				export_cd_marker_file (current_timespan, fmt, filename, CDMarkerCUE);
+			}
 
-		/* close file first, otherwise TagLib enounters an ERROR_SHARING_VIOLATION
-		 * The process cannot access the file because it is being used.
-		 * ditto for post-export and upload.
-		 */
-		graph_builder->reset ();
+			if (fmt->with_toc()) {
+				export_cd_marker_file (current_timespan, fmt, filename, CDMarkerTOC);
+			}
 
-		if (fmt->tag()) {
-			/* TODO: check Umlauts and encoding in filename.
-			 * TagLib eventually calls CreateFileA(),
+			if (fmt->with_mp4chaps()) {
+				export_cd_marker_file (current_timespan, fmt, filename, MP4Chaps);
+			}
+
+			/* close file first, otherwise TagLib enounters an ERROR_SHARING_VIOLATION
+			 * The process cannot access the file because it is being used.
+			 * ditto for post-export and upload.
 			 */
-			export_status->active_job = ExportStatus::Tagging;
-			AudiofileTagger::tag_file(filename, *SessionMetadata::Metadata());
-		}
+			graph_builder->reset ();
+
+			if (fmt->tag()) {
+				/* TODO: check Umlauts and encoding in filename.
+				 * TagLib eventually calls CreateFileA(),
+				 */
+				export_status->active_job = ExportStatus::Tagging;
+				AudiofileTagger::tag_file(filename, *SessionMetadata::Metadata());
+			}
 
-		if (!fmt->command().empty()) {
-			SessionMetadata const & metadata (*SessionMetadata::Metadata());
+			if (!fmt->command().empty()) {
+				SessionMetadata const & metadata (*SessionMetadata::Metadata());
 
 #if 0 // would be nicer with C++11 initialiser...
-			std::map<char, std::string> subs {
-				{ 'f', filename },
-				{ 'd', Glib::path_get_dirname(filename)  + G_DIR_SEPARATOR },
-				{ 'b', PBD::basename_nosuffix(filename) },
-				...
-			};
+				std::map<char, std::string> subs {
+					{ 'f', filename },
+					{ 'd', Glib::path_get_dirname(filename)  + G_DIR_SEPARATOR },
+					{ 'b', PBD::basename_nosuffix(filename) },
+					...
+				};
 #endif
-			export_status->active_job = ExportStatus::Command;
-			PBD::ScopedConnection command_connection;
-			std::map<char, std::string> subs;
-
-			std::stringstream track_number;
-			track_number << metadata.track_number ();
-			std::stringstream total_tracks;
-			total_tracks << metadata.total_tracks ();
-			std::stringstream year;
-			year << metadata.year ();
-
-			subs.insert (std::pair<char, std::string> ('a', metadata.artist ()));
-			subs.insert (std::pair<char, std::string> ('b', PBD::basename_nosuffix (filename)));
-			subs.insert (std::pair<char, std::string> ('c', metadata.copyright ()));
-			subs.insert (std::pair<char, std::string> ('d', Glib::path_get_dirname (filename) + G_DIR_SEPARATOR));
-			subs.insert (std::pair<char, std::string> ('f', filename));
-			subs.insert (std::pair<char, std::string> ('l', metadata.lyricist ()));
-			subs.insert (std::pair<char, std::string> ('n', session.name ()));
-			subs.insert (std::pair<char, std::string> ('s', session.path ()));
-			subs.insert (std::pair<char, std::string> ('o', metadata.conductor ()));
-			subs.insert (std::pair<char, std::string> ('t', metadata.title ()));
-			subs.insert (std::pair<char, std::string> ('z', metadata.organization ()));
-			subs.insert (std::pair<char, std::string> ('A', metadata.album ()));
-			subs.insert (std::pair<char, std::string> ('C', metadata.comment ()));
-			subs.insert (std::pair<char, std::string> ('E', metadata.engineer ()));
-			subs.insert (std::pair<char, std::string> ('G', metadata.genre ()));
-			subs.insert (std::pair<char, std::string> ('L', total_tracks.str ()));
-			subs.insert (std::pair<char, std::string> ('M', metadata.mixer ()));
-			subs.insert (std::pair<char, std::string> ('N', current_timespan->name())); // =?= config_map.begin()->first->name ()
-			subs.insert (std::pair<char, std::string> ('O', metadata.composer ()));
-			subs.insert (std::pair<char, std::string> ('P', metadata.producer ()));
-			subs.insert (std::pair<char, std::string> ('S', metadata.disc_subtitle ()));
-			subs.insert (std::pair<char, std::string> ('T', track_number.str ()));
-			subs.insert (std::pair<char, std::string> ('Y', year.str ()));
-			subs.insert (std::pair<char, std::string> ('Z', metadata.country ()));
-
-			ARDOUR::SystemExec *se = new ARDOUR::SystemExec(fmt->command(), subs, true);
-			info << "Post-export command line : {" << se->to_s () << "}" << endmsg;
-			se->ReadStdout.connect_same_thread(command_connection, boost::bind(&ExportHandler::command_output, this, _1, _2));
-			int ret = se->start (SystemExec::MergeWithStdin);
-			if (ret == 0) {
-				// successfully started
-				while (se->is_running ()) {
-					// wait for system exec to terminate
-					Glib::usleep (1000);
+				export_status->active_job = ExportStatus::Command;
+				PBD::ScopedConnection command_connection;
+				std::map<char, std::string> subs;
+
+				std::stringstream track_number;
+				track_number << metadata.track_number ();
+				std::stringstream total_tracks;
+				total_tracks << metadata.total_tracks ();
+				std::stringstream year;
+				year << metadata.year ();
+
+				subs.insert (std::pair<char, std::string> ('a', metadata.artist ()));
+				subs.insert (std::pair<char, std::string> ('b', PBD::basename_nosuffix (filename)));
+				subs.insert (std::pair<char, std::string> ('c', metadata.copyright ()));
+				subs.insert (std::pair<char, std::string> ('d', Glib::path_get_dirname (filename) + G_DIR_SEPARATOR));
+				subs.insert (std::pair<char, std::string> ('f', filename));
+				subs.insert (std::pair<char, std::string> ('l', metadata.lyricist ()));
+				subs.insert (std::pair<char, std::string> ('n', session.name ()));
+				subs.insert (std::pair<char, std::string> ('s', session.path ()));
+				subs.insert (std::pair<char, std::string> ('o', metadata.conductor ()));
+				subs.insert (std::pair<char, std::string> ('t', metadata.title ()));
+				subs.insert (std::pair<char, std::string> ('z', metadata.organization ()));
+				subs.insert (std::pair<char, std::string> ('A', metadata.album ()));
+				subs.insert (std::pair<char, std::string> ('C', metadata.comment ()));
+				subs.insert (std::pair<char, std::string> ('E', metadata.engineer ()));
+				subs.insert (std::pair<char, std::string> ('G', metadata.genre ()));
+				subs.insert (std::pair<char, std::string> ('L', total_tracks.str ()));
+				subs.insert (std::pair<char, std::string> ('M', metadata.mixer ()));
+				subs.insert (std::pair<char, std::string> ('N', current_timespan->name())); // =?= config_map.begin()->first->name ()
+				subs.insert (std::pair<char, std::string> ('O', metadata.composer ()));
+				subs.insert (std::pair<char, std::string> ('P', metadata.producer ()));
+				subs.insert (std::pair<char, std::string> ('S', metadata.disc_subtitle ()));
+				subs.insert (std::pair<char, std::string> ('T', track_number.str ()));
+				subs.insert (std::pair<char, std::string> ('Y', year.str ()));
+				subs.insert (std::pair<char, std::string> ('Z', metadata.country ()));
+
+				ARDOUR::SystemExec *se = new ARDOUR::SystemExec(fmt->command(), subs, true);
+				info << "Post-export command line : {" << se->to_s () << "}" << endmsg;
+				se->ReadStdout.connect_same_thread(command_connection, boost::bind(&ExportHandler::command_output, this, _1, _2));
+				int ret = se->start (SystemExec::MergeWithStdin);
+				if (ret == 0) {
+					// successfully started
+					while (se->is_running ()) {
+						// wait for system exec to terminate
+						Glib::usleep (1000);
+					}
+				} else {
+					error << "Post-export command FAILED with Error: " << ret << endmsg;
 				}
-			} else {
-				error << "Post-export command FAILED with Error: " << ret << endmsg;
+				delete (se);
 			}
-			delete (se);
-		}
 
-		// XXX THIS IS IN REALTIME CONTEXT, CALLED FROM
-		// AudioEngine::process_callback()
-		// freewheeling, yes, but still uploading here is NOT
-		// a good idea.
-		//
-		// even less so, since SoundcloudProgress is using
-		// connect_same_thread() - GUI updates from the RT thread
-		// will cause crashes. http://pastebin.com/UJKYNGHR
-		if (fmt->soundcloud_upload()) {
-			SoundcloudUploader *soundcloud_uploader = new SoundcloudUploader;
-			std::string token = soundcloud_uploader->Get_Auth_Token(soundcloud_username, soundcloud_password);
-			DEBUG_TRACE (DEBUG::Soundcloud, string_compose(
-						"uploading %1 - username=%2, password=%3, token=%4",
-						filename, soundcloud_username, soundcloud_password, token) );
-			std::string path = soundcloud_uploader->Upload (
-					filename,
-					PBD::basename_nosuffix(filename), // title
-					token,
-					soundcloud_make_public,
-					soundcloud_downloadable,
-					this);
-
-			if (path.length() != 0) {
-				info << string_compose ( _("File %1 uploaded to %2"), filename, path) << endmsg;
-				if (soundcloud_open_page) {
-					DEBUG_TRACE (DEBUG::Soundcloud, string_compose ("opening %1", path) );
-					open_uri(path.c_str());  // open the soundcloud website to the new file
+			// XXX THIS IS IN REALTIME CONTEXT, CALLED FROM
+			// AudioEngine::process_callback()
+			// freewheeling, yes, but still uploading here is NOT
+			// a good idea.
+			//
+			// even less so, since SoundcloudProgress is using
+			// connect_same_thread() - GUI updates from the RT thread
+			// will cause crashes. http://pastebin.com/UJKYNGHR
+			if (fmt->soundcloud_upload()) {
+				SoundcloudUploader *soundcloud_uploader = new SoundcloudUploader;
+				std::string token = soundcloud_uploader->Get_Auth_Token(soundcloud_username, soundcloud_password);
+				DEBUG_TRACE (DEBUG::Soundcloud, string_compose(
+							"uploading %1 - username=%2, password=%3, token=%4",
+							filename, soundcloud_username, soundcloud_password, token) );
+				std::string path = soundcloud_uploader->Upload (
+						filename,
+						PBD::basename_nosuffix(filename), // title
+						token,
+						soundcloud_make_public,
+						soundcloud_downloadable,
+						this);
+
+				if (path.length() != 0) {
+					info << string_compose ( _("File %1 uploaded to %2"), filename, path) << endmsg;
+					if (soundcloud_open_page) {
+						DEBUG_TRACE (DEBUG::Soundcloud, string_compose ("opening %1", path) );
+						open_uri(path.c_str());  // open the soundcloud website to the new file
+					}
+				} else {
+					error << _("upload to Soundcloud failed. Perhaps your email or password are incorrect?\n") << endmsg;
 				}
-			} else {
-				error << _("upload to Soundcloud failed. Perhaps your email or password are incorrect?\n") << endmsg;
+				delete soundcloud_uploader;
 			}
-			delete soundcloud_uploader;
+			config_map.erase (timespan_bounds.first++);
 		}
-		config_map.erase (config_map.begin());
 	}
 
 	/* finish timespan is called in freewheeling rt-context,
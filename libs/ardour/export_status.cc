@@ -52,6 +52,9 @@ ExportStatus::init ()
 	total_postprocessing_cycles = 0;
 	current_postprocessing_cycle = 0;
 	result_map.clear();
+
+	Glib::Threads::Mutex::Lock sl (_stem_lock);
+	stem_progress.clear ();
 }
 
 void
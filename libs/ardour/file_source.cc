@@ -58,6 +58,14 @@ using namespace Glib;
 
 PBD::Signal2<int,std::string,std::vector<std::string> > FileSource::AmbiguousFileName;
 
+static Glib::Threads::Private<bool> _quiet_find;
+
+void
+FileSource::set_quiet_find_in_this_thread (bool yn)
+{
+	_quiet_find.set (new bool (yn));
+}
+
 FileSource::FileSource (Session& session, DataType type, const string& path, const string& origin, Source::Flag flag)
 	: Source(session, type, path, flag)
 	, _path (path)
@@ -292,6 +300,11 @@ FileSource::find (Session& s, DataType type, const string& path, bool must_exist
 
 			/* more than one match: ask the user */
 
+			bool* quiet = _quiet_find.get ();
+			if (quiet && *quiet) {
+				goto out;
+			}
+
                         int which = FileSource::AmbiguousFileName (path, de_duped_hits).value_or (-1);
 
                         if (which < 0) {
@@ -78,6 +78,7 @@ Graph::Graph (Session& session)
 
 	/* pre-allocate memory */
 	_trigger_queue.reserve (1024);
+	_subtask_queue.reserve (1024);
 
 	ARDOUR::AudioEngine::instance ()->Running.connect_same_thread (engine_connections, boost::bind (&Graph::reset_thread_list, this));
 	ARDOUR::AudioEngine::instance ()->Stopped.connect_same_thread (engine_connections, boost::bind (&Graph::engine_stopped, this));
@@ -155,6 +156,7 @@ Graph::session_going_away ()
 	/* now drop all references on the nodes. */
 	g_atomic_int_set (&_trigger_queue_size, 0);
 	_trigger_queue.clear ();
+	_subtask_queue.clear ();
 	_graph_chain = 0;
 }
 
@@ -224,8 +226,7 @@ Graph::prep ()
 
 	/* Trigger the initial nodes for processing, which are the ones at the `input' end */
 	for (auto const& i : _graph_chain->_init_trigger_list) {
-		g_atomic_int_inc (&_trigger_queue_size);
-		_trigger_queue.push_back (i.get ());
+		trigger (i.get ());
 	}
 }
 
@@ -233,7 +234,14 @@ void
 Graph::trigger (ProcessNode* n)
 {
 	g_atomic_int_inc (&_trigger_queue_size);
-	_trigger_queue.push_back (n);
+	if (!_trigger_queue.push_back (n)) {
+		/* The queue is sized to hold all nodes of the chain, so this
+		 * should not happen. Still, a lost node would never reach the
+		 * terminal node, and stall the graph. Process it right here.
+		 */
+		g_atomic_int_dec_and_test (&_trigger_queue_size);
+		n->run (_graph_chain);
+	}
 }
 
 /** Called when a node at the `output' end of the chain (ie one that has no-one to feed)
@@ -297,7 +305,7 @@ Graph::run_one ()
 		return;
 	}
 
-	if (_trigger_queue.pop_front (to_run)) {
+	if (_trigger_queue.pop_front (to_run) || _subtask_queue.pop_front (to_run)) {
 		/* Wake up idle threads, but at most as many as there's
 		 * work in the trigger queue that can be processed by
 		 * other threads.
@@ -330,7 +338,9 @@ Graph::run_one ()
 		g_atomic_int_dec_and_test (&_idle_thread_cnt);
 
 		/* Try to find some work to do */
-		_trigger_queue.pop_front (to_run);
+		if (!_trigger_queue.pop_front (to_run)) {
+			_subtask_queue.pop_front (to_run);
+		}
 	}
 
 	/* Update the thread-local tempo map ptr.
@@ -589,6 +599,10 @@ Graph::process_tasklist (RTTaskList const& rt)
 	g_atomic_int_set (&_terminal_refcnt, tasks.size ());
 	_graph_empty = false;
 
+	if (_trigger_queue.capacity () < tasks.size ()) {
+		_trigger_queue.reserve (tasks.size ());
+	}
+
 	for (auto const& t : tasks) {
 		_trigger_queue.push_back (const_cast<RTTask*>(&t));
 	}
@@ -600,6 +614,51 @@ Graph::process_tasklist (RTTaskList const& rt)
 	DEBUG_TRACE (DEBUG::ProcessThreads, "graph execution complete\n");
 }
 
+/** Queue a node which is not part of the graph-chain, and wake up an idle
+ * thread to process it. Unlike graph-nodes, the node does not take part in
+ * reaching the terminal node.
+ *
+ * Sub-tasks use a queue of their own, so that run_queued() never
+ * picks up a graph-node.
+ * @return false if the node could not be queued
+ */
+bool
+Graph::dispatch (ProcessNode* n)
+{
+	g_atomic_int_inc (&_trigger_queue_size);
+	if (!_subtask_queue.push_back (n)) {
+		g_atomic_int_dec_and_test (&_trigger_queue_size);
+		return false;
+	}
+	if (g_atomic_uint_get (&_idle_thread_cnt) > 0) {
+		_execution_sem.signal ();
+	}
+	return true;
+}
+
+/** Process a queued sub-task in the calling thread, if there is one.
+ *
+ * Graph nodes (routes) are left to other threads, since they use the
+ * thread's buffers, which the caller may still be using.
+ */
+bool
+Graph::run_queued ()
+{
+	ProcessNode* to_run = NULL;
+	if (!_subtask_queue.pop_front (to_run)) {
+		return false;
+	}
+	g_atomic_int_dec_and_test (&_trigger_queue_size);
+	to_run->run (_graph_chain);
+	return true;
+}
+
+guint
+Graph::n_idle_threads () const
+{
+	return g_atomic_uint_get (&_idle_thread_cnt);
+}
+
 /* ****************************************************************************/
 
 GraphChain::GraphChain (GraphNodeList const& nodelist, GraphEdges const& edges)
@@ -76,24 +76,6 @@ GraphEdges::find_in_to_from_with_sends (GraphVertex to, GraphVertex from)
 	return _to_from_with_sends.end ();
 }
 
-GraphEdges::EdgeMapWithSends::const_iterator
-GraphEdges::find_recursively_in_from_to_with_sends (GraphVertex from, GraphVertex to) const
-{
-	typedef EdgeMapWithSends::const_iterator Iter;
-	pair<Iter, Iter> r = _from_to_with_sends.equal_range (from);
-	for (Iter i = r.first; i != r.second; ++i) {
-		if (i->second.first == to) {
-			return i;
-		}
-		Iter t = find_recursively_in_from_to_with_sends (i->second.first, to);
-		if (t != _from_to_with_sends.end ()) {
-			return t;
-		}
-	}
-
-	return _from_to_with_sends.end ();
-}
-
 /** @param via_sends_only if non-0, filled in with true if the edge is a
  *  path via a send only.
  *  @return true if the given edge is present.
@@ -113,14 +95,34 @@ GraphEdges::has (GraphVertex from, GraphVertex to, bool* via_sends_only)
 	return true;
 }
 
+/** @return true if there is a path from `from' to `to'.
+ *  Every vertex that `from' feeds is visited at most once.
+ */
 bool
 GraphEdges::feeds (GraphVertex from, GraphVertex to) const
 {
-	EdgeMapWithSends::const_iterator i = find_recursively_in_from_to_with_sends (from, to);
-	if (i == _from_to_with_sends.end ()) {
-		return false;
+	set<GraphVertex>  visited;
+	list<GraphVertex> queue;
+
+	queue.push_back (from);
+
+	while (!queue.empty ()) {
+		EdgeMap::const_iterator i = _from_to.find (queue.front ());
+		queue.pop_front ();
+		if (i == _from_to.end ()) {
+			continue;
+		}
+		for (auto const& v : i->second) {
+			if (v == to) {
+				return true;
+			}
+			if (visited.insert (v).second) {
+				queue.push_back (v);
+			}
+		}
 	}
-	return true;
+
+	return false;
 }
 
 set<GraphVertex>
@@ -174,6 +176,10 @@ GraphEdges::remove (GraphVertex from, GraphVertex to)
 	EdgeMapWithSends::iterator k = find_in_from_to_with_sends (from, to);
 	assert (k != _from_to_with_sends.end ());
 	_from_to_with_sends.erase (k);
+
+	EdgeMapWithSends::iterator l = find_in_to_from_with_sends (to, from);
+	assert (l != _to_from_with_sends.end ());
+	_to_from_with_sends.erase (l);
 }
 
 /** @param to `To' route.
@@ -274,33 +280,12 @@ struct RouteRecEnabledComparator
 	}
 };
 
-/** Perform a topological sort of a list of routes using a directed graph representing connections.
- *  @return Sorted list of routes, or 0 if the graph contains cycles (feedback loops).
+/** Sort nodes according to the given edges.
+ *  @return false if the graph contains cycles (feedback loops).
  */
-bool
-ARDOUR::topological_sort (GraphNodeList& nodes, GraphEdges& edges)
+static bool
+sort_by_edges (GraphNodeList& nodes, GraphEdges const& edges)
 {
-	/* Collect the edges of the  graph.  Each of these edges
-	 * is a pair of nodes, one of which directly feeds the other
-	 * either by a port connection or by an internal send.
-	 */
-
-	for (auto const& i : nodes) {
-
-		for (auto const& j : nodes) {
-
-			bool via_sends_only = false;
-
-			/* See if this *j feeds *i according to the current state of
-			 * port connections and internal sends.
-			 */
-			if (j->direct_feeds_according_to_reality (i, &via_sends_only)) {
-				/* add the edge to the graph (part #1) */
-				edges.add (j, i, via_sends_only);
-			}
-		}
-	}
-
 	GraphNodeList queue;
 
 	/* initial queue has routes that are not fed by anything */
@@ -344,3 +329,120 @@ ARDOUR::topological_sort (GraphNodeList& nodes, GraphEdges& edges)
 
 	return true;
 }
+
+/** Perform a topological sort of a list of routes using a directed graph representing connections.
+ *  @return Sorted list of routes, or 0 if the graph contains cycles (feedback loops).
+ */
+bool
+ARDOUR::topological_sort (GraphNodeList& nodes, GraphEdges& edges)
+{
+	/* Collect the edges of the  graph.  Each of these edges
+	 * is a pair of nodes, one of which directly feeds the other
+	 * either by a port connection or by an internal send.
+	 */
+
+	for (auto const& i : nodes) {
+
+		for (auto const& j : nodes) {
+
+			bool via_sends_only = false;
+
+			/* See if this *j feeds *i according to the current state of
+			 * port connections and internal sends.
+			 */
+			if (j->direct_feeds_according_to_reality (i, &via_sends_only)) {
+				/* add the edge to the graph (part #1) */
+				edges.add (j, i, via_sends_only);
+			}
+		}
+	}
+
+	return sort_by_edges (nodes, edges);
+}
+
+/** Bring the edge from `from' to `to' in line with the current state of
+ *  port connections and internal sends.
+ *  @param added edges that were not present before are appended here
+ *  @return true if the edge was added, removed or changed
+ */
+static bool
+update_edge (GraphEdges& edges, GraphVertex from, GraphVertex to, list<pair<GraphVertex, GraphVertex> >& added)
+{
+	bool via_sends_only = false;
+	bool was_sends_only = false;
+
+	bool const feeds = from->direct_feeds_according_to_reality (to, &via_sends_only);
+	bool const fed   = edges.has (from, to, &was_sends_only);
+
+	if (feeds == fed && (!feeds || via_sends_only == was_sends_only)) {
+		return false;
+	}
+
+	if (fed) {
+		edges.remove (from, to);
+	}
+
+	if (feeds) {
+		edges.add (from, to, via_sends_only);
+		if (!fed) {
+			added.push_back (make_pair (from, to));
+		}
+	}
+
+	return true;
+}
+
+/** Update a topological sort after the connections of some nodes changed.
+ *
+ *  Only the edges to and from the changed nodes are re-evaluated, and only
+ *  the part of the graph downstream of a new edge is searched for cycles.
+ *  The order of `nodes' is kept if no edge changed.
+ *
+ *  @param nodes all nodes, sorted according to `edges'
+ *  @param edges the edges of the previous sort, updated on success
+ *  @param changed nodes whose connections may have changed
+ *  @param edges_changed set to true if any edge was added or removed
+ *  @return false if the graph contains cycles (feedback loops), `nodes'
+ *  and `edges' are not modified in that case.
+ */
+bool
+ARDOUR::topological_sort (GraphNodeList& nodes, GraphEdges& edges, set<GraphVertex> const& changed, bool& edges_changed)
+{
+	GraphEdges                             updated (edges);
+	list<pair<GraphVertex, GraphVertex> > added;
+
+	edges_changed = false;
+
+	for (auto const& c : changed) {
+		for (auto const& n : nodes) {
+			if (update_edge (updated, c, n, added)) {
+				edges_changed = true;
+			}
+			if (n != c && changed.find (n) == changed.end () && update_edge (updated, n, c, added)) {
+				edges_changed = true;
+			}
+		}
+	}
+
+	if (!edges_changed) {
+		return true;
+	}
+
+	/* The graph was acyclic before, so any cycle has to include one
+	 * of the new edges, which is the case if its target feeds its source.
+	 */
+	for (auto const& e : added) {
+		if (e.first == e.second || updated.feeds (e.second, e.first)) {
+			return false;
+		}
+	}
+
+	GraphNodeList sorted (nodes);
+	if (!sort_by_edges (sorted, updated)) {
+		return false;
+	}
+
+	nodes.swap (sorted);
+	edges = updated;
+	return true;
+}
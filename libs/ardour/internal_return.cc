@@ -23,6 +23,8 @@
 
 #include "ardour/internal_return.h"
 #include "ardour/internal_send.h"
+#include "ardour/midi_buffer.h"
+#include "ardour/process_thread.h"
 #include "ardour/route.h"
 
 using namespace std;
@@ -47,9 +49,70 @@ InternalReturn::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t
 		return;
 	}
 
+	if (bufs.count().n_midi() == 0 || _sends.size () < 2) {
+		for (list<InternalSend*>::iterator i = _sends.begin(); i != _sends.end(); ++i) {
+			if ((*i)->active () && (!(*i)->source_route() || (*i)->source_route()->active())) {
+				bufs.merge_from ((*i)->get_buffers(), nframes);
+			}
+		}
+		return;
+	}
+
 	for (list<InternalSend*>::iterator i = _sends.begin(); i != _sends.end(); ++i) {
 		if ((*i)->active () && (!(*i)->source_route() || (*i)->source_route()->active())) {
-			bufs.merge_from ((*i)->get_buffers(), nframes);
+			bufs.merge_from ((*i)->get_buffers(), nframes, DataType::AUDIO);
+		}
+	}
+
+	merge_midi_from_sends (bufs);
+}
+
+/** Merge MIDI of all sends into @p bufs in a single pass per channel,
+ * rather than one (O(n^2)) merge_in_place() per send.
+ * Must be called with _sends_mutex held.
+ */
+void
+InternalReturn::merge_midi_from_sends (BufferSet& bufs)
+{
+	MidiBuffer& scratch (ProcessThread::get_scratch_buffers (ChanCount (DataType::MIDI, 1)).get_midi (0));
+
+	for (uint32_t n = 0; n < bufs.count().n_midi(); ++n) {
+
+		MidiBuffer& dst (bufs.get_midi (n));
+		MidiBufferMerger merger;
+		bool             merged = false;
+
+		scratch.copy (dst);
+		merger.add (scratch);
+
+		for (list<InternalSend*>::iterator i = _sends.begin(); i != _sends.end(); ++i) {
+
+			if (!(*i)->active () || ((*i)->source_route() && !(*i)->source_route()->active())) {
+				continue;
+			}
+
+			BufferSet const& src ((*i)->get_buffers());
+
+			if (n >= src.count().n_midi() || src.get_midi (n).empty ()) {
+				continue;
+			}
+
+			merged = true;
+
+			if (!merger.add (src.get_midi (n))) {
+				/* too many sources: flush what we have, and
+				 * continue with the result as first source.
+				 */
+				dst.read_from (merger);
+				scratch.copy (dst);
+				merger.clear ();
+				merger.add (scratch);
+				merger.add (src.get_midi (n));
+			}
+		}
+
+		if (merged) {
+			dst.read_from (merger);
 		}
 	}
 }
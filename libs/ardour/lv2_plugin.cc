@@ -372,6 +372,8 @@ struct LV2Plugin::Impl {
 	       , work_iface(0)
 	       , opts_iface(0)
 	       , state(0)
+	       , restore(0)
+	       , keep_restored(false)
 	       , block_length(0)
 	       , options(0)
 #ifdef LV2_EXTENDED
@@ -394,6 +396,8 @@ struct LV2Plugin::Impl {
 	const LV2_Worker_Interface*  work_iface;
 	const LV2_Options_Interface* opts_iface;
 	LilvState*                   state;
+	LilvState*                   restore;       ///< to be restored by deferred_restore()
+	bool                         keep_restored; ///< use restore as state once restored
 	LV2_Atom_Forge               forge;
 	LV2_Atom_Forge               ui_forge;
 	int32_t                      block_length;
@@ -1048,6 +1052,7 @@ LV2Plugin::~LV2Plugin ()
 
 	lilv_instance_free(_impl->instance);
 	lilv_state_free(_impl->state);
+	lilv_state_free(_impl->restore);
 	lilv_node_free(_impl->name);
 	lilv_node_free(_impl->author);
 	free(_impl->options);
@@ -2210,8 +2215,9 @@ LV2Plugin::set_insert_id(PBD::ID id)
 		_insert_id = id;
 	} else if (_insert_id != id) {
 		lilv_state_free(_impl->state);
-		_impl->state = NULL;
-		_insert_id   = id;
+		_impl->state         = NULL;
+		_impl->keep_restored = false;
+		_insert_id           = id;
 	}
 }
 
@@ -2291,15 +2297,27 @@ LV2Plugin::set_state(const XMLNode& node, int version)
 		LilvState* state = lilv_state_new_from_file(
 			_world.world, _uri_map.urid_map(), NULL, state_file.c_str());
 
-		lilv_state_restore(state, _impl->instance, NULL, NULL, 0, NULL);
 		lilv_state_free(_impl->state);
-		_impl->state = state;
+		_impl->state = NULL;
+
+		if (defer_restore ()) {
+			/* the state is restored concurrently with other plugins,
+			 * and used as _impl->state once that is done.
+			 */
+			lilv_state_free(_impl->restore);
+			_impl->restore       = state;
+			_impl->keep_restored = true;
+		} else {
+			lilv_state_restore(state, _impl->instance, NULL, NULL, 0, NULL);
+			_impl->state = state;
+		}
 	}
 
 	if (!_plugin_state_dir.empty ()) {
 		// force save with session, next time (increment counter)
 		lilv_state_free (_impl->state);
-		_impl->state = NULL;
+		_impl->state         = NULL;
+		_impl->keep_restored = false;
 		set_state_dir ("");
 	}
 
@@ -2311,13 +2329,39 @@ LV2Plugin::set_state(const XMLNode& node, int version)
 	 * but NOT when copying the state from a plugin to another (active) plugin
 	 * instance.
 	 */
-	if (_session.loading ()) {
+	if (_session.loading () && !restore_deferred ()) {
 		latency_compute_run();
 	}
 
 	return Plugin::set_state(node, version);
 }
 
+void
+LV2Plugin::deferred_restore ()
+{
+	/* LV2 state:restore() is in the instantiation threading class,
+	 * so this may run concurrently for different instances.
+	 */
+	lilv_state_restore(_impl->restore, _impl->instance, NULL, NULL, 0, NULL);
+}
+
+void
+LV2Plugin::deferred_restore_done ()
+{
+	if (_impl->keep_restored && !_impl->state) {
+		_impl->state = _impl->restore;
+	} else {
+		lilv_state_free(_impl->restore);
+	}
+	_impl->restore       = NULL;
+	_impl->keep_restored = false;
+
+	/* latency_compute_run() queries the lilv world, which is not thread-safe */
+	if (_session.loading ()) {
+		latency_compute_run();
+	}
+}
+
 int
 LV2Plugin::get_parameter_descriptor(uint32_t which, ParameterDescriptor& desc) const
 {
@@ -432,6 +432,40 @@ MidiBuffer::second_simultaneous_midi_byte_is_first (uint8_t a, uint8_t b)
 	return b_first;
 }
 
+/** Replace the contents of this buffer with all events of \a merger,
+ *  in time order.  Realtime safe.
+ *  @return false if this buffer is too small to hold all events.
+ */
+bool
+MidiBuffer::read_from (MidiBufferMerger& merger)
+{
+	TimeType          time;
+	Evoral::EventType type;
+	uint32_t          size;
+	uint8_t const*    data;
+
+	clear ();
+
+	while (merger.next (time, type, size, data)) {
+		const size_t bytes = align32 (sizeof (TimeType) + sizeof (Evoral::EventType) + size);
+
+		if (_size + bytes > _capacity) {
+			cerr << string_compose ("MidiBuffer::read_from failed (buffer is full: size: %1 capacity %2 new bytes %3)", _size, _capacity, bytes) << endl;
+			return false;
+		}
+
+		uint8_t* const write_loc = _data + _size;
+		*(reinterpret_cast<TimeType*>((uintptr_t)write_loc)) = time;
+		*(reinterpret_cast<Evoral::EventType*>((uintptr_t)(write_loc + sizeof (TimeType)))) = type;
+		memcpy (write_loc + sizeof (TimeType) + sizeof (Evoral::EventType), data, size);
+
+		_size += bytes;
+	}
+
+	_silent = (_size == 0);
+	return true;
+}
+
 /** Merge \a other into this buffer.  Realtime safe. */
 bool
 MidiBuffer::merge_in_place (const MidiBuffer &other)
@@ -597,3 +631,140 @@ MidiBuffer::merge_in_place (const MidiBuffer &other)
 
 	return true;
 }
+
+/* ---------------------------------------------------------------------------*/
+
+bool
+MidiBufferMerger::add (MidiBuffer const& buf)
+{
+	assert (!_started);
+
+	if (buf.empty ()) {
+		return true;
+	}
+
+	if (_n_sources == max_sources) {
+		return false;
+	}
+
+	Cursor& c (_cursors[_n_sources]);
+	c.buffer = &buf;
+	c.offset = 0;
+	c.index  = _n_sources;
+
+	++_n_sources;
+	return true;
+}
+
+/** Position of a message in the order of simultaneous events, as given by
+ * MidiBuffer::second_simultaneous_midi_byte_is_first(). That only orders
+ * messages of the same channel, which does not make a consistent order
+ * for the heap: events of different channels are ranked the same way.
+ */
+int
+MidiBufferMerger::simultaneous_rank (uint8_t status)
+{
+	if (status >= 0xf0) {
+		return 7;
+	}
+
+	switch (status & 0xf0) {
+	case MIDI_CMD_CONTROL:
+		return 0;
+	case MIDI_CMD_PGM_CHANGE:
+		return 1;
+	case MIDI_CMD_NOTE_OFF:
+		return 2;
+	case MIDI_CMD_NOTE_ON:
+		return 3;
+	case MIDI_CMD_NOTE_PRESSURE:
+		return 4;
+	case MIDI_CMD_CHANNEL_PRESSURE:
+		return 5;
+	case MIDI_CMD_BENDER:
+		return 6;
+	default:
+		return 7;
+	}
+}
+
+bool
+MidiBufferMerger::earlier (Cursor const& a, Cursor const& b)
+{
+	const MidiBuffer::TimeType ta = a.time ();
+	const MidiBuffer::TimeType tb = b.time ();
+
+	if (ta != tb) {
+		return ta < tb;
+	}
+
+	const int ra = simultaneous_rank (a.data ()[0]);
+	const int rb = simultaneous_rank (b.data ()[0]);
+
+	if (ra != rb) {
+		return ra < rb;
+	}
+
+	/* order does not matter, keep it stable */
+	return a.index < b.index;
+}
+
+void
+MidiBufferMerger::sift_down (uint32_t i)
+{
+	for (;;) {
+		uint32_t l = 2 * i + 1;
+		uint32_t r = l + 1;
+		uint32_t m = i;
+
+		if (l < _n_active && earlier (_cursors[l], _cursors[m])) {
+			m = l;
+		}
+		if (r < _n_active && earlier (_cursors[r], _cursors[m])) {
+			m = r;
+		}
+		if (m == i) {
+			break;
+		}
+		std::swap (_cursors[i], _cursors[m]);
+		i = m;
+	}
+}
+
+bool
+MidiBufferMerger::next (MidiBuffer::TimeType& time, Evoral::EventType& type, uint32_t& size, uint8_t const *& data)
+{
+	if (!_started) {
+		_started  = true;
+		_n_active = _n_sources;
+		for (int32_t i = (int32_t) _n_active / 2 - 1; i >= 0; --i) {
+			sift_down (i);
+		}
+	}
+
+	if (_n_active == 0) {
+		return false;
+	}
+
+	Cursor& c (_cursors[0]);
+
+	const int event_size = Evoral::midi_event_size (c.data ());
+	assert (event_size > 0);
+
+	time = c.time ();
+	type = *(reinterpret_cast<Evoral::EventType const*>((uintptr_t)(c.buffer->_data + c.offset + sizeof (MidiBuffer::TimeType))));
+	size = event_size;
+	data = c.data ();
+
+	/* advance the cursor, and restore the heap */
+
+	c.offset += MidiBuffer::align32 (sizeof (MidiBuffer::TimeType) + sizeof (Evoral::EventType) + event_size);
+
+	if (c.offset >= c.buffer->size ()) {
+		_cursors[0] = _cursors[--_n_active];
+	}
+
+	sift_down (0);
+
+	return true;
+}
@@ -50,6 +50,7 @@ using namespace std;
 MidiPlaylist::MidiPlaylist (Session& session, const XMLNode& node, bool hidden)
 	: Playlist (session, node, DataType::MIDI, hidden)
 	, _note_mode(Sustained)
+	, _render_all (true)
 {
 #ifndef NDEBUG
 	XMLProperty const * prop = node.property("type");
@@ -68,12 +69,14 @@ MidiPlaylist::MidiPlaylist (Session& session, const XMLNode& node, bool hidden)
 MidiPlaylist::MidiPlaylist (Session& session, string name, bool hidden)
 	: Playlist (session, name, DataType::MIDI, hidden)
 	, _note_mode(Sustained)
+	, _render_all (true)
 {
 }
 
 MidiPlaylist::MidiPlaylist (boost::shared_ptr<const MidiPlaylist> other, string name, bool hidden)
 	: Playlist (other, name, hidden)
 	, _note_mode(other->_note_mode)
+	, _render_all (true)
 {
 }
 
@@ -84,6 +87,7 @@ MidiPlaylist::MidiPlaylist (boost::shared_ptr<const MidiPlaylist> other,
                             bool                                  hidden)
 	: Playlist (other, start, dur, name, hidden)
 	, _note_mode(other->_note_mode)
+	, _render_all (true)
 {
 }
 
@@ -128,6 +132,8 @@ MidiPlaylist::set_state (const XMLNode& node, int version)
 	in_set_state++;
 	freeze ();
 
+	invalidate_rendered ();
+
 	if (Playlist::set_state (node, version)) {
 		return -1;
 	}
@@ -283,14 +289,8 @@ MidiPlaylist::contained_automation()
 }
 
 void
-MidiPlaylist::render (MidiChannelFilter* filter)
+MidiPlaylist::renderable_regions (MidiRegionList& regs)
 {
-	Playlist::RegionReadLock rl (this);
-
-	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- MidiPlaylist::render (regions: %1)-----\n", regions.size()));
-
-	std::list<boost::shared_ptr<MidiRegion>> regs;
-
 	for (RegionList::iterator i = regions.begin(); i != regions.end(); ++i) {
 
 		/* check for the case of solo_selection */
@@ -310,6 +310,37 @@ MidiPlaylist::render (MidiChannelFilter* filter)
 
 		regs.push_back (mr);
 	}
+}
+
+void
+MidiPlaylist::update_rendered_layers ()
+{
+	_rendered_layers.clear ();
+
+	for (RegionList::const_iterator i = regions.begin(); i != regions.end(); ++i) {
+		_rendered_layers[(*i)->id ()] = (*i)->layer ();
+	}
+}
+
+void
+MidiPlaylist::render (MidiChannelFilter* filter)
+{
+	Playlist::RegionReadLock rl (this);
+
+	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- MidiPlaylist::render (regions: %1)-----\n", regions.size()));
+
+	TimerRAII tr (_render_stats);
+
+	{
+		Glib::Threads::Mutex::Lock lm (_dirty_lock);
+		_dirty_ranges.clear ();
+		_render_all = false;
+	}
+
+	update_rendered_layers ();
+
+	MidiRegionList regs;
+	renderable_regions (regs);
 
 	/* RAII */
 	RTMidiBuffer::WriteProtectRender wpr (_rendered);
@@ -331,6 +362,26 @@ MidiPlaylist::render (MidiChannelFilter* filter)
 		return;
 	}
 
+	Evoral::EventList<samplepos_t> evlist;
+
+	render_regions (regs, evlist, filter);
+
+	wpr.acquire ();
+	_rendered.clear ();
+
+	/* Copy ordered events from event list to _rendered. */
+	for (Evoral::EventList<samplepos_t>::iterator e = evlist.begin(); e != evlist.end(); ++e) {
+		Evoral::Event<samplepos_t>* ev (*e);
+		_rendered.write (ev->time(), ev->event_type(), ev->size(), ev->buffer());
+		delete ev;
+	}
+
+	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- End MidiPlaylist::render, events: %1\n", _rendered.size()));
+}
+
+void
+MidiPlaylist::render_regions (MidiRegionList& regs, Evoral::EventList<samplepos_t>& evlist, MidiChannelFilter* filter)
+{
 	RegionSortByLayer cmp;
 	regs.sort (cmp);
 
@@ -344,8 +395,6 @@ MidiPlaylist::render (MidiChannelFilter* filter)
 		}
 	}
 
-	Evoral::EventList<samplepos_t> evlist;
-
 	if (all_transparent) {
 
 		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("\t%1 regions to read\n", regs.size()));
@@ -419,18 +468,178 @@ MidiPlaylist::render (MidiChannelFilter* filter)
 			evlist.sort (cmp);
 		}
 	}
+}
+
+void
+MidiPlaylist::render_incremental (MidiChannelFilter* filter)
+{
+	std::list<Temporal::Range> dirty;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_dirty_lock);
+
+		if (!_render_all && !_dirty_ranges.empty ()) {
+			dirty.swap (_dirty_ranges);
+		}
+	}
+
+	/* the RTMidiBuffer may currently be reversed, and a solo-selection
+	 * can change without any region being modified. Neither is worth
+	 * optimizing for.
+	 */
+
+	if (dirty.empty () || _rendered.reversed () || _session.solo_selection_active ()) {
+		render (filter);
+		return;
+	}
+
+	Playlist::RegionReadLock rl (this);
+
+	TimerRAII tr (_incremental_render_stats);
+
+	/* Regions that changed layer since the last render need to be
+	 * re-rendered as well; re-layering is not signalled per region.
+	 */
+
+	for (RegionList::const_iterator i = regions.begin(); i != regions.end(); ++i) {
+		std::map<PBD::ID, layer_t>::const_iterator l = _rendered_layers.find ((*i)->id ());
+		if (l == _rendered_layers.end () || l->second != (*i)->layer ()) {
+			dirty.push_back ((*i)->range ());
+		}
+	}
+
+	update_rendered_layers ();
+
+	/* convert to (closed) sample ranges, sort and coalesce */
+
+	typedef std::pair<samplepos_t, samplepos_t> SampleRange;
+	std::vector<SampleRange> ranges;
+
+	for (std::list<Temporal::Range>::const_iterator d = dirty.begin(); d != dirty.end(); ++d) {
+		samplepos_t s = d->start ().samples ();
+		samplepos_t e = d->end ().samples ();
+		ranges.push_back (SampleRange (std::min (s, e), std::max (s, e)));
+	}
+
+	std::sort (ranges.begin (), ranges.end ());
+
+	std::vector<SampleRange> merged;
+
+	for (std::vector<SampleRange>::const_iterator r = ranges.begin (); r != ranges.end (); ++r) {
+		if (!merged.empty () && r->first <= merged.back ().second) {
+			merged.back ().second = std::max (merged.back ().second, r->second);
+		} else {
+			merged.push_back (*r);
+		}
+	}
+
+	/* Every event that ends up in a dirty range originates from a region
+	 * that overlaps the range (including note-offs resolved at the end of
+	 * a region). Re-render all of these regions in full, then keep only
+	 * the events inside the dirty ranges.
+	 */
+
+	MidiRegionList all;
+	MidiRegionList regs;
+
+	renderable_regions (all);
+
+	for (MidiRegionList::const_iterator i = all.begin (); i != all.end (); ++i) {
+		const samplepos_t rs = (*i)->position ().samples ();
+		const samplepos_t re = (*i)->end ().samples ();
+		for (std::vector<SampleRange>::const_iterator m = merged.begin (); m != merged.end (); ++m) {
+			if (rs <= m->second && re >= m->first) {
+				regs.push_back (*i);
+				break;
+			}
+		}
+	}
+
+	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- MidiPlaylist::render_incremental (ranges: %1, regions: %2 of %3)-----\n", merged.size (), regs.size (), all.size ()));
+
+	Evoral::EventList<samplepos_t> evlist;
+
+	if (!regs.empty ()) {
+		render_regions (regs, evlist, filter);
+	}
 
+	RTMidiBuffer::WriteProtectRender wpr (_rendered);
 	wpr.acquire ();
-	_rendered.clear ();
 
-	/* Copy ordered events from event list to _rendered. */
-	for (Evoral::EventList<samplepos_t>::iterator e = evlist.begin(); e != evlist.end(); ++e) {
-		Evoral::Event<samplepos_t>* ev (*e);
-		_rendered.write (ev->time(), ev->event_type(), ev->size(), ev->buffer());
-		delete ev;
+	Evoral::EventList<samplepos_t>::iterator e = evlist.begin ();
+
+	for (std::vector<SampleRange>::const_iterator m = merged.begin (); m != merged.end (); ++m) {
+
+		_splice_buffer.clear ();
+
+		while (e != evlist.end () && (*e)->time () <= m->second) {
+			Evoral::Event<samplepos_t>* ev (*e);
+			if (ev->time () >= m->first) {
+				_splice_buffer.write (ev->time(), ev->event_type(), ev->size(), ev->buffer());
+			}
+			++e;
+		}
+
+		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("splice %1 .. %2 with %3 events\n", m->first, m->second, _splice_buffer.size ()));
+
+		_rendered.splice (m->first, m->second, _splice_buffer);
 	}
 
-	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- End MidiPlaylist::render, events: %1\n", _rendered.size()));
+	for (e = evlist.begin(); e != evlist.end(); ++e) {
+		delete *e;
+	}
+
+	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- End MidiPlaylist::render_incremental, events: %1\n", _rendered.size()));
+}
+
+void
+MidiPlaylist::invalidate_rendered ()
+{
+	Glib::Threads::Mutex::Lock lm (_dirty_lock);
+	_dirty_ranges.clear ();
+	_render_all = true;
+}
+
+void
+MidiPlaylist::region_range_invalidated (Temporal::Range const & r)
+{
+	Glib::Threads::Mutex::Lock lm (_dirty_lock);
+	if (!_render_all) {
+		_dirty_ranges.push_back (r);
+	}
+}
+
+bool
+MidiPlaylist::region_changed (const PBD::PropertyChange& what_changed, boost::shared_ptr<Region> region)
+{
+	PropertyChange bounds;
+	PropertyChange content;
+
+	bounds.add (Properties::start);
+	bounds.add (Properties::length);
+
+	content.add (Properties::muted);
+	content.add (Properties::opaque);
+	content.add (Properties::contents);
+	content.add (Properties::time_domain);
+
+	if (what_changed.contains (bounds)) {
+		region_range_invalidated (region->last_range ());
+		region_range_invalidated (region->range ());
+	} else if (what_changed.contains (content)) {
+		region_range_invalidated (region->range ());
+	}
+
+	return Playlist::region_changed (what_changed, region);
+}
+
+bool
+MidiPlaylist::get_render_stats (bool incremental, PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev) const
+{
+	if (incremental) {
+		return _incremental_render_stats.get_stats (min, max, avg, dev);
+	}
+	return _render_stats.get_stats (min, max, avg, dev);
 }
 
 RTMidiBuffer*
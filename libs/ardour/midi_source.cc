@@ -29,6 +29,7 @@
 #include <cerrno>
 #include <ctime>
 #include <cmath>
+#include <cstring>
 #include <iomanip>
 #include <algorithm>
 
@@ -188,6 +189,24 @@ MidiSource::invalidate (const WriterLock& lock)
 	Invalidated(_session.transport_rolling());
 }
 
+void
+MidiSource::write_pending (Evoral::EventSink<samplepos_t>& dst, Temporal::Beats const * times, PendingEvent const * events, size_t n)
+{
+	if (n == 0) {
+		return;
+	}
+
+	samplepos_t samples[max_pending];
+
+	assert (n <= max_pending);
+
+	Temporal::TempoMap::use()->sample_at (times, samples, n);
+
+	for (size_t e = 0; e < n; ++e) {
+		dst.write (samples[e], events[e].type, events[e].size, events[e].buf);
+	}
+}
+
 timecnt_t
 MidiSource::midi_read (const ReaderLock&                  lm,
                        Evoral::EventSink<samplepos_t>&    dst,
@@ -239,6 +258,15 @@ MidiSource::midi_read (const ReaderLock&                  lm,
 	const Temporal::Beats end = source_start_beats + region_start_beats + cnt_beats;
 	const Temporal::Beats session_source_start = (source_start + start).beats();
 
+	/* Events that are not looped are queued (up to max_pending), so that
+	 * their times can be converted to samples with a single walk of the
+	 * tempo map, rather than one lookup per event.
+	 */
+
+	PendingEvent    pending[max_pending];
+	Temporal::Beats pending_time[max_pending];
+	size_t          n_pending = 0;
+
 	for (; i != _model->end(); ++i) {
 
 		// Offset by source start to convert event time to session time
@@ -259,38 +287,72 @@ MidiSource::midi_read (const ReaderLock&                  lm,
 
 			/* in range */
 
-			timepos_t seb = timepos_t (session_event_beats);
-			samplepos_t time_samples = seb.samples();
-
-			if (loop_range) {
-				time_samples = loop_range->squish (seb).samples();
-			}
-
 			const uint8_t status           = i->buffer()[0];
 			const bool    is_channel_event = (0x80 <= (status & 0xF0)) && (status <= 0xE0);
 
-			if (filter && is_channel_event) {
-				/* Copy event so the filter can modify the channel.  I'm not
-				 * sure if this is necessary here (channels are mapped later in
-				 * buffers anyway), but it preserves existing behaviour without
-				 *  destroying events in the model during read.
+			if (loop_range || i->size() > sizeof (pending[0].buf)) {
+
+				/* convert this event's time on its own, and
+				 * maintain event order by writing out the
+				 * pending events first.
 				 */
-				Evoral::Event<Temporal::Beats> ev(*i, true);
 
-				if (!filter->filter(ev.buffer(), ev.size())) {
-					dst.write (time_samples, ev.event_type(), ev.size(), ev.buffer());
+				write_pending (dst, pending_time, pending, n_pending);
+				n_pending = 0;
+
+				timepos_t seb = timepos_t (session_event_beats);
+				samplepos_t time_samples = seb.samples();
+
+				if (loop_range) {
+					time_samples = loop_range->squish (seb).samples();
+				}
+
+				if (filter && is_channel_event) {
+					/* Copy event so the filter can modify the channel.  I'm not
+					 * sure if this is necessary here (channels are mapped later in
+					 * buffers anyway), but it preserves existing behaviour without
+					 *  destroying events in the model during read.
+					 */
+					Evoral::Event<Temporal::Beats> ev(*i, true);
+
+					if (!filter->filter(ev.buffer(), ev.size())) {
+						dst.write (time_samples, ev.event_type(), ev.size(), ev.buffer());
+					} else {
+						DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("%1: filter event @ %2 type %3 size %4\n", _name, time_samples, i->event_type(), i->size()));
+					}
 				} else {
-					DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("%1: filter event @ %2 type %3 size %4\n", _name, time_samples, i->event_type(), i->size()));
+					dst.write (time_samples, i->event_type(), i->size(), i->buffer());
 				}
+
 			} else {
-				dst.write (time_samples, i->event_type(), i->size(), i->buffer());
-			}
 
+				/* queue the event, and convert event times
+				 * to samples for a batch of events at once.
+				 */
+
+				PendingEvent& pe (pending[n_pending]);
+
+				pe.type = i->event_type();
+				pe.size = i->size();
+				memcpy (pe.buf, i->buffer(), pe.size);
+
+				/* the filter may modify the channel of our copy */
+
+				if (filter && is_channel_event && filter->filter (pe.buf, pe.size)) {
+					DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("%1: filter event @ %2 type %3 size %4\n", _name, session_event_beats, i->event_type(), i->size()));
+				} else {
+					pending_time[n_pending] = session_event_beats;
+					if (++n_pending == max_pending) {
+						write_pending (dst, pending_time, pending, n_pending);
+						n_pending = 0;
+					}
+				}
+			}
 
 #ifndef NDEBUG
 			if (DEBUG_ENABLED(DEBUG::MidiSourceIO)) {
 				DEBUG_STR_DECL(a);
-				DEBUG_STR_APPEND(a, string_compose ("%1 added event @ %2 (%3) sz %4 within %5 .. %6 ", _name, time_samples, session_event_beats, i->size(), source_start + start, end));
+				DEBUG_STR_APPEND(a, string_compose ("%1 added event @ %2 sz %3 within %4 .. %5 ", _name, session_event_beats, i->size(), source_start + start, end));
 				for (size_t n=0; n < i->size(); ++n) {
 					DEBUG_STR_APPEND(a,hex);
 					DEBUG_STR_APPEND(a,"0x");
@@ -307,6 +369,9 @@ MidiSource::midi_read (const ReaderLock&                  lm,
 			}
 		}
 	}
+
+	write_pending (dst, pending_time, pending, n_pending);
+
 	t.update ();
 
 	return cnt;
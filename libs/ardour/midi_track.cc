@@ -90,8 +90,8 @@ MidiTrack::MidiTrack (Session& sess, string name, TrackMode mode)
 {
 	_session.SessionLoaded.connect_same_thread (*this, boost::bind (&MidiTrack::restore_controls, this));
 
-	_playback_filter.ChannelModeChanged.connect_same_thread (*this, boost::bind (&Track::playlist_modified, this));
-	_playback_filter.ChannelMaskChanged.connect_same_thread (*this, boost::bind (&Track::playlist_modified, this));
+	_playback_filter.ChannelModeChanged.connect_same_thread (*this, boost::bind (&MidiTrack::playback_filter_changed, this));
+	_playback_filter.ChannelMaskChanged.connect_same_thread (*this, boost::bind (&MidiTrack::playback_filter_changed, this));
 }
 
 MidiTrack::~MidiTrack ()
@@ -952,3 +952,16 @@ MidiTrack::playlist_contents_changed ()
 
 {
 }
+
+void
+MidiTrack::playback_filter_changed ()
+{
+	/* the filter applies to every rendered event */
+	boost::shared_ptr<MidiPlaylist> mpl = midi_playlist ();
+
+	if (mpl) {
+		mpl->invalidate_rendered ();
+	}
+
+	playlist_modified ();
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <assert.h>
+#include <cstring>
+
+#include "pbd/compose.h"
+
+#include "ardour/audio_buffer.h"
+#include "ardour/buffer_set.h"
+#include "ardour/debug.h"
+#include "ardour/pipeline_stage.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/runtime_functions.h"
+#include "ardour/session.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+PipelineStage::PipelineStage (Session& s, const std::string& name)
+	: Processor (s, string_compose ("pipeline-%1-%2", name, this), Config->get_default_automation_time_domain())
+	, _period (s.get_block_size ())
+	, _bsiz (0)
+	, _woff (0)
+	, _can_split (false)
+{
+}
+
+PipelineStage::~PipelineStage ()
+{
+}
+
+bool
+PipelineStage::set_name (const string& name)
+{
+	return Processor::set_name (string_compose ("pipeline-%1-%2", name, this));
+}
+
+samplecnt_t
+PipelineStage::signal_latency () const
+{
+	return _can_split ? _period : 0;
+}
+
+bool
+PipelineStage::can_support_io_configuration (const ChanCount& in, ChanCount& out)
+{
+	out = in;
+	return true;
+}
+
+bool
+PipelineStage::configure_io (ChanCount in, ChanCount out)
+{
+	if (out != in) { // always 1:1
+		return false;
+	}
+
+	/* MIDI cannot be delayed by a ring-buffer, the stage is a no-op then */
+	_can_split = in.n_midi () == 0 && in.n_audio () > 0;
+
+	allocate (in);
+
+	DEBUG_TRACE (DEBUG::Processors,
+			string_compose ("%1 configure IO: Ain: %2 Min: %3 split: %4\n",
+				name (), in.n_audio (), in.n_midi (), _can_split));
+
+	return Processor::configure_io (in, out);
+}
+
+int
+PipelineStage::set_block_size (pframes_t nframes)
+{
+	if (_period != nframes) {
+		_period = nframes;
+		allocate (_configured_input);
+	}
+	return 0;
+}
+
+void
+PipelineStage::allocate (ChanCount const& cc)
+{
+	const uint32_t n_audio = _can_split ? cc.n_audio () : 0;
+
+	if (n_audio == _buf.size () && _bsiz == 2 * _period) {
+		return;
+	}
+
+	/* one cycle is written while the previous one is read */
+	_bsiz = 2 * _period;
+	_woff = 0;
+
+	_buf.clear ();
+	for (uint32_t i = 0; i < n_audio; ++i) {
+		boost::shared_array<Sample> b (new Sample[_bsiz]);
+		memset (b.get (), 0, _bsiz * sizeof (Sample));
+		_buf.push_back (b);
+	}
+}
+
+void
+PipelineStage::write (BufferSet const& bufs, pframes_t n_samples)
+{
+	assert (n_samples <= _period);
+
+	const samplecnt_t s0 = min<samplecnt_t> (n_samples, _bsiz - _woff);
+	const samplecnt_t s1 = n_samples - s0;
+
+	const uint32_t n_audio = min<uint32_t> (bufs.count ().n_audio (), _buf.size ());
+	for (uint32_t i = 0; i < n_audio; ++i) {
+		Sample* rb = _buf[i].get ();
+		Sample const* src = bufs.get_audio (i).data ();
+		copy_vector (&rb[_woff], src, s0);
+		if (s1 > 0) {
+			copy_vector (rb, &src[s0], s1);
+		}
+	}
+}
+
+void
+PipelineStage::read (BufferSet& bufs, pframes_t n_samples) const
+{
+	assert (n_samples <= _period);
+
+	/* the previous cycle, which does not overlap with the one being written */
+	const samplecnt_t roff = (_woff + _period) % _bsiz;
+	const samplecnt_t s0 = min<samplecnt_t> (n_samples, _bsiz - roff);
+	const samplecnt_t s1 = n_samples - s0;
+
+	const uint32_t n_audio = min<uint32_t> (bufs.count ().n_audio (), _buf.size ());
+	for (uint32_t i = 0; i < n_audio; ++i) {
+		Sample const* rb = _buf[i].get ();
+		Sample* dst = bufs.get_audio (i).data ();
+		copy_vector (dst, &rb[roff], s0);
+		if (s1 > 0) {
+			copy_vector (&dst[s0], rb, s1);
+		}
+	}
+}
+
+void
+PipelineStage::advance (pframes_t n_samples)
+{
+	_woff = (_woff + n_samples) % _bsiz;
+}
+
+void
+PipelineStage::run (BufferSet& bufs, samplepos_t /* start_sample */, samplepos_t /* end_sample */, double /* speed */, pframes_t n_samples, bool)
+{
+	if (!_can_split || n_samples > _period) {
+		return;
+	}
+
+	/* Both stages in the same thread: delay the signal by one cycle */
+	write (bufs, n_samples);
+	read (bufs, n_samples);
+	advance (n_samples);
+}
+
+XMLNode&
+PipelineStage::state () const
+{
+	XMLNode& node (Processor::state ());
+	node.set_property ("type", "pipeline");
+	return node;
+}
@@ -481,6 +481,8 @@ Playlist::notify_layering_changed ()
 void
 Playlist::notify_region_removed (boost::shared_ptr<Region> r)
 {
+	region_range_invalidated (r->range ());
+
 	if (holding_state ()) {
 		pending_removes.insert (r);
 		pending_contents_change = true;
@@ -551,6 +553,8 @@ Playlist::notify_region_end_trimmed (boost::shared_ptr<Region> r)
 void
 Playlist::notify_region_added (boost::shared_ptr<Region> r)
 {
+	region_range_invalidated (r->range ());
+
 	/* the length change might not be true, but we have to act
 	 * as though it could be.
 	 */
@@ -1392,6 +1396,8 @@ Playlist::shift (timepos_t const & at, timecnt_t const & distance, bool move_int
 	RegionWriteLock rlock (this);
 	RegionList copy (regions.rlist());
 	RegionList fixup;
+	RegionList moved;
+	std::vector<timepos_t> new_positions;
 
 	for (auto & r : copy) {
 
@@ -1416,8 +1422,19 @@ Playlist::shift (timepos_t const & at, timecnt_t const & distance, bool move_int
 			continue;
 		}
 
+		moved.push_back (r);
+		new_positions.push_back (r->position());
+	}
+
+	if (!moved.empty ()) {
+		Temporal::TempoMap::use()->add_duration (&new_positions[0], new_positions.size(), distance);
+	}
+
+	std::vector<timepos_t>::const_iterator p = new_positions.begin ();
+
+	for (auto & r : moved) {
 		rlock.thawlist.add (r);
-		r->set_position (r->position() + distance);
+		r->set_position (*p++);
 	}
 
 	/* XXX: may not be necessary; Region::post_set should do this, I think */
@@ -1544,6 +1561,9 @@ Playlist::ripple_unlocked (timepos_t const & at, timecnt_t const & distance, Reg
 	_rippling               = true;
 	RegionListProperty copy = regions;
 
+	RegionList             moved;
+	std::vector<timepos_t> new_positions;
+
 	for (auto & r : copy) {
 
 		if (exclude) {
@@ -1553,17 +1573,31 @@ Playlist::ripple_unlocked (timepos_t const & at, timecnt_t const & distance, Reg
 		}
 
 		if (r->position() >= at) {
-			timepos_t new_pos = r->position() + distance;
-			timepos_t limit = timepos_t::max (new_pos.time_domain()).earlier (r->length());
-			if (new_pos < 0) {
-				new_pos = timepos_t (new_pos.time_domain());
-			} else if (new_pos >= limit ) {
-				new_pos = limit;
-			}
+			moved.push_back (r);
+			new_positions.push_back (r->position());
+		}
+	}
+
+	if (!moved.empty ()) {
+		/* regions are sorted by position, so any time domain
+		 * conversions can be done in a single pass
+		 */
+		Temporal::TempoMap::use()->add_duration (&new_positions[0], new_positions.size(), distance);
+	}
 
-			thawlist.add (r);
-			r->set_position (new_pos);
+	std::vector<timepos_t>::iterator p = new_positions.begin ();
+
+	for (auto & r : moved) {
+		timepos_t new_pos = *p++;
+		timepos_t limit = timepos_t::max (new_pos.time_domain()).earlier (r->length());
+		if (new_pos < 0) {
+			new_pos = timepos_t (new_pos.time_domain());
+		} else if (new_pos >= limit ) {
+			new_pos = limit;
 		}
+
+		thawlist.add (r);
+		r->set_position (new_pos);
 	}
 
 	_rippling = false;
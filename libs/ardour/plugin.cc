@@ -27,6 +27,7 @@
 #include "libardour-config.h"
 #endif
 
+#include <algorithm>
 #include <vector>
 #include <string>
 
@@ -44,14 +45,18 @@
 #include <lrdf.h>
 #endif
 
+#include <boost/bind.hpp>
+
 #include "pbd/compose.h"
 #include "pbd/error.h"
+#include "pbd/timing.h"
 #include "pbd/xml++.h"
 
 #include "ardour/buffer_set.h"
 #include "ardour/chan_count.h"
 #include "ardour/chan_mapping.h"
 #include "ardour/data_type.h"
+#include "ardour/debug.h"
 #include "ardour/luaproc.h"
 #include "ardour/lv2_plugin.h"
 #include "ardour/midi_buffer.h"
@@ -59,8 +64,10 @@
 #include "ardour/plugin.h"
 #include "ardour/plugin_manager.h"
 #include "ardour/port.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session.h"
 #include "ardour/types.h"
+#include "ardour/utils.h"
 
 #ifdef AUDIOUNIT_SUPPORT
 #include "ardour/audio_unit.h"
@@ -79,6 +86,10 @@ namespace ARDOUR { class AudioEngine; }
 
 PBD::Signal3<void, std::string, Plugin*, bool> Plugin::PresetsChanged;
 
+/* plugins waiting for Plugin::DeferredRestore::run (), main thread only */
+static std::vector<Plugin*> deferred_restore_plugins;
+static int                  deferred_restore_depth = 0;
+
 bool
 PluginInfo::needs_midi_input () const
 {
@@ -97,6 +108,7 @@ Plugin::Plugin (AudioEngine& e, Session& s)
 	, _immediate_events(6096) // FIXME: size?
 	, _pi (0)
 	, _num (0)
+	, _restore_deferred (false)
 {
 	_pending_stop_events.ensure_buffers (DataType::MIDI, 1, 4096);
 	PresetsChanged.connect_same_thread(_preset_connection, boost::bind (&Plugin::invalidate_preset_cache, this, _1, _2, _3));
@@ -118,7 +130,11 @@ Plugin::Plugin (const Plugin& other)
 	, _immediate_events(6096) // FIXME: size?
 	, _pi (other._pi)
 	, _num (other._num)
+	, _restore_deferred (false)
 {
+	/* the copy is made from the restored state */
+	const_cast<Plugin&> (other).finish_deferred_restore ();
+
 	_pending_stop_events.ensure_buffers (DataType::MIDI, 1, 4096);
 
 	PresetsChanged.connect_same_thread(_preset_connection, boost::bind (&Plugin::invalidate_preset_cache, this, _1, _2, _3));
@@ -126,6 +142,79 @@ Plugin::Plugin (const Plugin& other)
 
 Plugin::~Plugin ()
 {
+	if (_restore_deferred) {
+		deferred_restore_plugins.erase (std::find (deferred_restore_plugins.begin (), deferred_restore_plugins.end (), this));
+	}
+}
+
+Plugin::DeferredRestore::DeferredRestore ()
+{
+	++deferred_restore_depth;
+}
+
+Plugin::DeferredRestore::~DeferredRestore ()
+{
+	run ();
+	--deferred_restore_depth;
+}
+
+void
+Plugin::DeferredRestore::restore (std::vector<Plugin*> const& plugins, size_t i)
+{
+	plugins[i]->deferred_restore ();
+}
+
+void
+Plugin::DeferredRestore::run ()
+{
+	if (deferred_restore_plugins.empty ()) {
+		return;
+	}
+
+	std::vector<Plugin*> plugins;
+	plugins.swap (deferred_restore_plugins);
+
+	for (std::vector<Plugin*>::const_iterator i = plugins.begin (); i != plugins.end (); ++i) {
+		(*i)->_restore_deferred = false;
+	}
+
+	PBD::Timing t;
+	t.start ();
+
+	parallel_for (plugins.size (), boost::bind (&DeferredRestore::restore, boost::cref (plugins), _1));
+
+	for (std::vector<Plugin*>::const_iterator i = plugins.begin (); i != plugins.end (); ++i) {
+		(*i)->deferred_restore_done ();
+	}
+
+	t.update ();
+	DEBUG_TRACE (DEBUG::LoadState, string_compose ("restored state of %1 plugins in %2 ms\n", plugins.size (), t.elapsed () / 1000.0));
+}
+
+void
+Plugin::finish_deferred_restore ()
+{
+	if (!_restore_deferred) {
+		return;
+	}
+	deferred_restore_plugins.erase (std::find (deferred_restore_plugins.begin (), deferred_restore_plugins.end (), this));
+	_restore_deferred = false;
+	deferred_restore ();
+	deferred_restore_done ();
+}
+
+bool
+Plugin::defer_restore ()
+{
+	if (_restore_deferred) {
+		return true;
+	}
+	if (deferred_restore_depth == 0 || !Config->get_concurrent_plugin_restore ()) {
+		return false;
+	}
+	deferred_restore_plugins.push_back (this);
+	_restore_deferred = true;
+	return true;
 }
 
 void
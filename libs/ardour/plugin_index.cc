@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstring>
+
+#include <glibmm/fileutils.h>
+
+#include "pbd/gstdio_compat.h"
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+#include "pbd/xml++.h"
+
+#include "ardour/debug.h"
+#include "ardour/plugin_index.h"
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+using std::string;
+
+/* The file starts with a header (magic, byte-order mark, number of entries),
+ * followed by the entries: path of the cache file, its mtime and size, and
+ * the encoded XML tree. The file is only valid on the machine that wrote it.
+ */
+static const char     index_magic[8] = { 'A', 'P', 'L', 'G', 'I', 'D', 'X', '1' };
+static const uint32_t index_bom      = 0x01020304;
+
+static void
+put_u32 (string& out, uint32_t v)
+{
+	out.append ((char const*) &v, sizeof (v));
+}
+
+static void
+put_i64 (string& out, int64_t v)
+{
+	out.append ((char const*) &v, sizeof (v));
+}
+
+static void
+put_str (string& out, string const& s)
+{
+	put_u32 (out, s.size ());
+	out.append (s);
+}
+
+static bool
+get_u32 (char const*& pos, char const* end, uint32_t& v)
+{
+	if (end - pos < (ptrdiff_t) sizeof (v)) {
+		return false;
+	}
+	memcpy (&v, pos, sizeof (v));
+	pos += sizeof (v);
+	return true;
+}
+
+static bool
+get_i64 (char const*& pos, char const* end, int64_t& v)
+{
+	if (end - pos < (ptrdiff_t) sizeof (v)) {
+		return false;
+	}
+	memcpy (&v, pos, sizeof (v));
+	pos += sizeof (v);
+	return true;
+}
+
+static bool
+get_str (char const*& pos, char const* end, string& s)
+{
+	uint32_t len;
+	if (!get_u32 (pos, end, len) || end - pos < (ptrdiff_t) len) {
+		return false;
+	}
+	s.assign (pos, len);
+	pos += len;
+	return true;
+}
+
+static void
+encode (XMLNode const& node, string& out)
+{
+	put_str (out, node.name ());
+	put_str (out, node.content ());
+
+	XMLPropertyList const& props (node.properties ());
+	put_u32 (out, props.size ());
+	for (XMLPropertyConstIterator i = props.begin (); i != props.end (); ++i) {
+		put_str (out, (*i)->name ());
+		put_str (out, (*i)->value ());
+	}
+
+	XMLNodeList const& children (node.children ());
+	put_u32 (out, children.size ());
+	for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+		encode (**i, out);
+	}
+}
+
+static XMLNode*
+decode (char const*& pos, char const* end, int depth = 0)
+{
+	string   name;
+	string   content;
+	uint32_t n;
+
+	if (depth > 32 || !get_str (pos, end, name) || !get_str (pos, end, content) || !get_u32 (pos, end, n)) {
+		return 0;
+	}
+
+	XMLNode* node = new XMLNode (name);
+
+	if (!content.empty ()) {
+		node->set_content (content);
+	}
+
+	for (uint32_t i = 0; i < n; ++i) {
+		string key;
+		string value;
+		if (!get_str (pos, end, key) || !get_str (pos, end, value)) {
+			delete node;
+			return 0;
+		}
+		node->set_property (key.c_str (), value);
+	}
+
+	if (!get_u32 (pos, end, n)) {
+		delete node;
+		return 0;
+	}
+
+	for (uint32_t i = 0; i < n; ++i) {
+		XMLNode* child = decode (pos, end, depth + 1);
+		if (!child) {
+			delete node;
+			return 0;
+		}
+		node->add_child_nocopy (*child);
+	}
+
+	return node;
+}
+
+PluginIndex::PluginIndex ()
+	: _map (0)
+	, _dirty (false)
+	, _n_parsed (0)
+{
+}
+
+PluginIndex::~PluginIndex ()
+{
+	unmap ();
+}
+
+void
+PluginIndex::unmap ()
+{
+	_entries.clear ();
+	if (_map) {
+		g_mapped_file_unref (_map);
+		_map = 0;
+	}
+}
+
+void
+PluginIndex::load (string const& path)
+{
+	unmap ();
+
+	_path     = path;
+	_dirty    = false;
+	_n_parsed = 0;
+
+	if (!Glib::file_test (path, Glib::FILE_TEST_IS_REGULAR)) {
+		return;
+	}
+
+	GError* err = NULL;
+	_map = g_mapped_file_new (path.c_str (), false, &err);
+
+	if (!_map) {
+		warning << string_compose (_("Cannot map plugin index '%1' (%2)"), path, err->message) << endmsg;
+		g_error_free (err);
+		return;
+	}
+
+	char const* pos = g_mapped_file_get_contents (_map);
+	char const* end = pos + g_mapped_file_get_length (_map);
+	uint32_t    bom;
+	uint32_t    n;
+
+	if (end - pos < (ptrdiff_t) sizeof (index_magic) || memcmp (pos, index_magic, sizeof (index_magic))) {
+		unmap ();
+		return;
+	}
+
+	pos += sizeof (index_magic);
+
+	if (!get_u32 (pos, end, bom) || bom != index_bom || !get_u32 (pos, end, n)) {
+		unmap ();
+		return;
+	}
+
+	/* only index the entries, they are decoded on demand */
+	for (uint32_t i = 0; i < n; ++i) {
+		string cache_file;
+		Entry  e;
+
+		if (!get_str (pos, end, cache_file) || !get_i64 (pos, end, e.mtime) || !get_i64 (pos, end, e.size) || !get_u32 (pos, end, e.len) || end - pos < (ptrdiff_t) e.len) {
+			warning << string_compose (_("Plugin index '%1' is truncated"), path) << endmsg;
+			_dirty = true;
+			break;
+		}
+
+		e.mapped = pos;
+		pos += e.len;
+
+		_entries[cache_file] = e;
+	}
+
+	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Plugin index '%1' has %2 entries\n", path, _entries.size ()));
+}
+
+int
+PluginIndex::save ()
+{
+	bool modified = _dirty;
+
+	for (std::map<string, Entry>::const_iterator i = _entries.begin (); i != _entries.end () && !modified; ++i) {
+		modified = !i->second.used;
+	}
+
+	if (!modified || _path.empty ()) {
+		return 0;
+	}
+
+	string   buf (index_magic, sizeof (index_magic));
+	uint32_t n = 0;
+
+	put_u32 (buf, index_bom);
+	put_u32 (buf, 0); /* number of entries, set below */
+
+	for (std::map<string, Entry>::const_iterator i = _entries.begin (); i != _entries.end (); ++i) {
+		if (!i->second.used) {
+			continue;
+		}
+		put_str (buf, i->first);
+		put_i64 (buf, i->second.mtime);
+		put_i64 (buf, i->second.size);
+		put_u32 (buf, i->second.length ());
+		buf.append (i->second.data (), i->second.length ());
+		++n;
+	}
+
+	memcpy (&buf[sizeof (index_magic) + sizeof (index_bom)], &n, sizeof (n));
+
+	/* the new file replaces the mapped one */
+	string const path (_path);
+	unmap ();
+
+	try {
+		Glib::file_set_contents (path, buf);
+	} catch (Glib::Error const& e) {
+		error << string_compose (_("Cannot write plugin index '%1' (%2)"), path, e.what ()) << endmsg;
+		::g_unlink (path.c_str ());
+		load (path);
+		return -1;
+	}
+
+	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Wrote plugin index '%1' with %2 entries\n", path, n));
+
+	load (path);
+	return 0;
+}
+
+bool
+PluginIndex::read (string const& cache_file, XMLTree& tree, bool reparse)
+{
+	GStatBuf sb;
+
+	if (g_stat (cache_file.c_str (), &sb)) {
+		return false;
+	}
+
+	std::map<string, Entry>::iterator i = _entries.find (cache_file);
+
+	if (!reparse && i != _entries.end () && i->second.mtime == (int64_t) sb.st_mtime && i->second.size == (int64_t) sb.st_size) {
+		char const* pos  = i->second.data ();
+		XMLNode*    root = decode (pos, pos + i->second.length ());
+		if (root) {
+			i->second.used = true;
+			delete tree.root ();
+			tree.set_root (root);
+			return true;
+		}
+	}
+
+	++_n_parsed;
+
+	if (!tree.read (cache_file)) {
+		if (i != _entries.end ()) {
+			_entries.erase (i);
+			_dirty = true;
+		}
+		return false;
+	}
+
+	Entry e;
+	e.mtime = sb.st_mtime;
+	e.size  = sb.st_size;
+	e.used  = true;
+	encode (*tree.root (), e.owned);
+
+	_entries[cache_file] = e;
+	_dirty = true;
+
+	return true;
+}
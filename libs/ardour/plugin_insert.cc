@@ -36,6 +36,7 @@
 #include "ardour/audio_buffer.h"
 #include "ardour/automation_list.h"
 #include "ardour/buffer_set.h"
+#include "ardour/dB.h"
 #include "ardour/debug.h"
 #include "ardour/event_type_map.h"
 #include "ardour/ladspa_plugin.h"
@@ -44,6 +45,9 @@
 #include "ardour/plugin.h"
 #include "ardour/plugin_insert.h"
 #include "ardour/port.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/rt_tasklist.h"
+#include "ardour/runtime_functions.h"
 
 #ifdef WINDOWS_VST_SUPPORT
 #include "ardour/windows_vst_plugin.h"
@@ -91,9 +95,18 @@ PluginInsert::PluginInsert (Session& s, Temporal::TimeDomain td, boost::shared_p
 	, _latency_changed (false)
 	, _bypass_port (UINT32_MAX)
 	, _inverted_bypass_enable (false)
+	, _silent_samples (0)
+	, _asleep (false)
+	, _parallel_instances (false)
+	, _ran_parallel (false)
+	, _run_cost (0)
 {
 	g_atomic_int_set (&_stat_reset, 0);
 	g_atomic_int_set (&_flush, 0);
+	g_atomic_int_set (&_wake, 0);
+	g_atomic_int_set (&_instance_failed, 0);
+
+	_run_instance = boost::bind (&PluginInsert::run_instance, this, _1);
 
 	/* the first is the master */
 	if (plug) {
@@ -1101,11 +1114,27 @@ PluginInsert::connect_and_run (BufferSet& bufs, samplepos_t start, samplepos_t e
 		}
 	} else {
 		/* in-place processing */
-		uint32_t pc = 0;
-		for (Plugins::iterator i = _plugins.begin(); i != _plugins.end(); ++i, ++pc) {
-			if ((*i)->connect_and_run(bufs, start, end, speed, in_map.p(pc), out_map.p(pc), nframes, offset)) {
+		const uint32_t threshold = Config->get_plugin_instance_parallel_threshold ();
+		const PBD::microseconds_t instance_cost = _ran_parallel ? _run_cost : _run_cost / _plugins.size ();
+
+		/* Plugin::connect_and_run() may add MIDI events to bufs */
+		_ran_parallel = _parallel_instances && _subtasks && bufs.count ().n_midi () == 0
+			&& threshold > 0 && instance_cost >= threshold && _subtasks->can_process ();
+
+		if (_ran_parallel) {
+			InstanceArgs a = { &bufs, start, end, speed, &in_map, &out_map, nframes, offset };
+			_instance_args = a;
+			_subtasks->process (_plugins.size (), _run_instance);
+			if (g_atomic_int_compare_and_exchange (&_instance_failed, 1, 0)) {
 				deactivate ();
 			}
+		} else {
+			uint32_t pc = 0;
+			for (Plugins::iterator i = _plugins.begin(); i != _plugins.end(); ++i, ++pc) {
+				if ((*i)->connect_and_run(bufs, start, end, speed, in_map.p(pc), out_map.p(pc), nframes, offset)) {
+					deactivate ();
+				}
+			}
 		}
 		// now silence unconnected outputs
 		inplace_silence_unconnected (bufs, _out_map, nframes, offset);
@@ -1144,6 +1173,18 @@ PluginInsert::connect_and_run (BufferSet& bufs, samplepos_t start, samplepos_t e
 	}
 }
 
+/** Process one of the replicated plugin instances, called concurrently
+ * for different instances by connect_and_run()
+ */
+void
+PluginInsert::run_instance (size_t pc)
+{
+	InstanceArgs const& a (_instance_args);
+	if (_plugins[pc]->connect_and_run (*a.bufs, a.start, a.end, a.speed, a.in_map->p (pc), a.out_map->p (pc), a.nframes, a.offset)) {
+		g_atomic_int_set (&_instance_failed, 1);
+	}
+}
+
 void
 PluginInsert::bypass (BufferSet& bufs, pframes_t nframes)
 {
@@ -1318,6 +1359,10 @@ PluginInsert::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 		}
 	}
 
+	if (_pending_active && _active && sleeping (bufs, start_sample, nframes)) {
+		return;
+	}
+
 	if (_pending_active) {
 #if defined MIXBUS && defined NDEBUG
 		if (!is_channelstrip ()) {
@@ -1341,6 +1386,9 @@ PluginInsert::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 #else
 		_timing_stats.update ();
 #endif
+		_run_cost = _timing_stats.elapsed ();
+
+		check_sleep (bufs, nframes);
 
 	} else {
 		_timing_stats.reset ();
@@ -1356,6 +1404,90 @@ PluginInsert::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 	 */
 }
 
+static bool
+audio_is_silent (BufferSet& bufs, uint32_t n_audio, pframes_t nframes)
+{
+	n_audio = std::min (n_audio, bufs.count ().n_audio ());
+	for (uint32_t i = 0; i < n_audio; ++i) {
+		AudioBuffer const& ab (bufs.get_audio (i));
+		/* denormal protection adds a tiny offset to silent input */
+		if (!ab.silent () && compute_peak (ab.data (), nframes, 0) > GAIN_COEFF_SMALL) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Effects, whose input is silent, produce silence once their tail has
+ * ended. Those are not run until the input is no longer silent, or
+ * one of their parameters changed.
+ */
+bool
+PluginInsert::can_sleep () const
+{
+	/* instruments, generators and sidechain-triggered effects can
+	 * produce output from silent audio input.
+	 */
+	return Config->get_plugin_sleep_when_silent ()
+		&& !_sidechain
+		&& _configured_in.n_audio () > 0
+		&& natural_input_streams ().n_midi () == 0
+		&& _signal_analysis_collect_nsamples_max == 0;
+}
+
+/** Called before running the plugin.
+ * @return true if the plugin is asleep, and the output was silenced
+ */
+bool
+PluginInsert::sleeping (BufferSet& bufs, samplepos_t start, pframes_t nframes)
+{
+	if (g_atomic_int_compare_and_exchange (&_wake, 1, 0) || !can_sleep () || !audio_is_silent (bufs, _configured_in.n_audio (), nframes)) {
+		_silent_samples = 0;
+		_asleep         = false;
+		return false;
+	}
+
+	if (!_asleep) {
+		_silent_samples += nframes;
+		return false;
+	}
+
+	bufs.set_count (ChanCount::max (bufs.count (), _configured_out));
+	for (uint32_t i = 0; i < _configured_out.n_audio (); ++i) {
+		bufs.get_audio (i).silence (nframes);
+	}
+
+	/* evaluate automation, a change wakes the plugin up */
+	automation_run (start, nframes, true);
+	_delaybuffers.flush ();
+	return true;
+}
+
+/** Called after the plugin was run on silent input, to put it to sleep
+ * once the input was silent for longer than the plugin's tail and
+ * latency, and the plugin's output is silent.
+ */
+void
+PluginInsert::check_sleep (BufferSet& bufs, pframes_t nframes)
+{
+	if (_silent_samples == 0) {
+		return;
+	}
+
+	samplecnt_t tail = _plugins.front ()->signal_tailtime ();
+
+	if (tail == max_samplecnt) {
+		return;
+	}
+	if (tail < 0) {
+		tail = Config->get_plugin_sleep_tail () * _session.sample_rate () / 1000;
+	}
+
+	if (_silent_samples >= tail + effective_latency ()) {
+		_asleep = audio_is_silent (bufs, _configured_out.n_audio (), nframes);
+	}
+}
+
 void
 PluginInsert::automate_and_run (BufferSet& bufs, samplepos_t start, samplepos_t end, double speed, pframes_t nframes)
 {
@@ -1702,6 +1834,7 @@ PluginInsert::mapping_changed ()
 {
 	PluginMapChanged (); /* EMIT SIGNAL */
 	_no_inplace = check_inplace ();
+	_parallel_instances = check_parallel_instances ();
 	_session.set_dirty();
 }
 
@@ -1792,6 +1925,53 @@ PluginInsert::check_inplace ()
 	return !inplace_ok; // no-inplace
 }
 
+/** Replicated instances can be processed concurrently, if they process
+ * in-place, and no instance writes to a buffer that is used by another one.
+ */
+bool
+PluginInsert::check_parallel_instances () const
+{
+	if (get_count () < 2 || _no_inplace) {
+		return false;
+	}
+	if (natural_input_streams ().n_midi () > 0 || natural_output_streams ().n_midi () > 0) {
+		return false;
+	}
+
+	std::map<uint32_t, uint32_t> writer; // buffer-index -> instance
+
+	for (uint32_t pc = 0; pc < get_count (); ++pc) {
+		for (uint32_t out = 0; out < natural_output_streams ().n_audio (); ++out) {
+			bool valid;
+			uint32_t idx = _out_map.p (pc).get (DataType::AUDIO, out, &valid);
+			if (!valid) {
+				continue;
+			}
+			if (writer.find (idx) != writer.end () && writer[idx] != pc) {
+				return false;
+			}
+			writer[idx] = pc;
+		}
+	}
+
+	for (uint32_t pc = 0; pc < get_count (); ++pc) {
+		for (uint32_t in = 0; in < natural_input_streams ().n_audio (); ++in) {
+			bool valid;
+			uint32_t idx = _in_map.p (pc).get (DataType::AUDIO, in, &valid);
+			if (!valid) {
+				continue;
+			}
+			std::map<uint32_t, uint32_t>::const_iterator w = writer.find (idx);
+			if (w != writer.end () && w->second != pc) {
+				return false;
+			}
+		}
+	}
+
+	DEBUG_TRACE (DEBUG::ChanMapping, string_compose ("%1: %2 instances can be processed in parallel\n", name(), get_count ()));
+	return true;
+}
+
 bool
 PluginInsert::sanitize_maps ()
 {
@@ -2156,6 +2336,11 @@ PluginInsert::configure_io (ChanCount in, ChanCount out)
 	}
 
 	_no_inplace = check_inplace ();
+	_parallel_instances = check_parallel_instances ();
+
+	if (_parallel_instances && !_subtasks && _session.process_graph ()) {
+		_subtasks.reset (new RTSubTasks (_session.process_graph ()));
+	}
 
 	/* only the "noinplace_buffers" thread buffers need to be this large,
 	 * this can be optimized. other buffers are fine with
@@ -2971,6 +3156,10 @@ PluginInsert::PluginControl::actually_set_value (double user_val, PBD::Controlla
 {
 	/* FIXME: probably should be taking out some lock here.. */
 
+	if (user_val != get_value ()) {
+		g_atomic_int_set (&_plugin->_wake, 1);
+	}
+
 	for (Plugins::iterator i = _plugin->_plugins.begin(); i != _plugin->_plugins.end(); ++i) {
 		(*i)->set_parameter (_list->parameter().id(), user_val, 0);
 	}
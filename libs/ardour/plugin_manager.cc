@@ -69,6 +69,7 @@
 #include <glibmm/fileutils.h>
 
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 #include "pbd/file_utils.h"
 #include "pbd/tokenizer.h"
 #include "pbd/whitespace.h"
@@ -82,7 +83,9 @@
 #include "ardour/luaproc.h"
 #include "ardour/lv2_plugin.h"
 #include "ardour/plugin.h"
+#include "ardour/plugin_index.h"
 #include "ardour/plugin_manager.h"
+#include "ardour/plugin_scan_queue.h"
 #include "ardour/rc_configuration.h"
 #include "ardour/search_paths.h"
 
@@ -170,6 +173,8 @@ std::string PluginManager::vst3_scanner_bin_path = "";
 # define AUV2_BLACKLIST  "auv2_blacklist.txt"
 #endif
 
+#define PLUGIN_INDEX "plugin_index.bin"
+
 PluginManager&
 PluginManager::instance()
 {
@@ -193,6 +198,7 @@ PluginManager::PluginManager ()
 	, _cancel_scan_timeout_one (false)
 	, _cancel_scan_timeout_all (false)
 	, _enable_scan_timeout (false)
+	, _plugin_index (new PluginIndex)
 {
 	char* s;
 
@@ -342,6 +348,7 @@ PluginManager::~PluginManager()
 
 	/* do drop VST3 Info in order to release any loaded modules */
 	delete _vst3_plugin_info;
+	delete _plugin_index;
 }
 
 bool
@@ -458,6 +465,7 @@ PluginManager::refresh (bool cache_only)
 	}
 
 	load_scanlog ();
+	_plugin_index->load (Glib::build_filename (ARDOUR::user_cache_directory (), PLUGIN_INDEX));
 
 	DEBUG_TRACE (DEBUG::PluginManager, "PluginManager::refresh\n");
 	reset_scan_cancel_state ();
@@ -595,6 +603,9 @@ PluginManager::refresh (bool cache_only)
 
 	BootMessage (_("Plugin Scan Complete..."));
 
+	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Plugin index: %1 entries, %2 cache files parsed\n", _plugin_index->size (), _plugin_index->n_parsed ()));
+	_plugin_index->save ();
+
 	reset_scan_cancel_state ();
 	PluginScanMessage(X_("closeme"), "", false);
 
@@ -688,6 +699,121 @@ PluginManager::reset_scan_cancel_state (bool single)
 	_enable_scan_timeout     = false;
 }
 
+size_t
+PluginManager::scanner_jobs () const
+{
+	uint32_t n = Config->get_plugin_scan_jobs ();
+	if (n == 0) {
+		n = hardware_concurrency ();
+	}
+	return std::max<uint32_t> (1, n);
+}
+
+int
+PluginManager::scanner_timeout () const
+{
+	if (!_enable_scan_timeout || _cancel_scan_timeout_all) {
+		return 0;
+	}
+	return 1 + Config->get_plugin_scan_timeout (); /* deciseconds */
+}
+
+/** Run all jobs of the current scan queue, while handling the cancel_scan_*
+ * and timeout requests of the user. Since it is not known which of the
+ * concurrently running scanners the user meant, requests for a single plugin
+ * apply to all scanners that are currently running.
+ */
+void
+PluginManager::run_scan_queue (std::string const& type_name)
+{
+	size_t      n_done = 0;
+	std::string last_started;
+
+	while (_scan_queue->process ()) {
+		if (_cancel_scan_all) {
+			_scan_queue->cancel_all ();
+			break;
+		}
+		if (_cancel_scan_one) {
+			_scan_queue->cancel_running ();
+			_cancel_scan_one = false;
+		}
+		if (_cancel_scan_timeout_one) {
+			_scan_queue->skip_timeout_running ();
+			_cancel_scan_timeout_one = false;
+		}
+		_scan_queue->set_timeout (scanner_timeout ());
+
+		if (n_done != _scan_queue->n_done () || last_started != _scan_queue->last_started ()) {
+			n_done       = _scan_queue->n_done ();
+			last_started = _scan_queue->last_started ();
+			ARDOUR::PluginScanMessage (string_compose (_("%1 (%2 / %3)"), type_name, n_done + 1, _scan_queue->n_jobs ()), last_started, !cancelled ());
+		}
+
+		ARDOUR::PluginScanTimeout (_scan_queue->remaining_timeout ());
+		Glib::usleep (100000);
+	}
+}
+
+/** @return true if the scanner for @p path was run by the scan queue */
+bool
+PluginManager::scan_queued (std::string const& path) const
+{
+	if (!_scan_queue) {
+		return false;
+	}
+	switch (_scan_queue->result (path)) {
+		case PluginScanQueue::Pending:
+		case PluginScanQueue::Running:
+			return false;
+		default:
+			break;
+	}
+	return true;
+}
+
+#if (defined WINDOWS_VST_SUPPORT || defined MACVST_SUPPORT || defined LXVST_SUPPORT || defined VST3_SUPPORT)
+/** @return arguments for the vst2/vst3 scanner app to scan @p path */
+static std::vector<std::string>
+scanner_args (std::string const& path)
+{
+	std::vector<std::string> args;
+	args.push_back ("-f");
+	args.push_back (Config->get_verbose_plugin_scan () ? "-v" : "-f");
+	args.push_back (path);
+	return args;
+}
+#endif
+
+/** Add the outcome of a queued scan to the plugin's scan-log,
+ * like run_vst2_scanner_app() and run_vst3_scanner_app() do.
+ * @return true if the scanner completed
+ */
+bool
+PluginManager::scan_queue_result (std::string const& path, PSLEPtr psle) const
+{
+	switch (_scan_queue->result (path)) {
+		case PluginScanQueue::Done:
+			psle->msg (PluginScanLogEntry::OK, _scan_queue->log (path));
+			return true;
+		case PluginScanQueue::Failed:
+			psle->msg (PluginScanLogEntry::Error, _scan_queue->log (path));
+			break;
+		case PluginScanQueue::TimedOut:
+			psle->msg (PluginScanLogEntry::OK, _scan_queue->log (path));
+			psle->msg (PluginScanLogEntry::TimeOut, "Scan Timed Out.");
+			break;
+		case PluginScanQueue::Cancelled:
+			psle->msg (PluginScanLogEntry::OK, _scan_queue->log (path));
+			psle->msg (PluginScanLogEntry::New, "Scan was cancelled.");
+			break;
+		default:
+			assert (0);
+			break;
+	}
+	return false;
+}
+
 void
 PluginManager::clear_vst_cache ()
 {
@@ -1279,7 +1405,7 @@ PluginManager::auv2_discover (AUv2DescStr const& d, bool cache_only)
 	XMLTree tree;
 	if (cache_file.empty ()) {
 		run_scan = true;
-	} else if (tree.read (cache_file)) {
+	} else if (_plugin_index->read (cache_file, tree)) {
 		/* valid cache file was found, now check version */
 		int cf_version = 0;
 		if (!tree.root()->get_property ("version", cf_version) || cf_version < 2) {
@@ -1307,7 +1433,7 @@ PluginManager::auv2_discover (AUv2DescStr const& d, bool cache_only)
 			return -1;
 		}
 		/* re-read cache file */
-		if (!tree.read (cache_file)) {
+		if (!_plugin_index->read (cache_file, tree, true)) {
 			psle->msg (PluginScanLogEntry::Error, string_compose (_("Cannot parse AUv2 cache file '%1' for plugin '%2'"), cache_file, dstr));
 			psle->msg (PluginScanLogEntry::Blacklisted);
 			return -1;
@@ -1512,6 +1638,57 @@ PluginManager::run_vst2_scanner_app (std::string path, PSLEPtr psle) const
 	return true;
 }
 
+/** Run the scanner for all plugins in @p plugin_objects that need to be
+ * scanned, using up to scanner_jobs () concurrent processes. vst2_discover()
+ * later picks up the results.
+ */
+void
+PluginManager::vst2_prescan (std::vector<std::string> const& plugin_objects, bool cache_only)
+{
+	_scan_queue.reset ();
+
+	if (cache_only || cancelled () || vst2_scanner_bin_path.empty () || scanner_jobs () < 2) {
+		return;
+	}
+
+	boost::shared_ptr<PluginScanQueue> queue (new PluginScanQueue (scanner_jobs (), scanner_timeout ()));
+
+	for (vector<string>::const_iterator i = plugin_objects.begin (); i != plugin_objects.end (); ++i) {
+		if (vst2_is_blacklisted (*i) || !vst2_valid_cache_file (*i).empty ()) {
+			continue;
+		}
+		queue->add (*i, vst2_scanner_bin_path, scanner_args (*i));
+	}
+
+	if (queue->n_jobs () < 2) {
+		return;
+	}
+
+	/* blacklist while scanning, in case we crash */
+	PBD::ScopedConnection c;
+	queue->JobStarted.connect_same_thread (c, boost::bind (&vst2_blacklist, _1));
+
+	_scan_queue = queue;
+	run_scan_queue (_("VST2"));
+
+	vector<string> paths (_scan_queue->paths ());
+	for (vector<string>::const_iterator i = paths.begin (); i != paths.end (); ++i) {
+		switch (_scan_queue->result (*i)) {
+			case PluginScanQueue::Pending:
+				break;
+			case PluginScanQueue::TimedOut:
+			case PluginScanQueue::Cancelled:
+				/* may be partially written */
+				g_unlink (vst2_cache_file (*i).c_str ());
+				/* fallthrough */
+			default:
+				/* vst2_discover () blacklists again, until the cache is verified */
+				vst2_whitelist (*i);
+				break;
+		}
+	}
+}
+
 bool
 PluginManager::vst2_plugin (string const& path, PluginType type, VST2Info const& nfo)
 {
@@ -1625,7 +1802,7 @@ PluginManager::vst2_discover (string path, ARDOUR::PluginType type, bool cache_o
 	XMLTree tree;
 	if (cache_file.empty ()) {
 		run_scan = true;
-	} else if (tree.read (cache_file)) {
+	} else if (_plugin_index->read (cache_file, tree)) {
 		/* valid cache file was found, now check version */
 		int cf_version = 0;
 		if (!tree.root()->get_property ("version", cf_version) || cf_version < 1) {
@@ -1636,12 +1813,12 @@ PluginManager::vst2_discover (string path, ARDOUR::PluginType type, bool cache_o
 		run_scan = true;
 	}
 
-	if (!cache_only && run_scan) {
+	if (!cache_only && (run_scan || scan_queued (path))) {
 		/* re/generate cache file */
 		psle->reset ();
 		vst2_blacklist (path);
 
-		if (!run_vst2_scanner_app (path, psle)) {
+		if (scan_queued (path) ? !scan_queue_result (path, psle) : !run_vst2_scanner_app (path, psle)) {
 			return -1;
 		}
 
@@ -1653,7 +1830,7 @@ PluginManager::vst2_discover (string path, ARDOUR::PluginType type, bool cache_o
 			return -1;
 		}
 		/* re-read cache file */
-		if (!tree.read (cache_file)) {
+		if (!_plugin_index->read (cache_file, tree, true)) {
 			psle->msg (PluginScanLogEntry::Error, string_compose (_("Cannot parse VST2 cache file '%1' for plugin '%2'"), cache_file, path));
 			psle->msg (PluginScanLogEntry::Blacklisted);
 			return -1;
@@ -1754,6 +1931,8 @@ PluginManager::windows_vst_discover_from_path (string path, bool cache_only)
 	sort (plugin_objects.begin (), plugin_objects.end ());
 	plugin_objects.erase (unique (plugin_objects.begin (), plugin_objects.end ()), plugin_objects.end ());
 
+	vst2_prescan (plugin_objects, cache_only);
+
 	size_t n = 1;
 	size_t all_modules = plugin_objects.size ();
 	for (x = plugin_objects.begin(); x != plugin_objects.end (); ++x, ++n) {
@@ -1762,6 +1941,8 @@ PluginManager::windows_vst_discover_from_path (string path, bool cache_only)
 		vst2_discover (*x, Windows_VST, cache_only || cancelled());
 	}
 
+	_scan_queue.reset ();
+
 	return ret;
 }
 #endif // WINDOWS_VST_SUPPORT
@@ -1837,6 +2018,8 @@ PluginManager::mac_vst_discover_from_path (string path, bool cache_only)
 	sort (plugin_objects.begin (), plugin_objects.end ());
 	plugin_objects.erase (unique (plugin_objects.begin (), plugin_objects.end ()), plugin_objects.end ());
 
+	vst2_prescan (plugin_objects, cache_only);
+
 	size_t n = 1;
 	size_t all_modules = plugin_objects.size ();
 	for (x = plugin_objects.begin(); x != plugin_objects.end (); ++x, ++n) {
@@ -1845,6 +2028,8 @@ PluginManager::mac_vst_discover_from_path (string path, bool cache_only)
 		vst2_discover (*x, MacVST, cache_only || cancelled());
 	}
 
+	_scan_queue.reset ();
+
 	return 0;
 }
 
@@ -1897,6 +2082,8 @@ PluginManager::lxvst_discover_from_path (string path, bool cache_only)
 	sort (plugin_objects.begin (), plugin_objects.end ());
 	plugin_objects.erase (unique (plugin_objects.begin (), plugin_objects.end ()), plugin_objects.end ());
 
+	vst2_prescan (plugin_objects, cache_only);
+
 	size_t n = 1;
 	size_t all_modules = plugin_objects.size ();
 	for (x = plugin_objects.begin(); x != plugin_objects.end (); ++x, ++n) {
@@ -1905,6 +2092,8 @@ PluginManager::lxvst_discover_from_path (string path, bool cache_only)
 		vst2_discover (*x, LXVST, cache_only || cancelled());
 	}
 
+	_scan_queue.reset ();
+
 	return 0;
 }
 
@@ -2047,6 +2236,8 @@ PluginManager::vst3_discover_from_path (string const& path, bool cache_only)
 
 	find_paths_matching_filter (plugin_objects, paths, vst3_filter, 0, false, true, true);
 
+	vst3_prescan (plugin_objects, cache_only);
+
 	size_t n = 1;
 	size_t all_modules = plugin_objects.size ();
 	for (vector<string>::iterator i = plugin_objects.begin(); i != plugin_objects.end (); ++i, ++n) {
@@ -2055,6 +2246,8 @@ PluginManager::vst3_discover_from_path (string const& path, bool cache_only)
 		vst3_discover (*i, cache_only || cancelled ());
 	}
 
+	_scan_queue.reset ();
+
 	return cancelled() ? -1 : 0;
 }
 
@@ -2132,7 +2325,7 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 	XMLTree tree;
 	if (cache_file.empty ()) {
 		run_scan = true;
-	} else if (tree.read (cache_file)) {
+	} else if (_plugin_index->read (cache_file, tree)) {
 		/* valid cache file was found, now check version
 		 * see ARDOUR::vst3_scan_and_cache VST3Cache version
 		 */
@@ -2145,12 +2338,12 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 		run_scan = true;
 	}
 
-	if (!cache_only && run_scan) {
+	if (!cache_only && (run_scan || scan_queued (path))) {
 		/* re/generate cache file */
 		psle->reset ();
 		vst3_blacklist (module_path);
 		psle->msg (PluginScanLogEntry::OK, string_compose ("VST3 module-path '%1'", module_path));
-		if (!run_vst3_scanner_app (path, psle)) {
+		if (scan_queued (path) ? !scan_queue_result (path, psle) : !run_vst3_scanner_app (path, psle)) {
 			return -1;
 		}
 
@@ -2162,7 +2355,7 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 			return -1;
 		}
 		/* re-read cache file */
-		if (!tree.read (cache_file)) {
+		if (!_plugin_index->read (cache_file, tree, true)) {
 			psle->msg (PluginScanLogEntry::Blacklisted);
 			psle->msg (PluginScanLogEntry::Error, string_compose (_("Cannot parse VST3 cache file '%1' for plugin '%2'"), cache_file, module_path));
 			return -1;
@@ -2272,6 +2465,64 @@ PluginManager::run_vst3_scanner_app (std::string bundle_path, PSLEPtr psle) cons
 	return true;
 }
 
+static void vst3_blacklist_bundle (std::string bundle_path)
+{
+	vst3_blacklist (module_path_vst3 (bundle_path));
+}
+
+/** Run the scanner for all bundles in @p plugin_objects that need to be
+ * scanned, using up to scanner_jobs () concurrent processes. vst3_discover()
+ * later picks up the results.
+ */
+void
+PluginManager::vst3_prescan (std::vector<std::string> const& plugin_objects, bool cache_only)
+{
+	_scan_queue.reset ();
+
+	if (cache_only || cancelled () || vst3_scanner_bin_path.empty () || scanner_jobs () < 2) {
+		return;
+	}
+
+	boost::shared_ptr<PluginScanQueue> queue (new PluginScanQueue (scanner_jobs (), scanner_timeout ()));
+
+	for (vector<string>::const_iterator i = plugin_objects.begin (); i != plugin_objects.end (); ++i) {
+		string module_path = module_path_vst3 (*i);
+		if (module_path.empty () || vst3_is_blacklisted (module_path) || !vst3_valid_cache_file (module_path).empty ()) {
+			continue;
+		}
+		queue->add (*i, vst3_scanner_bin_path, scanner_args (*i));
+	}
+
+	if (queue->n_jobs () < 2) {
+		return;
+	}
+
+	/* blacklist while scanning, in case we crash */
+	PBD::ScopedConnection c;
+	queue->JobStarted.connect_same_thread (c, boost::bind (&vst3_blacklist_bundle, _1));
+
+	_scan_queue = queue;
+	run_scan_queue (_("VST3"));
+
+	vector<string> paths (_scan_queue->paths ());
+	for (vector<string>::const_iterator i = paths.begin (); i != paths.end (); ++i) {
+		string module_path = module_path_vst3 (*i);
+		switch (_scan_queue->result (*i)) {
+			case PluginScanQueue::Pending:
+				break;
+			case PluginScanQueue::TimedOut:
+			case PluginScanQueue::Cancelled:
+				/* may be partially written */
+				g_unlink (vst3_cache_file (module_path).c_str ());
+				/* fallthrough */
+			default:
+				/* vst3_discover () blacklists again, until the cache is verified */
+				vst3_whitelist (module_path);
+				break;
+		}
+	}
+}
+
 #endif // VST3_SUPPORT
 
 PluginManager::PluginStatusType
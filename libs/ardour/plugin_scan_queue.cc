@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <boost/bind.hpp>
+
+#include "pbd/compose.h"
+
+#include "ardour/debug.h"
+#include "ardour/plugin_scan_queue.h"
+#include "ardour/system_exec.h"
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+using std::string;
+
+PluginScanQueue::PluginScanQueue (size_t max_jobs, int timeout)
+	: _max_jobs (std::max<size_t> (1, max_jobs))
+	, _timeout (timeout)
+	, _n_done (0)
+	, _max_concurrency (0)
+{
+}
+
+PluginScanQueue::~PluginScanQueue ()
+{
+	cancel_all ();
+}
+
+void
+PluginScanQueue::add (string const& path, string const& command, std::vector<string> const& args)
+{
+	if (_jobs.find (path) != _jobs.end ()) {
+		return;
+	}
+	JobPtr job (new Job (path, command, args));
+	_jobs[path] = job;
+	_pending.push_back (job);
+}
+
+void
+PluginScanQueue::job_output (string msg, Job* job)
+{
+	/* called from the SystemExec reader thread */
+	Glib::Threads::Mutex::Lock lm (_log_lock);
+	job->log += msg;
+}
+
+void
+PluginScanQueue::start (JobPtr job)
+{
+	char** argp = (char**) calloc (job->args.size () + 2, sizeof (char*));
+	argp[0] = strdup (job->command.c_str ());
+	for (size_t i = 0; i < job->args.size (); ++i) {
+		argp[i + 1] = strdup (job->args[i].c_str ());
+	}
+
+	job->exec.reset (new ARDOUR::SystemExec (job->command, argp));
+	job->exec->ReadStdout.connect_same_thread (job->output_connection, boost::bind (&PluginScanQueue::job_output, this, _1, job.get ()));
+
+	_last_started = job->path;
+	JobStarted (job->path); /* EMIT SIGNAL */
+
+	if (job->exec->start (ARDOUR::SystemExec::MergeWithStdin)) {
+		job->log = string_compose (_("Cannot launch VST scanner app '%1': %2"), job->command, strerror (errno));
+		finish (job, Failed);
+		return;
+	}
+
+	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Scanner job started for '%1'\n", job->path));
+
+	job->result  = Running;
+	job->timeout = _timeout > 0 ? _timeout : -1;
+	_running.push_back (job);
+	_max_concurrency = std::max (_max_concurrency, _running.size ());
+}
+
+void
+PluginScanQueue::finish (JobPtr job, Result result)
+{
+	if (job->exec) {
+		/* this also waits for the reader thread, so the log is complete */
+		job->exec->terminate ();
+		job->output_connection.disconnect ();
+		job->exec.reset ();
+	}
+	job->result = result;
+	++_n_done;
+
+	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Scanner job finished for '%1' (%2)\n", job->path, result));
+}
+
+bool
+PluginScanQueue::process ()
+{
+	for (std::list<JobPtr>::iterator i = _running.begin (); i != _running.end ();) {
+		JobPtr job (*i);
+
+		if (!job->exec->is_running ()) {
+			i = _running.erase (i);
+			finish (job, Done);
+			continue;
+		}
+
+		if (job->timeout > -864000) {
+			--job->timeout;
+		}
+
+		if (_timeout > 0 && !job->notime && job->timeout <= 0) {
+			i = _running.erase (i);
+			finish (job, TimedOut);
+			continue;
+		}
+		++i;
+	}
+
+	while (_running.size () < _max_jobs && !_pending.empty ()) {
+		JobPtr job (_pending.front ());
+		_pending.pop_front ();
+		start (job);
+	}
+
+	return !_running.empty () || !_pending.empty ();
+}
+
+void
+PluginScanQueue::set_timeout (int timeout)
+{
+	if (timeout == _timeout) {
+		return;
+	}
+	for (std::list<JobPtr>::iterator i = _running.begin (); i != _running.end (); ++i) {
+		if (timeout > 0 && _timeout <= 0) {
+			(*i)->timeout = timeout;
+		} else if (timeout <= 0 && (*i)->timeout > 0) {
+			(*i)->timeout = -1;
+		}
+	}
+	_timeout = timeout;
+}
+
+void
+PluginScanQueue::skip_timeout_running ()
+{
+	for (std::list<JobPtr>::iterator i = _running.begin (); i != _running.end (); ++i) {
+		if (!(*i)->notime) {
+			(*i)->notime  = true;
+			(*i)->timeout = -1;
+		}
+	}
+}
+
+void
+PluginScanQueue::cancel_running ()
+{
+	while (!_running.empty ()) {
+		JobPtr job (_running.front ());
+		_running.pop_front ();
+		finish (job, Cancelled);
+	}
+}
+
+void
+PluginScanQueue::cancel_all ()
+{
+	cancel_running ();
+	_pending.clear ();
+}
+
+int
+PluginScanQueue::remaining_timeout () const
+{
+	if (_running.empty ()) {
+		return 0;
+	}
+
+	int  rv          = 0;
+	bool can_timeout = false;
+
+	for (std::list<JobPtr>::const_iterator i = _running.begin (); i != _running.end (); ++i) {
+		if (_timeout > 0 && !(*i)->notime) {
+			rv = can_timeout ? std::min (rv, (*i)->timeout) : (*i)->timeout;
+			can_timeout = true;
+		}
+	}
+
+	if (!can_timeout) {
+		/* the oldest job has counted down the furthest */
+		rv = _running.front ()->timeout;
+	}
+	return rv;
+}
+
+PluginScanQueue::Result
+PluginScanQueue::result (string const& path) const
+{
+	std::map<string, JobPtr>::const_iterator i = _jobs.find (path);
+	if (i == _jobs.end ()) {
+		return Pending;
+	}
+	return i->second->result;
+}
+
+string
+PluginScanQueue::log (string const& path) const
+{
+	std::map<string, JobPtr>::const_iterator i = _jobs.find (path);
+	if (i == _jobs.end ()) {
+		return "";
+	}
+	Glib::Threads::Mutex::Lock lm (_log_lock);
+	return i->second->log;
+}
+
+std::vector<string>
+PluginScanQueue::paths () const
+{
+	std::vector<string> rv;
+	for (std::map<string, JobPtr>::const_iterator i = _jobs.begin (); i != _jobs.end (); ++i) {
+		rv.push_back (i->first);
+	}
+	return rv;
+}
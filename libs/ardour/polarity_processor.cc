@@ -73,6 +73,25 @@ PolarityProcessor::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos
 	}
 }
 
+/** Prepare to have the gain of each channel applied by the route instead of run().
+ *  @return false if the polarity of a channel is changing, run() has to be used then.
+ */
+bool
+PolarityProcessor::fuse (uint32_t n_audio)
+{
+	assert (n_audio <= _current_gain.size());
+
+	bool const active = check_active ();
+
+	for (uint32_t chn = 0; chn < n_audio; ++chn) {
+		gain_t const target = (active && _control->inverted (chn)) ? -1.f : 1.f;
+		if (_current_gain[chn] != target) {
+			return false;
+		}
+	}
+	return true;
+}
+
 XMLNode&
 PolarityProcessor::state () const
 {
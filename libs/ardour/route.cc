@@ -81,6 +81,7 @@
 #include "ardour/panner_shell.h"
 #include "ardour/parameter_descriptor.h"
 #include "ardour/phase_control.h"
+#include "ardour/pipeline_stage.h"
 #include "ardour/plugin_insert.h"
 #include "ardour/plugin_manager.h"
 #include "ardour/polarity_processor.h"
@@ -91,6 +92,7 @@
 #include "ardour/revision.h"
 #include "ardour/route.h"
 #include "ardour/route_group.h"
+#include "ardour/rt_tasklist.h"
 #include "ardour/send.h"
 #include "ardour/session.h"
 #include "ardour/solo_control.h"
@@ -131,6 +133,7 @@ Route::Route (Session& sess, string name, PresentationInfo::Flag flag, DataType
 	, _volume_applies_to_output (true)
 	, _track_number (0)
 	, _strict_io (false)
+	, _pipelined (false)
 	, _in_configure_processors (false)
 	, _initial_io_setup (false)
 	, _in_sidechain_setup (false)
@@ -138,9 +141,12 @@ Route::Route (Session& sess, string name, PresentationInfo::Flag flag, DataType
 	, _custom_meter_position_noted (false)
 	, _pinmgr_proxy (0)
 	, _patch_selector_dialog (0)
+	, _pipeline_latency (0)
 {
 	processor_max_streams.reset();
 
+	_run_pipeline_stage = boost::bind (&Route::run_pipeline_stage, this, _1);
+
 	g_atomic_int_set (&_pending_process_reorder, 0);
 	g_atomic_int_set (&_pending_listen_change, 0);
 	g_atomic_int_set (&_pending_signals, 0);
@@ -223,6 +229,10 @@ Route::init ()
 		_delayline.reset (new DelayLine (_session, name ()));
 	}
 
+	if (!is_monitor() && !is_auditioner()) {
+		_pipeline.reset (new PipelineStage (_session, name ()));
+	}
+
 	/* and input trim */
 
 	_trim.reset (new Amp (_session, X_("Trim"), _trim_control, false));
@@ -482,9 +492,80 @@ Route::process_output_buffers (BufferSet& bufs,
 	   and go ....
 	   ----------------------------------------------------------------------------------------- */
 
+	ProcessArgs args = { &bufs, start_sample, end_sample, speed, nframes, ms, run_disk_reader, run_disk_writer };
+
+	ProcessorList::const_iterator stage = _processors.end ();
+	if (_pipeline && _pipeline->can_split () && _pipeline_tasks && _pipeline_tasks->can_process ()) {
+		stage = find (_processors.begin (), _processors.end (), _pipeline);
+	}
+
+	if (stage == _processors.end ()) {
+		run_processors (args, _processors.begin (), _processors.end (), 0);
+		return;
+	}
+
+	/* The second stage processes the output of the previous cycle,
+	 * its latency offset includes the stage's latency.
+	 */
 	samplecnt_t latency = 0;
+	for (ProcessorList::const_iterator i = _processors.begin (); i != _processors.end (); ++i) {
+		if ((*i)->active ()) {
+			if (speed < 0) {
+				latency -= (*i)->effective_latency ();
+			} else {
+				latency += (*i)->effective_latency ();
+			}
+		}
+		if (i == stage) {
+			break;
+		}
+	}
 
-	for (ProcessorList::const_iterator i = _processors.begin(); i != _processors.end(); ++i) {
+	_pipeline_args    = args;
+	_pipeline_pos     = stage;
+	_pipeline_latency = latency;
+
+	_pipeline_tasks->process (2, _run_pipeline_stage);
+	_pipeline->advance (nframes);
+}
+
+/** Process the stages of a pipelined route, called concurrently for
+ * both stages by process_output_buffers()
+ */
+void
+Route::run_pipeline_stage (size_t n)
+{
+	ProcessArgs const& a (_pipeline_args);
+	if (n == 0) {
+		run_processors (a, _processors.begin (), _pipeline_pos, 0);
+		_pipeline->write (*a.bufs, a.nframes);
+	} else {
+		ProcessArgs b (a);
+		b.bufs = &_pipeline_bufs;
+		_pipeline_bufs.set_count (_pipeline->output_streams ());
+		_pipeline->read (_pipeline_bufs, a.nframes);
+		ProcessorList::const_iterator i = _pipeline_pos;
+		run_processors (b, ++i, _processors.end (), _pipeline_latency);
+	}
+}
+
+/** Run processors [@p first, @p last) of the signal path */
+void
+Route::run_processors (ProcessArgs const& a, ProcessorList::const_iterator first, ProcessorList::const_iterator last, samplecnt_t latency)
+{
+	BufferSet&        bufs (*a.bufs);
+	samplepos_t const start_sample = a.start_sample;
+	samplepos_t const end_sample   = a.end_sample;
+	double const      speed        = a.speed;
+	pframes_t const   nframes      = a.nframes;
+
+	for (ProcessorList::const_iterator i = first; i != last; ++i) {
+
+		if (!_fused_gain_stages.empty () && *i == _fused_gain_stages.front () && run_fused_gain_stages (bufs, i, last, nframes)) {
+			/* gain stages have no latency */
+			bufs.set_count ((*i)->output_streams());
+			continue;
+		}
 
 		bool re_inject_oob_data = false;
 		if ((*i) == _disk_reader) {
@@ -500,7 +581,7 @@ Route::process_output_buffers (BufferSet& bufs,
 			 * so that it advances its internal buffers (IFF run_disk_reader is true).
 			 *
 			 */
-			if (ms == MonitoringDisk || ms == MonitoringSilence) {
+			if (a.ms == MonitoringDisk || a.ms == MonitoringSilence) {
 				/* this will clear out-of-band data, too (e.g. MIDI-PC, Panic etc.
 				 * OOB data is written at the end of the cycle (nframes - 1),
 				 * and jack does not re-order events, so we push them back later */
@@ -510,7 +591,7 @@ Route::process_output_buffers (BufferSet& bufs,
 		}
 
 		double pspeed = speed;
-		if ((!run_disk_reader && (((*i) == _disk_reader) || ((*i) == _triggerbox))) || (!run_disk_writer && (*i) == _disk_writer)) {
+		if ((!a.run_disk_reader && (((*i) == _disk_reader) || ((*i) == _triggerbox))) || (!a.run_disk_writer && (*i) == _disk_writer)) {
 			/* run with speed 0, no-roll */
 			pspeed = 0;
 		}
@@ -557,6 +638,78 @@ Route::process_output_buffers (BufferSet& bufs,
 	}
 }
 
+/** Apply consecutive gain stages (polarity, trim, fader) in a single pass
+ *  over the buffers, instead of running them one after another.
+ *  @param i the first stage, set to the last stage on success
+ *  @return false if the stages have to be run one by one this cycle
+ */
+bool
+Route::run_fused_gain_stages (BufferSet& bufs, ProcessorList::const_iterator& i, ProcessorList::const_iterator last, pframes_t nframes)
+{
+	/* a pipeline stage may split the chain */
+	ProcessorList::const_iterator end = i;
+	for (auto const& p : _fused_gain_stages) {
+		if (end == last || *end != p) {
+			return false;
+		}
+		++end;
+	}
+
+	if (!apply_fused_gain_stages (bufs, _fused_gain_stages, _session.scratch_automation_buffer (), nframes)) {
+		return false;
+	}
+
+	i = --end;
+	return true;
+}
+
+bool
+Route::apply_fused_gain_stages (BufferSet& bufs, std::vector<boost::shared_ptr<Processor> > const& stages, gain_t* curve, pframes_t nframes)
+{
+	uint32_t const n_audio = bufs.count ().n_audio ();
+
+	/* the fader also scales MIDI velocity */
+	if (n_audio == 0 || bufs.count ().n_midi () > 0) {
+		return false;
+	}
+
+	boost::shared_ptr<PolarityProcessor> polarity;
+	for (auto const& p : stages) {
+		if ((polarity = boost::dynamic_pointer_cast<PolarityProcessor> (p))) {
+			break;
+		}
+	}
+
+	/* nothing is modified until polarity agreed */
+	if (polarity && !polarity->fuse (n_audio)) {
+		return false;
+	}
+
+	bool   have_curve = false;
+	gain_t gain       = GAIN_COEFF_UNITY;
+
+	for (auto const& p : stages) {
+		if (boost::shared_ptr<Amp> amp = boost::dynamic_pointer_cast<Amp> (p)) {
+			amp->fuse (nframes, curve, have_curve, gain);
+		}
+	}
+
+	uint32_t chn = 0;
+	for (BufferSet::audio_iterator b = bufs.audio_begin (); b != bufs.audio_end (); ++b, ++chn) {
+		gain_t const g = polarity ? gain * polarity->fused_gain (chn) : gain;
+		if (have_curve) {
+			Sample* const sp = b->data ();
+			for (pframes_t nx = 0; nx < nframes; ++nx) {
+				sp[nx] *= g * curve[nx];
+			}
+		} else {
+			Amp::apply_simple_gain (*b, nframes, g);
+		}
+	}
+
+	return true;
+}
+
 void
 Route::bounce_process (BufferSet& buffers, samplepos_t start, samplecnt_t nframes,
 		boost::shared_ptr<Processor> endpoint,
@@ -609,9 +762,9 @@ Route::bounce_process (BufferSet& buffers, samplepos_t start, samplecnt_t nframe
 		}
 
 		/* don't run any processors that do routing.
-		 * Also don't bother with metering.
+		 * Also don't bother with metering, nor with pipeline stages.
 		 */
-		if (!(*i)->does_routing() && !boost::dynamic_pointer_cast<PeakMeter>(*i)) {
+		if (!(*i)->does_routing() && !boost::dynamic_pointer_cast<PeakMeter>(*i) && (*i) != _pipeline) {
 			(*i)->run (buffers, start - latency, start - latency + nframes, 1.0, nframes, true);
 			buffers.set_count ((*i)->output_streams());
 			latency += (*i)->effective_latency ();
@@ -646,7 +799,7 @@ Route::bounce_get_latency (boost::shared_ptr<Processor> endpoint,
 		if (!for_export && !can_freeze_processor (*i, !for_freeze)) {
 			break;
 		}
-		if (!(*i)->does_routing() && !boost::dynamic_pointer_cast<PeakMeter>(*i)) {
+		if (!(*i)->does_routing() && !boost::dynamic_pointer_cast<PeakMeter>(*i) && (*i) != _pipeline) {
 			latency += (*i)->effective_latency ();
 		}
 		if ((*i) == endpoint) {
@@ -1427,7 +1580,7 @@ Route::clear_processors (Placement p)
 bool
 Route::is_internal_processor (boost::shared_ptr<Processor> p) const
 {
-	if (p == _amp || p == _meter || p == _main_outs || p == _delayline || p == _trim || p == _polarity || (_volume && p == _volume) || (_triggerbox && p == _triggerbox)) {
+	if (p == _amp || p == _meter || p == _main_outs || p == _delayline || p == _pipeline || p == _trim || p == _polarity || (_volume && p == _volume) || (_triggerbox && p == _triggerbox)) {
 		return true;
 	}
 #ifdef MIXBUS
@@ -2020,6 +2173,13 @@ Route::configure_processors_unlocked (ProcessorStreams* err, Glib::Threads::RWLo
 	*/
 	_session.ensure_buffers (n_process_buffers ());
 
+	if (_pipeline && find (_processors.begin (), _processors.end (), _pipeline) != _processors.end ()) {
+		_pipeline_bufs.ensure_buffers (n_process_buffers (), _session.get_block_size ());
+		if (!_pipeline_tasks && _session.process_graph ()) {
+			_pipeline_tasks.reset (new RTSubTasks (_session.process_graph ()));
+		}
+	}
+
 	DEBUG_TRACE (DEBUG::Processors, string_compose ("%1: configuration complete\n", _name));
 
 	_in_configure_processors = false;
@@ -2519,6 +2679,25 @@ Route::set_strict_io (const bool enable)
 	return true;
 }
 
+void
+Route::set_pipelined (bool yn)
+{
+	if (_pipelined == yn || !_pipeline) {
+		return;
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lx (AudioEngine::instance()->process_lock ());
+		_pipelined = yn;
+		/* add or remove the pipeline stage */
+		configure_processors (0);
+	}
+
+	/* this also updates latency compensation */
+	processors_changed (RouteProcessorChange ()); /* EMIT SIGNAL */
+	_session.set_dirty ();
+}
+
 XMLNode&
 Route::get_state() const
 {
@@ -2559,6 +2738,7 @@ Route::state (bool save_template) const
 	node->set_property (X_("name"), name());
 	node->set_property (X_("default-type"), _default_type);
 	node->set_property (X_("strict-io"), _strict_io);
+	node->set_property (X_("pipelined"), _pipelined);
 
 	if (is_master ()) {
 		node->set_property (X_("volume-applies-to-output"), _volume_applies_to_output);
@@ -2608,7 +2788,7 @@ Route::state (bool save_template) const
 	{
 		Glib::Threads::RWLock::ReaderLock lm (_processor_lock);
 		for (auto const & p : _processors) {
-			if (p == _delayline) {
+			if (p == _delayline || p == _pipeline) {
 				continue;
 			}
 			if (save_template) {
@@ -2699,6 +2879,7 @@ Route::set_state (const XMLNode& node, int version)
 	}
 
 	node.get_property (X_("strict-io"), _strict_io);
+	node.get_property (X_("pipelined"), _pipelined);
 
 	if (is_monitor()) {
 		/* monitor bus does not get a panner, but if (re)created
@@ -2870,6 +3051,9 @@ Route::set_state (const XMLNode& node, int version)
 	if (_delayline) {
 		_delayline->set_name (name ());
 	}
+	if (_pipeline) {
+		_pipeline->set_name (name ());
+	}
 
 	return 0;
 }
@@ -3204,6 +3388,10 @@ Route::set_processor_state (const XMLNode& node, int version)
 		if (_delayline) {
 			must_configure |= find (_processors.begin(), _processors.end(), _delayline) == _processors.end ();
 		}
+		if (_pipeline && _pipelined) {
+			/* the stage's position depends on the order of plugins */
+			must_configure = true;
+		}
 		if (_intreturn) {
 			must_configure |= find (_processors.begin(), _processors.end(), _intreturn) == _processors.end ();
 		}
@@ -4502,6 +4690,10 @@ Route::set_block_size (pframes_t nframes)
 	}
 
 	_session.ensure_buffers (n_process_buffers ());
+
+	if (_pipeline_tasks) {
+		_pipeline_bufs.ensure_buffers (n_process_buffers (), nframes);
+	}
 }
 
 void
@@ -5406,8 +5598,44 @@ Route::setup_invisible_processors ()
 		}
 	}
 
+	/* PIPELINE STAGE */
+	if (_pipeline && _pipelined) {
+		/* split the plugins after the disk-reader (if any) in half */
+		ProcessorList::iterator i = find (new_processors.begin(), new_processors.end(), _disk_reader);
+		i = (i == new_processors.end()) ? new_processors.begin() : ++i;
+
+		std::vector<ProcessorList::iterator> plugins;
+		for (; i != new_processors.end(); ++i) {
+			if (boost::dynamic_pointer_cast<PluginInsert> (*i)) {
+				plugins.push_back (i);
+			}
+		}
+		if (plugins.size () > 1) {
+			/* insert after the last plugin of the first half */
+			ProcessorList::iterator stage_pos = plugins[(plugins.size () - 1) / 2];
+			new_processors.insert (++stage_pos, _pipeline);
+		}
+	}
+
 	_processors = new_processors;
 
+	/* Consecutive gain stages without a meter or send between them
+	 * are applied in a single pass, see run_fused_gain_stages().
+	 */
+	_fused_gain_stages.clear ();
+	for (ProcessorList::iterator i = _processors.begin(); i != _processors.end(); ++i) {
+		if (*i == _polarity || *i == _trim || *i == _amp) {
+			_fused_gain_stages.push_back (*i);
+		} else if (_fused_gain_stages.size () > 1) {
+			break;
+		} else {
+			_fused_gain_stages.clear ();
+		}
+	}
+	if (_fused_gain_stages.size () < 2) {
+		_fused_gain_stages.clear ();
+	}
+
 	for (ProcessorList::iterator i = _processors.begin(); i != _processors.end(); ++i) {
 		if (!(*i)->display_to_user () && !(*i)->enabled () && (*i) != _monitor_send) {
 			(*i)->enable (true);
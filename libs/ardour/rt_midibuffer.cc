@@ -39,6 +39,7 @@ RTMidiBuffer::RTMidiBuffer ()
 	, _data (0)
 	, _reversed (false)
 	, _pool_size (0)
+	, _pool_garbage (0)
 	, _pool_capacity (0)
 	, _pool (0)
 {
@@ -369,6 +370,97 @@ RTMidiBuffer::read (MidiBuffer& dst, samplepos_t start, samplepos_t end, MidiNot
 	return count;
 }
 
+void
+RTMidiBuffer::splice (TimeType start, TimeType end, RTMidiBuffer const & src)
+{
+	assert (!_reversed);
+	assert (start <= end);
+
+	Item foo;
+	Item* iend = _data + _size;
+
+	foo.timestamp = start;
+	Item* first = lower_bound (_data, iend, foo, item_item_earlier);
+	foo.timestamp = end;
+	Item* last = upper_bound (first, iend, foo, item_item_earlier);
+
+	const size_t first_index = first - _data;
+	const size_t removed     = last - first;
+	const size_t tail        = iend - last;
+	const size_t new_size    = _size - removed + src._size;
+
+	/* blobs referenced by the removed items stay in the pool until it is
+	 * compacted (see below).
+	 */
+
+	for (Item const * i = first; i != last; ++i) {
+		if (i->bytes[0]) {
+			uint32_t offset = i->offset & ~(1<<(CHAR_BIT-1));
+			_pool_garbage += reinterpret_cast<Blob const *> (&_pool[offset])->size;
+		}
+	}
+
+	if (new_size >= _capacity) {
+		resize (new_size + 1024); // XXX 1024 is completely arbitrary, see ::write()
+	}
+
+	/* move the tail into place, then copy the new events into the gap */
+
+	if (tail && removed != src._size) {
+		memmove (&_data[first_index + src._size], &_data[first_index + removed], tail * sizeof (Item));
+	}
+
+	for (size_t n = 0; n < src._size; ++n) {
+
+		Item const & s (src._data[n]);
+		Item&        d (_data[first_index + n]);
+
+		assert (s.timestamp >= start && s.timestamp <= end);
+
+		d.timestamp = s.timestamp;
+
+		if (s.bytes[0]) {
+			uint32_t offset = s.offset & ~(1<<(CHAR_BIT-1));
+			Blob const * blob = reinterpret_cast<Blob const *> (&src._pool[offset]);
+			uint32_t off = store_blob (blob->size, blob->data);
+			d.offset = (off | (1<<(CHAR_BIT-1)));
+		} else {
+			d.offset = s.offset;
+		}
+	}
+
+	_size = new_size;
+
+	if (_pool_garbage > _pool_size / 2) {
+		compact_pool ();
+	}
+
+	DEBUG_TRACE (DEBUG::MidiRingBuffer, string_compose ("spliced %1 .. %2: removed %3 added %4, new size %5\n", start, end, removed, src._size, _size));
+}
+
+void
+RTMidiBuffer::compact_pool ()
+{
+	uint8_t* old_pool = _pool;
+
+	_pool          = 0;
+	_pool_size     = 0;
+	_pool_capacity = 0;
+	_pool_garbage  = 0;
+
+	for (size_t n = 0; n < _size; ++n) {
+		Item& item (_data[n]);
+		if (item.bytes[0]) {
+			uint32_t offset = item.offset & ~(1<<(CHAR_BIT-1));
+			Blob* blob = reinterpret_cast<Blob*> (&old_pool[offset]);
+			uint32_t off = store_blob (blob->size, blob->data);
+			item.offset = (off | (1<<(CHAR_BIT-1)));
+		}
+	}
+
+	cache_aligned_free (old_pool);
+}
+
 uint32_t
 RTMidiBuffer::alloc_blob (uint32_t size)
 {
@@ -412,6 +504,7 @@ RTMidiBuffer::clear ()
 	_size = 0;
 	/* free the entire current pool size, if any */
 	_pool_size = 0;
+	_pool_garbage = 0;
 	/* rendering new data .. it will not be reversed */
 	_reversed = false;
 }
@@ -16,6 +16,12 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+
+#include <sched.h>
+
+#include "pbd/cpus.h"
+
 #include "ardour/graph.h"
 #include "ardour/rt_tasklist.h"
 
@@ -45,3 +51,70 @@ RTTaskList::process ()
 	}
 	_tasks.clear ();
 }
+
+RTSubTasks::RTSubTasks (boost::shared_ptr<Graph> process_graph)
+	: _graph (process_graph)
+	, _f (0)
+	, _n (0)
+{
+	/* one helper for every thread, but the caller */
+	_helpers.resize (std::max<uint32_t> (1, hardware_concurrency ()) - 1, Helper (this));
+	g_atomic_int_set (&_next, 0);
+	g_atomic_int_set (&_pending, 0);
+}
+
+bool
+RTSubTasks::can_process () const
+{
+	return !_helpers.empty () && _graph->n_threads () > 1 && _graph->n_idle_threads () > 0 && _graph->in_process_thread ();
+}
+
+void
+RTSubTasks::work ()
+{
+	for (;;) {
+		const size_t n = g_atomic_int_add (&_next, 1);
+		if (n >= _n) {
+			break;
+		}
+		(*_f) (n);
+	}
+}
+
+void
+RTSubTasks::Helper::run (GraphChain const*)
+{
+	_parent->work ();
+	g_atomic_int_dec_and_test (&_parent->_pending);
+}
+
+void
+RTSubTasks::process (size_t n, boost::function<void (size_t)> const& f)
+{
+	if (n == 0) {
+		return;
+	}
+
+	_f = &f;
+	_n = n;
+	g_atomic_int_set (&_next, 0);
+
+	const size_t n_helpers = std::min (n - 1, std::min (_helpers.size (), (size_t) _graph->n_threads () - 1));
+	g_atomic_int_set (&_pending, n_helpers);
+
+	for (size_t i = 0; i < n_helpers; ++i) {
+		if (!_graph->dispatch (&_helpers[i])) {
+			g_atomic_int_add (&_pending, -(gint) (n_helpers - i));
+			break;
+		}
+	}
+
+	work ();
+
+	/* helpers refer to this object, wait until all of them ran. */
+	while (g_atomic_int_get (&_pending) > 0) {
+		if (!_graph->run_queued ()) {
+			sched_yield ();
+		}
+	}
+}
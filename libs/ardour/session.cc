@@ -119,6 +119,7 @@
 #include "ardour/solo_isolate_control.h"
 #include "ardour/source_factory.h"
 #include "ardour/speakers.h"
+#include "ardour/state_journal.h"
 #include "ardour/tempo.h"
 #include "ardour/ticker.h"
 #include "ardour/transport_fsm.h"
@@ -244,6 +245,8 @@ Session::Session (AudioEngine &eng,
 	, _state_of_the_state (StateOfTheState (CannotSave | InitialConnecting | Loading))
 	, _save_queued (false)
 	, _save_queued_pending (false)
+	, _save_thread (0)
+	, _state_journal (new StateJournal)
 	, _last_roll_location (0)
 	, _last_roll_or_reversal_location (0)
 	, _last_record_location (0)
@@ -342,6 +345,8 @@ Session::Session (AudioEngine &eng,
 	g_atomic_int_set (&_have_rec_enabled_track, 0);
 	g_atomic_int_set (&_have_rec_disabled_track, 1);
 	g_atomic_int_set (&_latency_recompute_pending, 0);
+	_latency_dirty_all = true;
+	_graph_dirty_all = true;
 	g_atomic_int_set (&_suspend_timecode_transmission, 0);
 	g_atomic_int_set (&_update_pretty_names, 0);
 	g_atomic_int_set (&_seek_counter, 0);
@@ -618,6 +623,10 @@ Session::destroy ()
 	*/
 
 	remove_pending_capture_state ();
+	wait_for_background_save ();
+
+	delete _state_journal;
+	_state_journal = 0;
 
 	Analyser::flush ();
 
@@ -693,7 +702,10 @@ Session::destroy ()
 
 	/* drop GraphNode references */
 	_graph_chain.reset ();
-	_current_route_graph = GraphEdges ();
+	{
+		Glib::Threads::Mutex::Lock lm (_route_graph_lock);
+		_current_route_graph = GraphEdges ();
+	}
 
 	_io_graph_chain[0].reset ();
 	_io_graph_chain[1].reset ();
@@ -2171,7 +2183,7 @@ Session::set_block_size (pframes_t nframes)
 
 
 void
-Session::resort_routes ()
+Session::resort_routes (bool incremental)
 {
 	/* don't do anything here with signals emitted
 	   by Routes during initial setup or while we
@@ -2181,7 +2193,11 @@ Session::resort_routes ()
 	if (inital_connect_or_deletion_in_progress ()) {
 		/* drop any references during delete */
 		GraphEdges edges;
-		_current_route_graph = edges;
+		{
+			Glib::Threads::Mutex::Lock lm (_route_graph_lock);
+			_current_route_graph = edges;
+		}
+		set_graph_dirty ();
 		return;
 	}
 
@@ -2192,7 +2208,7 @@ Session::resort_routes ()
 	{
 		RCUWriter<RouteList> writer (routes);
 		boost::shared_ptr<RouteList> r = writer.get_copy ();
-		resort_routes_using (r);
+		resort_routes_using (r, incremental);
 		/* writer goes out of scope and forces update */
 	}
 
@@ -2213,10 +2229,12 @@ Session::resort_routes ()
 /** This is called whenever we need to rebuild the graph of how we will process
  *  routes.
  *  @param r List of routes, in any order.
+ *  @param incremental only update the edges of routes whose ports were
+ *  (dis)connected, if @p r still has the routes of the last sort.
  */
 
 void
-Session::resort_routes_using (boost::shared_ptr<RouteList> r)
+Session::resort_routes_using (boost::shared_ptr<RouteList> r, bool incremental)
 {
 #ifndef NDEBUG
 	Timing t;
@@ -2227,14 +2245,19 @@ Session::resort_routes_using (boost::shared_ptr<RouteList> r)
 		gnl.push_back (rt);
 	}
 
+	std::set<GraphVertex> changed;
+	bool const partial = take_graph_dirty_routes (r, changed, incremental);
+
 	bool ok = true;
 
-	if (rechain_process_graph (gnl)) {
+	if (partial ? rechain_process_graph (gnl, changed) : rechain_process_graph (gnl)) {
 		/* Update routelist for single-threaded processing, use topologically sorted nodelist */
 		r->clear ();
 		for (auto const& nd : gnl) {
 			r->push_back (boost::dynamic_pointer_cast<Route> (nd));
 		}
+		/* `r' becomes the current route list when the caller's writer goes out of scope */
+		_sorted_routes = r;
 	} else {
 		ok = false;
 	}
@@ -2262,8 +2285,9 @@ Session::resort_routes_using (boost::shared_ptr<RouteList> r)
 #ifndef NDEBUG
 	if (DEBUG_ENABLED(DEBUG::TopologyTiming)) {
 		t.update ();
-		std::cerr << string_compose ("Session::resort_route took %1ms ; DSP %2 %%\n",
-				t.elapsed () / 1000., 100.0 * t.elapsed() / _engine.usecs_per_cycle ());
+		std::cerr << string_compose ("Session::resort_route took %1ms ; DSP %2 %% (%3 of %4 routes updated)\n",
+				t.elapsed () / 1000., 100.0 * t.elapsed() / _engine.usecs_per_cycle (),
+				partial ? changed.size () : r->size (), r->size ());
 
 		DEBUG_TRACE (DEBUG::Graph, "Routes resorted, order follows:\n");
 		for (auto const& i : *r) {
@@ -2314,28 +2338,144 @@ Session::rechain_process_graph (GraphNodeList& g)
 		 * Note: the process graph chain does not require a
 		 * topologically-sorted list, but hey ho.
 		 */
-		if (_process_graph->n_threads () > 1) {
-			/* Ideally we'd use a memory pool to allocate the GraphChain, however node_lists
-			 * inside the change are STL list/set. It was never rt-safe to re-chain the graph.
-			 * Furthermore graph-changes are usually caused by connection changes, which are not
-			 * rt-safe either.
-			 *
-			 * However, the graph-chain may be in use (session process), and the last reference
-			 * be helf by the process-callback. So we delegate deletion to the butler thread.
-			 */
-			_graph_chain = boost::shared_ptr<GraphChain> (new GraphChain (g, edges), boost::bind (&rt_safe_delete<GraphChain>, this, _1));
-		} else {
-			_graph_chain.reset ();
-		}
-
-		_current_route_graph = edges;
-
+		set_process_graph (g, edges);
 		return true;
 	}
 
+	/* the current graph does not reflect the connections anymore */
+	set_graph_dirty ();
 	return false;
 }
 
+/** Update the process graph after the connections of some routes changed.
+ *  @param g List of routes, as sorted for the current graph.
+ *  @param changed Routes whose edges are re-evaluated.
+ */
+bool
+Session::rechain_process_graph (GraphNodeList& g, std::set<GraphVertex> const& changed)
+{
+	GraphEdges edges;
+	bool       edges_changed;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_route_graph_lock);
+		edges = _current_route_graph;
+	}
+
+	if (!topological_sort (g, edges, changed, edges_changed)) {
+		set_graph_dirty ();
+		return false;
+	}
+
+	/* a connection change that does not add or remove an edge (e.g. to
+	 * a hardware port) leaves the current graph-chain valid.
+	 */
+	if (edges_changed) {
+		set_process_graph (g, edges);
+	}
+
+	return true;
+}
+
+void
+Session::set_process_graph (GraphNodeList const& g, GraphEdges const& edges)
+{
+	if (_process_graph->n_threads () > 1) {
+		/* Ideally we'd use a memory pool to allocate the GraphChain, however node_lists
+		 * inside the change are STL list/set. It was never rt-safe to re-chain the graph.
+		 * Furthermore graph-changes are usually caused by connection changes, which are not
+		 * rt-safe either.
+		 *
+		 * However, the graph-chain may be in use (session process), and the last reference
+		 * be helf by the process-callback. So we delegate deletion to the butler thread.
+		 */
+		_graph_chain = boost::shared_ptr<GraphChain> (new GraphChain (g, edges), boost::bind (&rt_safe_delete<GraphChain>, this, _1));
+	} else {
+		_graph_chain.reset ();
+	}
+
+	Glib::Threads::Mutex::Lock lm (_route_graph_lock);
+	_current_route_graph = edges;
+}
+
+void
+Session::port_connected_or_disconnected (boost::weak_ptr<Port> wa, boost::weak_ptr<Port> wb)
+{
+	/* ports that are not ours cannot change how routes feed each other */
+	boost::shared_ptr<Port> a = wa.lock ();
+	boost::shared_ptr<Port> b = wb.lock ();
+
+	{
+		/* the next latency callback is not limited to the routes
+		 * downstream of a latency change any more.
+		 */
+		Glib::Threads::Mutex::Lock lm (_latency_dirty_lock);
+		_latency_subgraph.reset ();
+	}
+
+	if (!a && !b) {
+		return;
+	}
+
+	Glib::Threads::Mutex::Lock lm (_graph_dirty_lock);
+	if (a) {
+		_graph_dirty_ports.push_back (a);
+	}
+	if (b) {
+		_graph_dirty_ports.push_back (b);
+	}
+}
+
+void
+Session::set_graph_dirty ()
+{
+	Glib::Threads::Mutex::Lock lm (_graph_dirty_lock);
+	_graph_dirty_all = true;
+}
+
+/** Find the routes that own ports which were (dis)connected since the last sort.
+ *  @param r the route list that is about to be sorted
+ *  @param changed filled in with the routes to update
+ *  @param incremental false if the whole graph is re-evaluated anyway
+ *  @return false if the whole graph needs to be re-evaluated
+ */
+bool
+Session::take_graph_dirty_routes (boost::shared_ptr<RouteList> r, std::set<GraphVertex>& changed, bool incremental)
+{
+	std::vector<boost::weak_ptr<Port> > ports;
+	bool                                all;
+
+	{
+		Glib::Threads::Mutex::Lock lm (_graph_dirty_lock);
+		ports.swap (_graph_dirty_ports);
+		all = _graph_dirty_all;
+		_graph_dirty_all = false;
+	}
+
+	/* `r' is a copy of the current route list, which differs from the one
+	 * last sorted if routes were added or removed in the meantime.
+	 */
+	if (!incremental || all || routes.reader () != _sorted_routes.lock ()) {
+		return false;
+	}
+
+	for (auto const& wp : ports) {
+		boost::shared_ptr<Port> p = wp.lock ();
+		if (!p) {
+			continue;
+		}
+		for (auto const& rt : *r) {
+			if (rt->all_inputs ().has_port (p) || rt->all_outputs ().has_port (p)) {
+				changed.insert (rt);
+				break;
+			}
+		}
+	}
+
+	/* each changed route costs two tests per route, a full sort one test per pair */
+	return changed.size () * 2 < r->size ();
+}
+
 bool
 Session::rechain_ioplug_graph (bool pre)
 {
@@ -2924,6 +3064,9 @@ Session::new_route_from_template (uint32_t how_many, PresentationInfo::order_t i
 	int version = 3002;
 	node.get_property (X_("version"), version);
 
+	/* restore plugin state of all new routes concurrently */
+	Plugin::DeferredRestore deferred_restore;
+
 	while (how_many) {
 
 		/* We're going to modify the node contents a bit so take a
@@ -3150,6 +3293,8 @@ Session::new_route_from_template (uint32_t how_many, PresentationInfo::order_t i
 	}
 
 	out:
+	deferred_restore.run ();
+
 	if (!ret.empty()) {
 		add_routes (ret, false, false, insert_at);
 	}
@@ -3268,7 +3413,7 @@ Session::add_routes_inner (RouteList& new_routes, bool input_auto_connect, bool
 			r->mute_control()->Changed.connect_same_thread (*this, boost::bind (&Session::route_mute_changed, this));
 
 			r->processors_changed.connect_same_thread (*this, boost::bind (&Session::route_processors_changed, this, _1));
-			r->processor_latency_changed.connect_same_thread (*this, boost::bind (&Session::queue_latency_recompute, this));
+			r->processor_latency_changed.connect_same_thread (*this, boost::bind (&Session::queue_route_latency_recompute, this, wpr));
 
 			if (r->is_master()) {
 				_master_out = r;
@@ -5480,7 +5625,8 @@ Session::graph_reordered (bool called_from_backend)
 		return;
 	}
 
-	resort_routes ();
+	/* the backend reports connection changes before it reorders the graph */
+	resort_routes (called_from_backend);
 
 	/* force all diskstreams to update their capture offset values to
 	 * reflect any changes in latencies within the graph.
@@ -6762,22 +6908,23 @@ Session::update_send_delaylines ()
 }
 
 bool
-Session::update_route_latency (bool playback, bool apply_to_delayline, bool* delayline_update_needed)
+Session::update_route_latency (bool playback, bool apply_to_delayline, RouteList* delayline_update_needed, boost::shared_ptr<RouteList> subgraph)
 {
 	/* apply_to_delayline can no be called concurrently with processing
 	 * caller must hold process lock when apply_to_delayline == true */
 	assert (!apply_to_delayline || !AudioEngine::instance()->process_lock().trylock());
 
-	DEBUG_TRACE (DEBUG::LatencyCompensation , string_compose ("update_route_latency: %1 apply_to_delayline? %2)\n", (playback ? "PLAYBACK" : "CAPTURE"), (apply_to_delayline ? "yes" : "no")));
+	DEBUG_TRACE (DEBUG::LatencyCompensation , string_compose ("update_route_latency: %1 apply_to_delayline? %2) routes: %3\n", (playback ? "PLAYBACK" : "CAPTURE"), (apply_to_delayline ? "yes" : "no"), (subgraph ? string_compose ("%1", subgraph->size ()) : "all")));
 
 	/* Note: RouteList is process-graph sorted */
-	boost::shared_ptr<RouteList> r = routes.reader ();
+	boost::shared_ptr<RouteList> all = routes.reader ();
+	boost::shared_ptr<RouteList> r   = subgraph ? subgraph : all;
 
 	if (playback) {
 		/* reverse the list so that we work backwards from the last route to run to the first,
 		 * this is not needed, but can help to reduce the iterations for aux-sends.
 		 */
-		RouteList* rl = routes.reader().get();
+		RouteList* rl = r.get();
 		r.reset (new RouteList (*rl));
 		reverse (r->begin(), r->end());
 	}
@@ -6791,9 +6938,13 @@ restart:
 	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
 		// if (!(*i)->active()) { continue ; } // TODO
 		samplecnt_t l;
-		if ((*i)->signal_latency () != (l = (*i)->update_signal_latency (apply_to_delayline, delayline_update_needed))) {
+		bool        delayline_changed = false;
+		if ((*i)->signal_latency () != (l = (*i)->update_signal_latency (apply_to_delayline, delayline_update_needed ? &delayline_changed : NULL))) {
 			changed = true;
 		}
+		if (delayline_changed) {
+			delayline_update_needed->push_back (*i);
+		}
 		_worst_route_latency = std::max (l, _worst_route_latency);
 	}
 
@@ -6803,15 +6954,102 @@ restart:
 		 * and then there's JACK */
 		if (++bailout < 5) {
 			cerr << "restarting Session::update_latency. # of send changes: " << _send_latency_changes << " iteration: " << bailout << endl;
+			if (r->size () != all->size ()) {
+				/* send targets may be outside of the subgraph */
+				r = all;
+				if (playback) {
+					r.reset (new RouteList (*all));
+					reverse (r->begin(), r->end());
+				}
+			}
+			if (delayline_update_needed) {
+				delayline_update_needed->clear ();
+			}
 			goto restart;
 		}
 	}
 
+	if (r->size () != all->size ()) {
+		/* the remaining routes are unchanged */
+		for (RouteList::iterator i = all->begin(); i != all->end(); ++i) {
+			_worst_route_latency = std::max ((*i)->signal_latency (), _worst_route_latency);
+		}
+	}
+
 	DEBUG_TRACE (DEBUG::LatencyCompensation , string_compose ("update_route_latency: worst proc latency: %1 (changed? %2) recursions: %3\n", _worst_route_latency, (changed ? "yes" : "no"), bailout));
 
 	return changed;
 }
 
+boost::shared_ptr<RouteList>
+Session::take_latency_dirty_routes (bool incremental)
+{
+	Glib::Threads::Mutex::Lock lm (_latency_dirty_lock);
+
+	boost::shared_ptr<RouteList> dirty;
+
+	if (incremental && !_latency_dirty_all) {
+		std::set<boost::shared_ptr<Route> > seen;
+		boost::shared_ptr<RouteList> r = routes.reader ();
+
+		for (std::vector<boost::weak_ptr<Route> >::const_iterator i = _latency_dirty_routes.begin (); i != _latency_dirty_routes.end (); ++i) {
+			if (boost::shared_ptr<Route> route = i->lock ()) {
+				seen.insert (route);
+			}
+		}
+
+		/* unconnected routes are aligned to the master-bus */
+		if (!_master_out || seen.find (_master_out) == seen.end ()) {
+			dirty.reset (new RouteList);
+			/* keep process-graph order */
+			for (RouteList::const_iterator i = r->begin (); i != r->end (); ++i) {
+				if (seen.find (*i) != seen.end ()) {
+					dirty->push_back (*i);
+				}
+			}
+		}
+	}
+
+	_latency_dirty_routes.clear ();
+	_latency_dirty_all = false;
+
+	return dirty;
+}
+
+boost::shared_ptr<RouteList>
+Session::downstream_routes (RouteList const& changed)
+{
+	std::set<GraphVertex>  fed;
+	std::list<GraphVertex> todo (changed.begin (), changed.end ());
+
+	/* this is called from the auto-connect thread, while
+	 * the graph may be re-sorted concurrently.
+	 */
+	Glib::Threads::Mutex::Lock lm (_route_graph_lock);
+
+	while (!todo.empty ()) {
+		GraphVertex v = todo.front ();
+		todo.pop_front ();
+		if (!fed.insert (v).second) {
+			continue;
+		}
+		std::set<GraphVertex> const f (_current_route_graph.from (v));
+		todo.insert (todo.end (), f.begin (), f.end ());
+	}
+
+	lm.release ();
+
+	boost::shared_ptr<RouteList> r = routes.reader ();
+	boost::shared_ptr<RouteList> rv (new RouteList);
+
+	for (RouteList::const_iterator i = r->begin (); i != r->end (); ++i) {
+		if (fed.find (*i) != fed.end ()) {
+			rv->push_back (*i);
+		}
+	}
+	return rv;
+}
+
 void
 Session::set_owned_port_public_latency (bool playback)
 {
@@ -6899,13 +7137,26 @@ Session::update_latency (bool playback)
 
 	/* Note; RouteList is sorted as process-graph */
 	boost::shared_ptr<RouteList> r = routes.reader ();
+	boost::shared_ptr<RouteList> subgraph;
 
 	if (playback) {
 		/* reverse the list so that we work backwards from the last route to run to the first */
 		RouteList* rl = routes.reader().get();
 		r.reset (new RouteList (*rl));
 		reverse (r->begin(), r->end());
+	} else {
+		/* capture latency only changes downstream of routes whose
+		 * processor latency changed (see update_latency_compensation).
+		 * Playback latency also changes for parallel routes that share
+		 * a source, so that is always updated for the whole graph.
+		 */
+		Glib::Threads::Mutex::Lock lm (_latency_dirty_lock);
+		subgraph.swap (_latency_subgraph);
+		if (subgraph) {
+			r = subgraph;
+		}
 	}
+
 	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
 		/* private port latency includes plugin and I/O delay,
 		 * but no latency compensation delaylines.
@@ -6941,7 +7192,7 @@ Session::update_latency (bool playback)
 		lm.release ();
 		Glib::Threads::Mutex::Lock lx (_update_latency_lock);
 		set_worst_input_latency ();
-		update_route_latency (false, false, NULL);
+		update_route_latency (false, false, NULL, subgraph);
 	}
 
 	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
@@ -6962,8 +7213,8 @@ Session::update_latency (bool playback)
 #ifndef NDEBUG
 	if (DEBUG_ENABLED(DEBUG::TopologyTiming)) {
 		t.update ();
-		std::cerr << string_compose ("Session::update_latency for %1 took %2ms ; DSP %3 %%\n",
-				playback ? "playback" : "capture", t.elapsed () / 1000.,
+		std::cerr << string_compose ("Session::update_latency for %1 of %2 route(s) took %3ms ; DSP %4 %%\n",
+				playback ? "playback" : "capture", r->size (), t.elapsed () / 1000.,
 				100.0 * t.elapsed () / _engine.usecs_per_cycle ());
 	}
 #endif
@@ -7020,10 +7271,13 @@ Session::set_worst_input_latency ()
 }
 
 void
-Session::update_latency_compensation (bool force_whole_graph, bool called_from_backend)
+Session::update_latency_compensation (bool force_whole_graph, bool called_from_backend, bool incremental)
 {
 	/* Called to update Ardour's internal latency values and compensation
 	 * planning. Typically case is from within ::graph_reordered()
+	 *
+	 * With `incremental`, only routes that reported a change of their
+	 * processor latency are updated, if possible.
 	 */
 
 	if (inital_connect_or_deletion_in_progress ()) {
@@ -7038,14 +7292,55 @@ Session::update_latency_compensation (bool force_whole_graph, bool called_from_b
 	 */
 	Glib::Threads::Mutex::Lock lx (_update_latency_lock, Glib::Threads::TRY_LOCK);
 	if (!lx.locked()) {
-		/* no need to do this twice */
+		/* the concurrent run may only be an incremental one, which does
+		 * not cover this request. Leave it to the auto-connect thread
+		 * to do this once the lock is free.
+		 */
+		if (incremental && !force_whole_graph) {
+			/* dirty routes were not taken, retry */
+			g_atomic_int_inc (&_latency_recompute_pending);
+			auto_connect_thread_wakeup ();
+		} else {
+			queue_latency_recompute ();
+		}
 		return;
 	}
 
-	DEBUG_TRACE (DEBUG::LatencyCompensation, string_compose ("update_latency_compensation%1.\n", (force_whole_graph ? " of whole graph" : "")));
+#ifndef NDEBUG
+	Timing t;
+#endif
+
+	boost::shared_ptr<RouteList> dirty = take_latency_dirty_routes (incremental && !force_whole_graph);
+
+	DEBUG_TRACE (DEBUG::LatencyCompensation, string_compose ("update_latency_compensation%1%2.\n", (force_whole_graph ? " of whole graph" : ""), (dirty ? string_compose (" of %1 route(s)", dirty->size ()) : "")));
 
-	bool delayline_update_needed = false;
-	bool some_track_latency_changed = update_route_latency (false, false, &delayline_update_needed);
+	RouteList delayline_update_needed;
+	bool some_track_latency_changed = update_route_latency (false, false, &delayline_update_needed, dirty);
+
+	{
+		/* limit the next capture latency callback to the routes fed by the changed ones.
+		 *
+		 * This must only apply to the callback requested below. JACK also
+		 * calls back after changes of other clients, which cannot be told
+		 * apart, so the whole graph is always updated there. Other backends
+		 * only call back after changes of our own ports, and a connection
+		 * change drops the subgraph (see port_connected_or_disconnected).
+		 */
+		boost::shared_ptr<RouteList> subgraph;
+		if (dirty && some_track_latency_changed && !force_whole_graph && !called_from_backend && _engine.current_backend_name () != X_("JACK")) {
+			subgraph = downstream_routes (*dirty);
+		}
+		Glib::Threads::Mutex::Lock lm (_latency_dirty_lock);
+		_latency_subgraph = subgraph;
+	}
+
+#ifndef NDEBUG
+	if (DEBUG_ENABLED(DEBUG::TopologyTiming)) {
+		t.update ();
+		std::cerr << string_compose ("Session::update_latency_compensation of %1 route(s) took %2ms\n",
+				dirty ? dirty->size () : routes.reader ()->size (), t.elapsed () / 1000.);
+	}
+#endif
 
 	if (some_track_latency_changed || force_whole_graph)  {
 
@@ -7078,16 +7373,15 @@ Session::update_latency_compensation (bool force_whole_graph, bool called_from_b
 		} else {
 			DEBUG_TRACE (DEBUG::LatencyCompensation, "update_latency_compensation called from engine, don't call back into engine\n");
 		}
-	} else if (delayline_update_needed) {
-		DEBUG_TRACE (DEBUG::LatencyCompensation, "update_latency_compensation: directly apply to routes\n");
+	} else if (!delayline_update_needed.empty ()) {
+		DEBUG_TRACE (DEBUG::LatencyCompensation, string_compose ("update_latency_compensation: directly apply to %1 route(s)\n", delayline_update_needed.size ()));
 		lx.release (); // XXX cannot hold this lock when acquiring process_lock ?!
 #ifndef MIXBUS
 		Glib::Threads::Mutex::Lock lm (AudioEngine::instance()->process_lock (), Glib::Threads::NOT_LOCK);
 #endif
 		lm.acquire ();
 
-		boost::shared_ptr<RouteList> r = routes.reader ();
-		for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+		for (RouteList::iterator i = delayline_update_needed.begin(); i != delayline_update_needed.end(); ++i) {
 			(*i)->apply_latency_compensation ();
 		}
 	}
@@ -7221,6 +7515,21 @@ Session::auto_connect_thread_wakeup ()
 void
 Session::queue_latency_recompute ()
 {
+	{
+		Glib::Threads::Mutex::Lock lm (_latency_dirty_lock);
+		_latency_dirty_all = true;
+	}
+	g_atomic_int_inc (&_latency_recompute_pending);
+	auto_connect_thread_wakeup ();
+}
+
+void
+Session::queue_route_latency_recompute (boost::weak_ptr<Route> wr)
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_latency_dirty_lock);
+		_latency_dirty_routes.push_back (wr);
+	}
 	g_atomic_int_inc (&_latency_recompute_pending);
 	auto_connect_thread_wakeup ();
 }
@@ -7416,7 +7725,7 @@ Session::auto_connect_thread_run ()
 			 * modifies the capture-offset, which can be a problem.
 			 */
 			while (g_atomic_int_and (&_latency_recompute_pending, 0)) {
-				update_latency_compensation (false, false);
+				update_latency_compensation (false, false, true);
 				if (g_atomic_int_get (&_latency_recompute_pending)) {
 					Glib::usleep (1000);
 				}
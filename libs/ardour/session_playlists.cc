@@ -22,11 +22,14 @@
  */
 #include <vector>
 
+#include <boost/bind.hpp>
+
 #include "ardour/debug.h"
 #include "ardour/playlist.h"
 #include "ardour/playlist_factory.h"
 #include "ardour/session_playlists.h"
 #include "ardour/track.h"
+#include "ardour/utils.h"
 #include "pbd/i18n.h"
 #include "pbd/compose.h"
 #include "pbd/xml++.h"
@@ -419,6 +422,28 @@ get_id_sorted_playlists (const List& playlists, IDSortedList& id_sorted_playlist
 
 } // anonymous namespace
 
+static void
+playlist_state (std::vector<boost::shared_ptr<Playlist> > const & playlists, std::vector<XMLNode*>& nodes, bool save_template, size_t n)
+{
+	nodes[n] = save_template ? &playlists[n]->get_template () : &playlists[n]->get_state ();
+}
+
+/** Add state of all given playlists to @p node. Playlists are independent of
+ * each other, and their state is plain data (no plugin state), so it is
+ * collected concurrently (but added in order).
+ */
+static void
+add_playlists_state (XMLNode* node, std::vector<boost::shared_ptr<Playlist> > const & playlists, bool save_template)
+{
+	std::vector<XMLNode*> nodes (playlists.size ());
+
+	parallel_for (playlists.size (), boost::bind (&playlist_state, boost::cref (playlists), boost::ref (nodes), save_template, _1), 0, 8);
+
+	for (std::vector<XMLNode*>::const_iterator n = nodes.begin (); n != nodes.end (); ++n) {
+		node->add_child_nocopy (**n);
+	}
+}
+
 void
 SessionPlaylists::add_state (XMLNode* node, bool save_template, bool include_unused) const
 {
@@ -427,16 +452,16 @@ SessionPlaylists::add_state (XMLNode* node, bool save_template, bool include_unu
 	IDSortedList id_sorted_playlists;
 	get_id_sorted_playlists (playlists, id_sorted_playlists);
 
+	std::vector<boost::shared_ptr<Playlist> > pl;
+
 	for (IDSortedList::const_iterator i = id_sorted_playlists.begin (); i != id_sorted_playlists.end (); ++i) {
 		if (!(*i)->hidden ()) {
-			if (save_template) {
-				child->add_child_nocopy ((*i)->get_template ());
-			} else {
-				child->add_child_nocopy ((*i)->get_state ());
-			}
+			pl.push_back (*i);
 		}
 	}
 
+	add_playlists_state (child, pl, save_template);
+
 	if (!include_unused) {
 		return;
 	}
@@ -446,18 +471,18 @@ SessionPlaylists::add_state (XMLNode* node, bool save_template, bool include_unu
 	IDSortedList id_sorted_unused_playlists;
 	get_id_sorted_playlists (unused_playlists, id_sorted_unused_playlists);
 
+	pl.clear ();
+
 	for (IDSortedList::iterator i = id_sorted_unused_playlists.begin ();
 	     i != id_sorted_unused_playlists.end (); ++i) {
 		if (!(*i)->hidden()) {
 			if (!(*i)->empty()) {
-				if (save_template) {
-					child->add_child_nocopy ((*i)->get_template());
-				} else {
-					child->add_child_nocopy ((*i)->get_state());
-				}
+				pl.push_back (*i);
 			}
 		}
 	}
+
+	add_playlists_state (child, pl, save_template);
 }
 
 /** @return true for `stop cleanup', otherwise false */
@@ -71,6 +71,7 @@
 #include <glibmm/fileutils.h>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/bind.hpp>
 
 #include "midi++/mmc.h"
 #include "midi++/port.h"
@@ -85,6 +86,7 @@
 #include "pbd/pathexpand.h"
 #include "pbd/pthread_utils.h"
 #include "pbd/scoped_file_descriptor.h"
+#include "pbd/timing.h"
 #include "pbd/types_convert.h"
 #include "pbd/localtime_r.h"
 #include "pbd/unwind.h"
@@ -115,6 +117,7 @@
 #include "ardour/mixer_scene.h"
 #include "ardour/playlist_factory.h"
 #include "ardour/playlist_source.h"
+#include "ardour/plugin.h"
 #include "ardour/port.h"
 #include "ardour/processor.h"
 #include "ardour/progress.h"
@@ -135,6 +138,7 @@
 #include "ardour/smf_source.h"
 #include "ardour/sndfilesource.h"
 #include "ardour/source_factory.h"
+#include "ardour/state_journal.h"
 #include "ardour/speakers.h"
 #include "ardour/template_utils.h"
 #include "ardour/tempo.h"
@@ -142,6 +146,7 @@
 #include "ardour/transport_master_manager.h"
 #include "ardour/types_convert.h"
 #include "ardour/user_bundle.h"
+#include "ardour/utils.h"
 #include "ardour/vca.h"
 #include "ardour/vca_manager.h"
 
@@ -196,6 +201,7 @@ Session::pre_engine_init (string fullpath)
 	last_rr_session_dir = session_dirs.begin();
 
 	set_history_depth (Config->get_history_depth());
+	_history.set_memory_limit ((size_t) Config->get_history_memory_limit () << 20);
 
 	/* default: assume simple stereo speaker configuration */
 
@@ -271,6 +277,7 @@ Session::post_engine_init ()
 		/* crossfades require sample rate knowledge */
 
 		_engine.GraphReordered.connect_same_thread (*this, boost::bind (&Session::graph_reordered, this, true));
+		_engine.PortConnectedOrDisconnected.connect_same_thread (*this, boost::bind (&Session::port_connected_or_disconnected, this, _1, _3));
 		_engine.MidiSelectionPortsChanged.connect_same_thread (*this, boost::bind (&Session::rewire_midi_selection_ports, this));
 
 		DiskReader::allocate_working_buffers();
@@ -682,6 +689,19 @@ Session::maybe_write_autosave()
 void
 Session::remove_pending_capture_state ()
 {
+	wait_for_background_save ();
+
+	if (_state_journal) {
+		_state_journal->reset ();
+	}
+
+	std::string journal_path = Glib::build_filename (_session_dir->root_path(), legalize_for_path (_current_snapshot_name) + journal_suffix);
+
+	if (Glib::file_test (journal_path, Glib::FILE_TEST_EXISTS) && ::g_unlink (journal_path.c_str()) != 0) {
+		error << string_compose(_("Could not remove session journal at path \"%1\" (%2)"),
+				journal_path, g_strerror (errno)) << endmsg;
+	}
+
 	std::string pending_state_file_path(_session_dir->root_path());
 
 	pending_state_file_path = Glib::build_filename (pending_state_file_path, legalize_for_path (_current_snapshot_name) + pending_suffix);
@@ -755,6 +775,117 @@ Session::remove_state (string snapshot_name)
 	StateSaved (snapshot_name); /* EMIT SIGNAL */
 }
 
+/** Write @p tree to @p tmp_path, flush it to disk and atomically rename
+ * it to @p xml_path. If @p backup_path is given, the result is also copied
+ * there.
+ */
+static int
+write_state_file (XMLTree& tree, std::string const& tmp_path, std::string const& xml_path, std::string const& backup_path)
+{
+	PBD::Timing t;
+
+	if (!tree.write (tmp_path)) {
+		error << string_compose (_("state could not be saved to %1"), tmp_path) << endmsg;
+		if (g_remove (tmp_path.c_str()) != 0) {
+			error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
+					tmp_path, g_strerror (errno)) << endmsg;
+		}
+		return -1;
+	}
+
+#ifndef PLATFORM_WINDOWS
+	/* make sure the data is on disk before replacing the old file */
+	{
+		PBD::ScopedFileDescriptor fd (g_open (tmp_path.c_str(), O_RDONLY, 0444));
+		if (fd < 0 || ::fsync (fd) != 0) {
+			warning << string_compose (_("could not sync session file %1 to disk (%2)"), tmp_path, g_strerror (errno)) << endmsg;
+		}
+	}
+#endif
+
+	if (::g_rename (tmp_path.c_str(), xml_path.c_str()) != 0) {
+		error << string_compose (_("could not rename temporary session file %1 to %2 (%3)"),
+				tmp_path, xml_path, g_strerror(errno)) << endmsg;
+		if (g_remove (tmp_path.c_str()) != 0) {
+			error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
+					tmp_path, g_strerror (errno)) << endmsg;
+		}
+		return -1;
+	}
+
+	if (!backup_path.empty () && !copy_file (xml_path, backup_path)) {
+		error << string_compose(_("Could not save backup file at path \"%1\" (%2)"),
+				backup_path, g_strerror (errno)) << endmsg;
+	}
+
+	t.update ();
+	DEBUG_TRACE (DEBUG::SaveState, string_compose ("wrote %1 in %2 ms\n", xml_path, t.elapsed_msecs ()));
+	return 0;
+}
+
+/** Write a full pending state file. Any journal of earlier changes
+ * at @p journal_path is stale after that.
+ */
+static int
+write_pending_state_file (boost::shared_ptr<XMLTree> tree, std::string tmp_path, std::string xml_path, std::string backup_path, std::string journal_path)
+{
+	if (write_state_file (*tree, tmp_path, xml_path, backup_path)) {
+		return -1;
+	}
+	if (Glib::file_test (journal_path, Glib::FILE_TEST_EXISTS)) {
+		::g_unlink (journal_path.c_str());
+	}
+	return 0;
+}
+
+/** Save @p tree as pending state. With @p journaled, only what changed
+ * since the last pending save is appended to the journal at
+ * @p journal_path, if possible. Otherwise the state is written in full,
+ * and becomes the base of the @p journal once it is on disk.
+ *
+ * This runs in the save thread, nothing else uses @p journal until
+ * that is joined.
+ */
+static int
+write_pending_state (StateJournal* journal, bool journaled, boost::shared_ptr<XMLTree> tree, std::string tmp_path, std::string xml_path, std::string backup_path, std::string journal_path)
+{
+	if (journaled) {
+		if (journal->append (tree, journal_path) == 0) {
+			DEBUG_TRACE (DEBUG::SaveState, string_compose ("journaled session state, %1 records\n", journal->n_records ()));
+			return 0;
+		}
+		/* compact: write the current state in full, and use it as
+		 * base for a new journal. This stamps the tree, so it has to
+		 * happen before writing it.
+		 */
+		journal->set_base (tree);
+	}
+
+	if (write_pending_state_file (tree, tmp_path, xml_path, backup_path, journal_path)) {
+		/* the base was not written, the next save has to be a full one */
+		journal->reset ();
+		return -1;
+	}
+	return 0;
+}
+
+static void
+background_write_pending_state (StateJournal* journal, bool journaled, boost::shared_ptr<XMLTree> tree, std::string tmp_path, std::string xml_path, std::string backup_path, std::string journal_path)
+{
+	write_pending_state (journal, journaled, tree, tmp_path, xml_path, backup_path, journal_path);
+}
+
+void
+Session::wait_for_background_save ()
+{
+	Glib::Threads::Mutex::Lock lm (save_thread_lock);
+	if (_save_thread) {
+		_save_thread->join ();
+		delete _save_thread;
+		_save_thread = 0;
+	}
+}
+
 /** @param snapshot_name Name to save under, without .ardour / .pending prefix */
 int
 Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot, bool template_only, bool for_archive, bool only_used_assets)
@@ -770,12 +901,16 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 	/* pending saves are for current snapshot only */
 	assert (!pending || ((snapshot_name.empty () || snapshot_name == _current_snapshot_name) && !template_only && !for_archive));
 
-	XMLTree tree;
+	boost::shared_ptr<XMLTree> tree (new XMLTree);
 	std::string xml_path(_session_dir->root_path());
 
 	/* prevent concurrent saves from different threads */
 
 	Glib::Threads::Mutex::Lock lm (save_state_lock);
+
+	/* a previous pending save may still be writing the same files */
+	wait_for_background_save ();
+
 	Glib::Threads::Mutex::Lock lx (save_source_lock, Glib::Threads::NOT_LOCK);
 	if (!for_archive) {
 		lx.acquire ();
@@ -826,13 +961,18 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		mark_as_clean = false;
 	}
 
+	PBD::Timing capture_time;
+
 	if (template_only) {
 		mark_as_clean = false;
-		tree.set_root (&get_template());
+		tree->set_root (&get_template());
 	} else {
-		tree.set_root (&state (false, fork_state, for_archive, only_used_assets));
+		tree->set_root (&state (false, fork_state, for_archive, only_used_assets));
 	}
 
+	capture_time.update ();
+	DEBUG_TRACE (DEBUG::SaveState, string_compose ("captured session state in %1 ms\n", capture_time.elapsed_msecs ()));
+
 	if (snapshot_name.empty()) {
 		snapshot_name = _current_snapshot_name;
 	} else if (switch_to_snapshot) {
@@ -863,26 +1003,7 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 	std::string tmp_path(_session_dir->root_path());
 	tmp_path = Glib::build_filename (tmp_path, legalize_for_path (snapshot_name) + temp_suffix);
 
-	if (!tree.write (tmp_path)) {
-		error << string_compose (_("state could not be saved to %1"), tmp_path) << endmsg;
-		if (g_remove (tmp_path.c_str()) != 0) {
-			error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
-					tmp_path, g_strerror (errno)) << endmsg;
-		}
-		return -1;
-
-	} else {
-
-		if (::g_rename (tmp_path.c_str(), xml_path.c_str()) != 0) {
-			error << string_compose (_("could not rename temporary session file %1 to %2 (%3)"),
-					tmp_path, xml_path, g_strerror(errno)) << endmsg;
-			if (g_remove (tmp_path.c_str()) != 0) {
-				error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
-						tmp_path, g_strerror (errno)) << endmsg;
-			}
-			return -1;
-		}
-	}
+	std::string backup_path;
 
 	//Mixbus auto-backup mechanism
 	if(Profile->get_mixbus()) {
@@ -896,19 +1017,42 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 			time (&n);
 			localtime_r (&n, &local_time);
 			strftime (timebuf, sizeof(timebuf), "%y-%m-%d.%H", &local_time);
-			std::string save_path(session_directory().backup_path());
-			save_path += G_DIR_SEPARATOR;
-			save_path += legalize_for_path(_current_snapshot_name);
-			save_path += "-";
-			save_path += timebuf;
-			save_path += statefile_suffix;
-			if (!copy_file (xml_path, save_path)) {
-					error << string_compose(_("Could not save backup file at path \"%1\" (%2)"),
-							save_path, g_strerror (errno)) << endmsg;
-			}
+			backup_path = session_directory().backup_path();
+			backup_path += G_DIR_SEPARATOR;
+			backup_path += legalize_for_path(_current_snapshot_name);
+			backup_path += "-";
+			backup_path += timebuf;
+			backup_path += statefile_suffix;
 		}
 	}
 
+	if (pending) {
+		std::string journal_path = Glib::build_filename (_session_dir->root_path(), legalize_for_path (snapshot_name) + journal_suffix);
+
+		/* only record what changed since the last pending save */
+		const bool journaled = Config->get_journaled_safety_backups () && backup_path.empty ();
+
+		if (!journaled) {
+			_state_journal->reset ();
+		}
+
+		/* nothing waits for a pending save to complete. Serialize and write
+		 * it (or append it to the journal) in the background, so that
+		 * periodic auto-saves do not stall the GUI. The next save (or
+		 * session close) waits for it.
+		 */
+		Glib::Threads::Mutex::Lock lt (save_thread_lock);
+		_save_thread = PBD::Thread::create (boost::bind (&background_write_pending_state, _state_journal, journaled, tree, tmp_path, xml_path, backup_path, journal_path), "SaveState");
+		if (_save_thread) {
+			return 0;
+		}
+		return write_pending_state (_state_journal, journaled, tree, tmp_path, xml_path, backup_path, journal_path);
+	}
+
+	if (write_state_file (*tree, tmp_path, xml_path, backup_path)) {
+		return -1;
+	}
+
 	if (!pending && !for_archive) {
 
 		save_history (snapshot_name);
@@ -991,6 +1135,16 @@ Session::load_state (string snapshot_name, bool from_template)
 		return -1;
 	}
 
+	if (state_was_pending) {
+		/* apply changes recorded after the pending state was written */
+		std::string journal_path = Glib::build_filename (_session_dir->root_path(), legalize_for_path (snapshot_name) + journal_suffix);
+
+		if (Glib::file_test (journal_path, Glib::FILE_TEST_EXISTS) && StateJournal::apply (*state_tree->root(), journal_path) < 0) {
+			/* use the pending state as-is */
+			state_tree->read (xmlpath);
+		}
+	}
+
 	XMLNode const & root (*state_tree->root());
 
 	if (root.name() != X_("Session")) {
@@ -1492,6 +1646,11 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool for_archive,
 		RouteList xml_node_order (*r);
 		xml_node_order.sort (cmp);
 
+		/* Route state includes plugin state, which must be collected
+		 * in this thread (e.g. lilv is not thread-safe), so this is
+		 * done serially. Playlist state below is collected concurrently.
+		 */
+
 		for (RouteList::const_iterator i = xml_node_order.begin(); i != xml_node_order.end(); ++i) {
 			if (!(*i)->is_auditioner()) {
 				if (save_template) {
@@ -1666,6 +1825,13 @@ Session::get_control_protocol_state () const
 	return ControlProtocolManager::instance().get_state ();
 }
 
+/** Report the time spent since the previous call for @p t, and restart it */
+static void
+load_phase_done (PBD::Timing& t, char const* phase)
+{
+	DEBUG_TRACE (DEBUG::LoadState, string_compose ("loaded %1 in %2 ms\n", phase, t.get_interval () / 1000.0));
+}
+
 int
 Session::set_state (const XMLNode& node, int version)
 {
@@ -1673,6 +1839,8 @@ Session::set_state (const XMLNode& node, int version)
 	XMLNodeList nlist;
 	XMLNode* child;
 	int ret = -1;
+	PBD::Timing load_time;
+	PBD::Timing phase_time;
 
 	_state_of_the_state = StateOfTheState (_state_of_the_state | CannotSave);
 
@@ -1729,6 +1897,8 @@ Session::set_state (const XMLNode& node, int version)
 		}
 	}
 
+	load_phase_done (phase_time, "tempo map");
+
 
 	created_with = "unknown";
 	if ((child = find_named_node (node, "ProgramVersion")) != 0) {
@@ -1801,6 +1971,8 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	load_phase_done (phase_time, "sources");
+
 	if ((child = find_named_node (node, "Locations")) == 0) {
 		error << _("Session: XML state has no locations section") << endmsg;
 		goto out;
@@ -1808,6 +1980,8 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	load_phase_done (phase_time, "locations");
+
 	locations_changed ();
 
 	if (_session_range_location) {
@@ -1821,6 +1995,8 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	load_phase_done (phase_time, "regions");
+
 	if ((child = find_named_node (node, "Playlists")) == 0) {
 		error << _("Session: XML state has no playlists section") << endmsg;
 		goto out;
@@ -1840,6 +2016,8 @@ Session::set_state (const XMLNode& node, int version)
 		}
 	}
 
+	load_phase_done (phase_time, "playlists");
+
 	if (version >= 3000) {
 		if ((child = find_named_node (node, "Bundles")) == 0) {
 			warning << _("Session: XML state has no bundles section") << endmsg;
@@ -1926,6 +2104,8 @@ Session::set_state (const XMLNode& node, int version)
 		goto out;
 	}
 
+	load_phase_done (phase_time, "routes");
+
 	/* Now that we Tracks have been loaded and playlists are assigned */
 	_playlists->update_tracking ();
 
@@ -2028,11 +2208,15 @@ Session::set_state (const XMLNode& node, int version)
 	update_route_record_state ();
 	sync_cues ();
 
+	load_phase_done (phase_time, "other state");
+
 	/* here beginneth the second phase ... */
 	set_snapshot_name (_current_snapshot_name);
 
 	StateReady (); /* EMIT SIGNAL */
 
+	load_phase_done (load_time, "total");
+
 	delete state_tree;
 	state_tree = 0;
 	return 0;
@@ -2054,6 +2238,9 @@ Session::load_routes (const XMLNode& node, int version)
 
 	set_dirty();
 
+	/* restore plugin state concurrently, once all routes are created */
+	Plugin::DeferredRestore deferred_restore;
+
 	for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
 
 		boost::shared_ptr<Route> route;
@@ -2076,6 +2263,10 @@ Session::load_routes (const XMLNode& node, int version)
 		new_routes.push_back (route);
 	}
 
+	BootMessage (_("Restoring plugin state"));
+
+	deferred_restore.run ();
+
 	BootMessage (_("Tracks/busses loaded;  Adding to Session"));
 
 	add_routes (new_routes, false, false, PresentationInfo::max_order);
@@ -2608,6 +2799,39 @@ Session::reset_write_sources (bool mark_write_complete, bool force)
 	}
 }
 
+/** Open the file of an audio source, and parse its header, from a worker
+ * thread. The source is not announced; it is left to the caller to do so in
+ * session order. Anything that may need user interaction (missing or
+ * ambiguous files) is left for the serial pass.
+ */
+static void
+preload_source (Session& session, XMLNodeList const& nodes, std::vector<boost::shared_ptr<Source> >& sources, size_t n)
+{
+	XMLNode const& node (*nodes[n]);
+
+	if (node.name () != "Source" || node.property ("playlist")) {
+		return;
+	}
+
+	DataType type = DataType::AUDIO;
+	node.get_property ("type", type);
+
+	if (type != DataType::AUDIO) {
+		return;
+	}
+
+	FileSource::set_quiet_find_in_this_thread (true);
+
+	try {
+		/* peak building is deferred to the peak threads */
+		sources[n] = SourceFactory::create (session, node, true, false);
+	} catch (...) {
+		/* try again in the serial pass */
+	}
+
+	FileSource::set_quiet_find_in_this_thread (false);
+}
+
 int
 Session::load_sources (const XMLNode& node)
 {
@@ -2624,11 +2848,34 @@ Session::load_sources (const XMLNode& node)
 	set_dirty();
 	std::map<std::string, std::string> relocation;
 
-	for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
+	/* opening audio files and reading their headers is independent for
+	 * each source, do that in parallel first. Sources are then registered
+	 * with the session in order.
+	 */
+	std::vector<boost::shared_ptr<Source> > preloaded (nlist.size ());
+
+	{
+#ifdef PLATFORM_WINDOWS
+		int old_mode = SetErrorMode (SEM_FAILCRITICALERRORS);
+#endif
+		parallel_for (nlist.size (), boost::bind (&preload_source, boost::ref (*this), boost::cref (nlist), boost::ref (preloaded), _1), 0, 4);
+#ifdef PLATFORM_WINDOWS
+		SetErrorMode (old_mode);
+#endif
+	}
+
+	size_t n = 0;
+
+	for (niter = nlist.begin(); niter != nlist.end(); ++niter, ++n) {
 #ifdef PLATFORM_WINDOWS
 		int old_mode = 0;
 #endif
 
+		if (preloaded[n]) {
+			SourceFactory::SourceCreated (preloaded[n]); /* EMIT SIGNAL */
+			continue;
+		}
+
 		XMLNode srcnode (**niter);
 		bool try_replace_abspath = true;
 
@@ -4189,95 +4436,108 @@ Session::restore_history (string snapshot_name)
 	// replace history
 	_history.clear();
 
-	try {
-		for (XMLNodeConstIterator it  = tree.root()->children().begin(); it != tree.root()->children().end(); ++it) {
+	/* Only index the transactions here. Their commands are created when
+	 * they are first undone or redone, which for most of them is never.
+	 */
 
-			XMLNode *t = *it;
+	for (XMLNodeConstIterator it  = tree.root()->children().begin(); it != tree.root()->children().end(); ++it) {
 
-			std::string name;
-			int64_t tv_sec;
-			int64_t tv_usec;
+		XMLNode *t = *it;
 
-			if (!t->get_property ("name", name) || !t->get_property ("tv-sec", tv_sec) ||
-			    !t->get_property ("tv-usec", tv_usec)) {
-				continue;
-			}
+		std::string name;
+		int64_t tv_sec;
+		int64_t tv_usec;
 
-			UndoTransaction* ut = new UndoTransaction ();
-			ut->set_name (name);
+		if (!t->get_property ("name", name) || !t->get_property ("tv-sec", tv_sec) ||
+		    !t->get_property ("tv-usec", tv_usec)) {
+			continue;
+		}
 
-			struct timeval tv;
-			tv.tv_sec = tv_sec;
-			tv.tv_usec = tv_usec;
-			ut->set_timestamp(tv);
+		UndoTransaction* ut = new UndoTransaction ();
+		ut->set_name (name);
 
-			for (XMLNodeConstIterator child_it  = t->children().begin();
-			     child_it != t->children().end(); child_it++)
-			{
-				XMLNode *n = *child_it;
-				Command *c;
+		struct timeval tv;
+		tv.tv_sec = tv_sec;
+		tv.tv_usec = tv_usec;
+		ut->set_timestamp(tv);
 
-				if (n->name() == "MementoCommand" ||
-				    n->name() == "MementoUndoCommand" ||
-				    n->name() == "MementoRedoCommand") {
+		ut->set_deferred_state (new XMLNode (*t), boost::bind (&Session::add_history_commands, this, _1, _2));
 
-					if ((c = memento_command_factory(n))) {
-						ut->add_command(c);
-					}
+		_history.add (ut);
+	}
+
+	return 0;
+}
+
+/** Create the commands of the undo transaction described by @p t, and add
+ * them to @p ut.
+ */
+void
+Session::add_history_commands (UndoTransaction& ut, XMLNode const& t)
+{
+	try {
+		for (XMLNodeConstIterator child_it  = t.children().begin();
+		     child_it != t.children().end(); child_it++)
+		{
+			XMLNode *n = *child_it;
+			Command *c;
 
-				} else if (n->name() == "TempoCommand") {
+			if (n->name() == "MementoCommand" ||
+			    n->name() == "MementoUndoCommand" ||
+			    n->name() == "MementoRedoCommand") {
 
-					ut->add_command (new TempoCommand (*n));
+				if ((c = memento_command_factory(n))) {
+					ut.add_command(c);
+				}
 
-				} else if (n->name() == "NoteDiffCommand") {
-					PBD::ID id (n->property("midi-source")->value());
-					boost::shared_ptr<MidiSource> midi_source =
-						boost::dynamic_pointer_cast<MidiSource, Source>(source_by_id(id));
-					if (midi_source) {
-						ut->add_command (new MidiModel::NoteDiffCommand(midi_source->model(), *n));
-					} else {
-						error << _("Failed to downcast MidiSource for NoteDiffCommand") << endmsg;
-					}
+			} else if (n->name() == "TempoCommand") {
 
-				} else if (n->name() == "SysExDiffCommand") {
+				ut.add_command (new TempoCommand (*n));
 
-					PBD::ID id (n->property("midi-source")->value());
-					boost::shared_ptr<MidiSource> midi_source =
-						boost::dynamic_pointer_cast<MidiSource, Source>(source_by_id(id));
-					if (midi_source) {
-						ut->add_command (new MidiModel::SysExDiffCommand (midi_source->model(), *n));
-					} else {
-						error << _("Failed to downcast MidiSource for SysExDiffCommand") << endmsg;
-					}
+			} else if (n->name() == "NoteDiffCommand") {
+				PBD::ID id (n->property("midi-source")->value());
+				boost::shared_ptr<MidiSource> midi_source =
+					boost::dynamic_pointer_cast<MidiSource, Source>(source_by_id(id));
+				if (midi_source) {
+					ut.add_command (new MidiModel::NoteDiffCommand(midi_source->model(), *n));
+				} else {
+					error << _("Failed to downcast MidiSource for NoteDiffCommand") << endmsg;
+				}
 
-				} else if (n->name() == "PatchChangeDiffCommand") {
+			} else if (n->name() == "SysExDiffCommand") {
 
-					PBD::ID id (n->property("midi-source")->value());
-					boost::shared_ptr<MidiSource> midi_source =
-						boost::dynamic_pointer_cast<MidiSource, Source>(source_by_id(id));
-					if (midi_source) {
-						ut->add_command (new MidiModel::PatchChangeDiffCommand (midi_source->model(), *n));
-					} else {
-						error << _("Failed to downcast MidiSource for PatchChangeDiffCommand") << endmsg;
-					}
+				PBD::ID id (n->property("midi-source")->value());
+				boost::shared_ptr<MidiSource> midi_source =
+					boost::dynamic_pointer_cast<MidiSource, Source>(source_by_id(id));
+				if (midi_source) {
+					ut.add_command (new MidiModel::SysExDiffCommand (midi_source->model(), *n));
+				} else {
+					error << _("Failed to downcast MidiSource for SysExDiffCommand") << endmsg;
+				}
 
-				} else if (n->name() == "StatefulDiffCommand") {
-					if ((c = stateful_diff_command_factory (n))) {
-						ut->add_command (c);
-					}
+			} else if (n->name() == "PatchChangeDiffCommand") {
+
+				PBD::ID id (n->property("midi-source")->value());
+				boost::shared_ptr<MidiSource> midi_source =
+					boost::dynamic_pointer_cast<MidiSource, Source>(source_by_id(id));
+				if (midi_source) {
+					ut.add_command (new MidiModel::PatchChangeDiffCommand (midi_source->model(), *n));
 				} else {
-					error << string_compose(_("Couldn't figure out how to make a Command out of a %1 XMLNode."), n->name()) << endmsg;
+					error << _("Failed to downcast MidiSource for PatchChangeDiffCommand") << endmsg;
 				}
-			}
 
-			_history.add (ut);
+			} else if (n->name() == "StatefulDiffCommand") {
+				if ((c = stateful_diff_command_factory (n))) {
+					ut.add_command (c);
+				}
+			} else {
+				error << string_compose(_("Couldn't figure out how to make a Command out of a %1 XMLNode."), n->name()) << endmsg;
+			}
 		}
 
 	} catch (std::exception const & e) {
 		error << string_compose (_("Error during loading undo history (%1). Undo history will be ignored"), e.what()) << endmsg;
 	}
-
-	return 0;
 }
 
 void
@@ -4447,6 +4707,8 @@ Session::config_changed (std::string p, bool ours)
 		setup_fpu ();
 	} else if (p == "history-depth") {
 		set_history_depth (Config->get_history_depth());
+	} else if (p == "history-memory-limit") {
+		_history.set_memory_limit ((size_t) Config->get_history_memory_limit () << 20);
 	} else if (p == "remote-model") {
 		/* XXX DO SOMETHING HERE TO TELL THE GUI THAT WE NEED
 		   TO SET REMOTE ID'S
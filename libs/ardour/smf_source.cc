@@ -42,6 +42,7 @@
 
 #include "evoral/Control.h"
 #include "evoral/SMF.h"
+#include "evoral/SMFParser.h"
 
 #include "temporal/tempo.h"
 
@@ -659,6 +660,13 @@ SMFSource::load_model_unlocked (bool force_reload)
 	}
 
 	_model->start_write();
+
+	if (Evoral::SMF::file_in_sync () && load_model_from_file ()) {
+		_model->end_write (Evoral::Sequence<Temporal::Beats>::ResolveStuckNotes, _length.beats());
+		_model->set_edited (false);
+		return;
+	}
+
 	Evoral::SMF::seek_to_start();
 
 	uint64_t time = 0; /* in SMF ticks */
@@ -775,6 +783,80 @@ SMFSource::load_model_unlocked (bool force_reload)
 	free (buf);
 }
 
+/** Fill the model (which must be in write mode) directly from the file on
+ * disk, using a streaming parser. Events of all tracks arrive in time order,
+ * so there is no need to build and sort an intermediate event list.
+ *
+ * @return false if the file could not be parsed, in which case the model is
+ * left untouched.
+ */
+bool
+SMFSource::load_model_from_file ()
+{
+	Evoral::SMFParser parser;
+
+	if (parser.open (_path)) {
+		return false;
+	}
+
+	const uint16_t ppqn = parser.ppqn ();
+
+	uint64_t           time;
+	uint32_t           size;
+	uint8_t const *    buf;
+	Evoral::event_id_t event_id;
+
+	Evoral::Event<Temporal::Beats> ev (Evoral::MIDI_EVENT, Temporal::Beats());
+
+	_num_channels     = 0;
+	_n_note_on_events = 0;
+	_has_pgm_change   = false;
+	_used_channels.reset ();
+
+	while (parser.read_event (&time, &size, &buf, &event_id) > 0) {
+
+		/* aggregate information about channels and pgm-changes */
+		uint8_t type = buf[0] & 0xf0;
+		uint8_t chan = buf[0] & 0x0f;
+		if (type >= 0x80 && type <= 0xE0) {
+			_used_channels.set(chan);
+			switch (type) {
+				case MIDI_CMD_NOTE_ON:
+					++_n_note_on_events;
+					break;
+				case MIDI_CMD_PGM_CHANGE:
+					_has_pgm_change = true;
+					break;
+				default:
+					break;
+			}
+		}
+
+		if (event_id < 0) {
+			event_id = Evoral::next_event_id();
+		}
+
+		const Temporal::Beats event_time = Temporal::Beats::ticks_at_rate (time, ppqn);
+
+		DEBUG_TRACE (DEBUG::MidiSourceIO, string_compose ("SMF %1 stream model time %2, size %3, id %4\n", name(), time, size, event_id));
+
+		/* the model copies what it needs, no need to own the data */
+		ev.set_buffer (size, const_cast<uint8_t*> (buf), false);
+		ev.set_time (event_time);
+
+		_model->append (ev, event_id);
+
+		assert (!_length || (_length.time_domain() == Temporal::BeatTime));
+		_length = max (_length, timepos_t (event_time));
+	}
+
+	ev.set_buffer (0, 0, false);
+
+	_num_channels = _used_channels.size();
+
+	return true;
+}
+
 Evoral::SMF::UsedChannels
 SMFSource::used_midi_channels()
 {
@@ -26,10 +26,12 @@
 #include "libardour-config.h"
 #endif
 
+#include <algorithm>
 #include <cstring>
 #include <cerrno>
 #include <climits>
 #include <cstdarg>
+#include <set>
 #include <fcntl.h>
 
 #include <sys/stat.h>
@@ -40,7 +42,9 @@
 #include <glibmm/convert.h>
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
+#include <glibmm/threads.h>
 
+#include "ardour/rc_configuration.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/sndfilesource.h"
 #include "ardour/sndfile_helpers.h"
@@ -54,6 +58,11 @@ using namespace ARDOUR;
 using namespace PBD;
 using std::string;
 
+/* read-only sources with an open file, see add_open_file() */
+static Glib::Threads::Mutex     open_files_lock;
+static std::set<SndFileSource*> open_files;
+static GATOMIC_QUAL gint        use_counter = 0;
+
 const Source::Flag SndFileSource::default_writable_flags = Source::Flag (
 		Source::Writable |
 		Source::Removable |
@@ -71,7 +80,10 @@ SndFileSource::SndFileSource (Session& s, const XMLNode& node)
         assert (Glib::file_test (_path, Glib::FILE_TEST_EXISTS));
 	existence_check ();
 
-	if (open()) {
+	/* if the session file has up-to-date information about the file,
+	 * there is no need to open it until it is read from.
+	 */
+	if (!use_cached_file_info (node) && open()) {
 		throw failed_constructor ();
 	}
 }
@@ -323,6 +335,8 @@ SndFileSource::init_sndfile ()
 
 	memset (&_info, 0, sizeof(_info));
 
+	g_atomic_int_set (&_last_used, 0);
+
 	AudioFileSource::HeaderPositionOffsetChanged.connect_same_thread (header_position_connection, boost::bind (&SndFileSource::handle_header_position_change, this));
 }
 
@@ -381,6 +395,10 @@ SndFileSource::open ()
 		return -1;
 	}
 
+	if (!writable ()) {
+		add_open_file (this);
+	}
+
 
 	_length = timecnt_t (_info.frames);
 
@@ -474,10 +492,145 @@ SndFileSource::open ()
 
 SndFileSource::~SndFileSource ()
 {
+	remove_open_file (this);
 	close ();
 	delete _broadcast_info;
 }
 
+XMLNode&
+SndFileSource::get_state () const
+{
+	XMLNode& node (AudioFileSource::get_state ());
+
+	/* cache file information, which allows to skip opening the file
+	 * when the session is loaded.
+	 */
+
+	GStatBuf statbuf;
+
+	if (!writable () && _info.channels > 0 && g_stat (_path.c_str (), &statbuf) == 0) {
+		XMLNode* child = node.add_child (X_("FileInfo"));
+		child->set_property (X_("length"), (int64_t) _info.frames);
+		child->set_property (X_("channels"), _info.channels);
+		child->set_property (X_("format"), _info.format);
+		child->set_property (X_("sample-rate"), _info.samplerate);
+		child->set_property (X_("size"), (int64_t) statbuf.st_size);
+		child->set_property (X_("mtime"), (int64_t) statbuf.st_mtime);
+	}
+
+	return node;
+}
+
+/** Set up file information from the state saved by get_state(), if the
+ * file has not been modified since. The file will then be opened on demand.
+ * @return true if cached information was used
+ */
+bool
+SndFileSource::use_cached_file_info (const XMLNode& node)
+{
+	XMLNode const* child = node.child (X_("FileInfo"));
+
+	if (writable () || !child) {
+		return false;
+	}
+
+	if ((_flags & Broadcast) && !_have_natural_position) {
+		/* the position needs to be read from the BWF header */
+		return false;
+	}
+
+	int64_t length;
+	int64_t size;
+	int64_t mtime;
+	SF_INFO info;
+
+	memset (&info, 0, sizeof (info));
+
+	if (!child->get_property (X_("length"), length) ||
+	    !child->get_property (X_("channels"), info.channels) ||
+	    !child->get_property (X_("format"), info.format) ||
+	    !child->get_property (X_("sample-rate"), info.samplerate) ||
+	    !child->get_property (X_("size"), size) ||
+	    !child->get_property (X_("mtime"), mtime)) {
+		return false;
+	}
+
+	GStatBuf statbuf;
+
+	if (g_stat (_path.c_str (), &statbuf) != 0 || statbuf.st_size != size || statbuf.st_mtime != mtime) {
+		return false;
+	}
+
+	if (_channel >= info.channels || info.samplerate <= 0) {
+		return false;
+	}
+
+	info.frames = length;
+
+	_info   = info;
+	_length = timecnt_t (length);
+
+	return true;
+}
+
+void
+SndFileSource::mark_used () const
+{
+	g_atomic_int_set (&_last_used, g_atomic_int_add (&use_counter, 1));
+}
+
+void
+SndFileSource::add_open_file (SndFileSource* src)
+{
+	Glib::Threads::Mutex::Lock lm (open_files_lock);
+
+	src->mark_used ();
+	open_files.insert (src);
+
+	const size_t max_open = Config->get_max_open_audio_files ();
+
+	if (max_open == 0 || open_files.size () <= max_open) {
+		return;
+	}
+
+	/* close the least recently used files, and some more to not have to
+	 * do this again for every file that is opened next.
+	 */
+
+	const guint now = g_atomic_int_get (&use_counter);
+	std::vector<std::pair<guint, SndFileSource*> > by_age;
+
+	for (std::set<SndFileSource*>::const_iterator i = open_files.begin (); i != open_files.end (); ++i) {
+		if (*i != src) {
+			by_age.push_back (std::make_pair (now - (guint) g_atomic_int_get (&(*i)->_last_used), *i));
+		}
+	}
+
+	std::sort (by_age.begin (), by_age.end ());
+
+	const size_t target = max_open - max_open / 8;
+
+	for (std::vector<std::pair<guint, SndFileSource*> >::reverse_iterator i = by_age.rbegin (); i != by_age.rend () && open_files.size () > target; ++i) {
+		SndFileSource* victim = i->second;
+		/* a source that is currently being read from is not closed,
+		 * nor waited for.
+		 */
+		if (!victim->_lock.writer_trylock ()) {
+			continue;
+		}
+		victim->close ();
+		open_files.erase (victim);
+		victim->_lock.writer_unlock ();
+	}
+}
+
+void
+SndFileSource::remove_open_file (SndFileSource* src)
+{
+	Glib::Threads::Mutex::Lock lm (open_files_lock);
+	open_files.erase (src);
+}
+
 float
 SndFileSource::sample_rate () const
 {
@@ -505,6 +658,8 @@ SndFileSource::read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) c
 		return 0;
         }
 
+	mark_used ();
+
         if (start > _length.samples()) {
 
 		/* read starts beyond end of data, just memset to zero */
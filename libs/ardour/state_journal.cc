@@ -0,0 +1,403 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#ifndef PLATFORM_WINDOWS
+#include <unistd.h>
+#endif
+
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+#include "pbd/xml++.h"
+
+#include "ardour/state_journal.h"
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+using std::string;
+
+typedef std::map<string, XMLNode const*> IDNodeMap;
+
+/** Index the children of @p section by ID.
+ * @return false if there are no children, or any child has no (or a
+ * duplicate) ID.
+ */
+static bool
+map_ids (XMLNode const& section, IDNodeMap& ids)
+{
+	XMLNodeList const& children (section.children ());
+
+	if (children.empty ()) {
+		return false;
+	}
+
+	for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+		XMLProperty const* id = (*i)->property (X_("id"));
+		if (!id || !ids.insert (std::make_pair (id->value (), *i)).second) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool
+same_properties (XMLNode const& a, XMLNode const& b)
+{
+	XMLPropertyList const& pa (a.properties ());
+	XMLPropertyList const& pb (b.properties ());
+
+	if (pa.size () != pb.size ()) {
+		return false;
+	}
+
+	for (XMLPropertyConstIterator i = pa.begin (), j = pb.begin (); i != pa.end (); ++i, ++j) {
+		if ((*i)->name () != (*j)->name () || (*i)->value () != (*j)->value ()) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void
+copy_properties (XMLNode const& from, XMLNode& to)
+{
+	XMLPropertyList const& props (from.properties ());
+
+	for (XMLPropertyConstIterator i = props.begin (); i != props.end (); ++i) {
+		to.set_property ((*i)->name ().c_str (), (*i)->value ());
+	}
+}
+
+/** Replace all properties of @p to with those of @p from */
+static void
+replace_properties (XMLNode const& from, XMLNode& to)
+{
+	std::vector<string>    names;
+	XMLPropertyList const& props (to.properties ());
+
+	for (XMLPropertyConstIterator i = props.begin (); i != props.end (); ++i) {
+		names.push_back ((*i)->name ());
+	}
+
+	for (std::vector<string>::const_iterator n = names.begin (); n != names.end (); ++n) {
+		to.remove_property (*n);
+	}
+
+	copy_properties (from, to);
+}
+
+/** Add records for all differences between @p base and @p cur to @p delta.
+ * @return false if the two trees do not have the same top-level layout.
+ */
+static bool
+diff_state (XMLNode const& base, XMLNode const& cur, XMLNode& delta)
+{
+	XMLNodeList const& bc (base.children ());
+	XMLNodeList const& cc (cur.children ());
+
+	if (base.name () != cur.name () || bc.size () != cc.size ()) {
+		return false;
+	}
+
+	if (!same_properties (base, cur)) {
+		/* the complete set, properties may also have been removed */
+		copy_properties (cur, *delta.add_child (X_("Root")));
+	}
+
+	uint32_t index = 0;
+
+	for (XMLNodeConstIterator b = bc.begin (), c = cc.begin (); b != bc.end (); ++b, ++c, ++index) {
+
+		if ((*b)->name () != (*c)->name ()) {
+			return false;
+		}
+
+		if (**b == **c) {
+			continue;
+		}
+
+		IDNodeMap base_ids;
+		IDNodeMap cur_ids;
+
+		if (!same_properties (**b, **c) || !map_ids (**b, base_ids) || !map_ids (**c, cur_ids)) {
+			/* replace the complete section */
+			XMLNode* s = delta.add_child (X_("Section"));
+			s->set_property (X_("index"), index);
+			s->add_child_copy (**c);
+			continue;
+		}
+
+		XMLNodeList const& children ((*c)->children ());
+
+		for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+			IDNodeMap::iterator x = base_ids.find ((*i)->property (X_("id"))->value ());
+			if (x != base_ids.end ()) {
+				const bool unchanged = (*x->second == **i);
+				base_ids.erase (x);
+				if (unchanged) {
+					continue;
+				}
+			}
+			XMLNode* s = delta.add_child (X_("Set"));
+			s->set_property (X_("section"), index);
+			s->add_child_copy (**i);
+		}
+
+		/* whatever is left was removed */
+		for (IDNodeMap::const_iterator x = base_ids.begin (); x != base_ids.end (); ++x) {
+			XMLNode* r = delta.add_child (X_("Remove"));
+			r->set_property (X_("section"), index);
+			r->set_property (X_("id"), x->first);
+		}
+	}
+
+	return true;
+}
+
+static XMLNode*
+nth_child (XMLNode& node, uint32_t n)
+{
+	XMLNodeList const& children (node.children ());
+	if (n >= children.size ()) {
+		return 0;
+	}
+	return children[n];
+}
+
+static bool
+apply_delta (XMLNode& root, XMLNode const& delta)
+{
+	XMLNodeList const& records (delta.children ());
+
+	for (XMLNodeConstIterator r = records.begin (); r != records.end (); ++r) {
+
+		XMLNode const& rec (**r);
+
+		if (rec.name () == X_("Root")) {
+			replace_properties (rec, root);
+			continue;
+		}
+
+		uint32_t index;
+		XMLNode* section;
+
+		if (rec.name () == X_("Section")) {
+			if (!rec.get_property (X_("index"), index) || !(section = nth_child (root, index)) || rec.children ().size () != 1) {
+				return false;
+			}
+			*section = *rec.children ().front ();
+
+		} else if (rec.name () == X_("Set")) {
+			if (!rec.get_property (X_("section"), index) || !(section = nth_child (root, index)) || rec.children ().size () != 1) {
+				return false;
+			}
+			XMLNode const& node (*rec.children ().front ());
+			std::string    id;
+
+			if (!node.get_property (X_("id"), id)) {
+				return false;
+			}
+
+			XMLNodeList const& children (section->children ());
+			XMLNodeConstIterator i;
+
+			for (i = children.begin (); i != children.end (); ++i) {
+				XMLProperty const* p = (*i)->property (X_("id"));
+				if (p && p->value () == id) {
+					**i = node;
+					break;
+				}
+			}
+
+			if (i == children.end ()) {
+				section->add_child_copy (node);
+			}
+
+		} else if (rec.name () == X_("Remove")) {
+			std::string id;
+			if (!rec.get_property (X_("section"), index) || !(section = nth_child (root, index)) || !rec.get_property (X_("id"), id)) {
+				return false;
+			}
+			section->remove_nodes_and_delete (X_("id"), id);
+
+		} else {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+StateJournal::StateJournal ()
+	: _generation (g_random_int ())
+	, _records (0)
+	, _size (0)
+{
+}
+
+void
+StateJournal::reset ()
+{
+	_base.reset ();
+	_records = 0;
+	_size = 0;
+}
+
+void
+StateJournal::set_base (boost::shared_ptr<XMLTree> tree)
+{
+	++_generation;
+	tree->root ()->set_property (X_("journal-generation"), _generation);
+
+	_base    = tree;
+	_records = 0;
+	_size    = 0;
+}
+
+int
+StateJournal::append (boost::shared_ptr<XMLTree> tree, std::string const& path)
+{
+	if (!_base || _records >= max_records || _size >= max_size) {
+		return 1;
+	}
+
+	tree->root ()->set_property (X_("journal-generation"), _generation);
+
+	XMLNode* delta = new XMLNode (X_("Delta"));
+	delta->set_property (X_("generation"), _generation);
+
+	XMLTree record;
+	record.set_root (delta);
+
+	if (!diff_state (*_base->root (), *tree->root (), *delta)) {
+		return 1;
+	}
+
+	if (delta->children ().empty ()) {
+		/* nothing changed */
+		_base = tree;
+		return 0;
+	}
+
+	const std::string buf = record.write_buffer ();
+
+	/* the first record of a generation replaces any previous journal */
+	FILE* f = g_fopen (path.c_str (), _records ? "ab" : "wb");
+
+	if (!f) {
+		error << string_compose (_("Could not open session journal %1 (%2)"), path, g_strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	bool ok = fprintf (f, "%lu\n", (unsigned long) buf.size ()) > 0 && fwrite (buf.data (), 1, buf.size (), f) == buf.size () && fflush (f) == 0;
+
+#ifndef PLATFORM_WINDOWS
+	ok = ok && fsync (fileno (f)) == 0;
+#endif
+
+	if (fclose (f) != 0 || !ok) {
+		error << string_compose (_("Could not write session journal %1 (%2)"), path, g_strerror (errno)) << endmsg;
+		/* the journal may now end with an incomplete record, start over */
+		_records = max_records;
+		return -1;
+	}
+
+	_base  = tree;
+	_size += buf.size ();
+	++_records;
+
+	return 0;
+}
+
+int
+StateJournal::apply (XMLNode& root, std::string const& path)
+{
+	uint32_t generation;
+
+	if (!root.get_property (X_("journal-generation"), generation)) {
+		return 0;
+	}
+
+	gchar*  contents;
+	gsize   length;
+	GError* err = NULL;
+
+	if (!g_file_get_contents (path.c_str (), &contents, &length, &err)) {
+		error << string_compose (_("Could not read session journal %1 (%2)"), path, err->message) << endmsg;
+		g_error_free (err);
+		return -1;
+	}
+
+	const std::string buf (contents, length);
+	g_free (contents);
+
+	int    n   = 0;
+	size_t pos = 0;
+
+	while (pos < buf.size ()) {
+		const size_t eol = buf.find ('\n', pos);
+
+		if (eol == std::string::npos) {
+			break;
+		}
+
+		const size_t len = strtoul (buf.c_str () + pos, NULL, 10);
+		pos = eol + 1;
+
+		if (len == 0 || pos + len > buf.size ()) {
+			/* incomplete record, written while crashing */
+			break;
+		}
+
+		XMLTree record;
+
+		if (!record.read_buffer (buf.substr (pos, len).c_str ())) {
+			break;
+		}
+
+		pos += len;
+
+		XMLNode const* delta = record.root ();
+		uint32_t g;
+
+		if (!delta || delta->name () != X_("Delta") || !delta->get_property (X_("generation"), g) || g != generation) {
+			continue;
+		}
+
+		if (!apply_delta (root, *delta)) {
+			error << string_compose (_("Session journal %1 does not match the session state"), path) << endmsg;
+			return -1;
+		}
+
+		++n;
+	}
+
+	return n;
+}
@@ -0,0 +1,240 @@
+#include <cmath>
+#include <vector>
+
+#include <glibmm/timer.h>
+
+#include "ardour/amp.h"
+#include "ardour/audio_buffer.h"
+#include "ardour/automation_list.h"
+#include "ardour/buffer_set.h"
+#include "ardour/gain_control.h"
+#include "ardour/phase_control.h"
+#include "ardour/polarity_processor.h"
+#include "ardour/route.h"
+#include "ardour/session.h"
+
+#include "fused_gain_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (FusedGainTest);
+
+using namespace std;
+using namespace ARDOUR;
+using namespace Temporal;
+
+static const uint32_t  n_channels = 3;
+static const pframes_t n_samples  = 256;
+
+/** Polarity, trim and fader of a route, sharing the route's controls */
+class GainStages
+{
+public:
+	GainStages (Session& s, boost::shared_ptr<PhaseControl> phase_control, boost::shared_ptr<GainControl> trim_control, boost::shared_ptr<GainControl> gain_control)
+		: polarity (new PolarityProcessor (s, phase_control))
+		, trim (new Amp (s, "Trim", trim_control, false))
+		, amp (new Amp (s, "Fader", gain_control, true))
+		, trim_automation (n_samples)
+		, amp_automation (n_samples)
+	{
+		stages.push_back (polarity);
+		stages.push_back (trim);
+		stages.push_back (amp);
+
+		const ChanCount chn (DataType::AUDIO, n_channels);
+		for (vector<boost::shared_ptr<Processor> >::const_iterator i = stages.begin (); i != stages.end (); ++i) {
+			CPPUNIT_ASSERT ((*i)->configure_io (chn, chn));
+			(*i)->activate ();
+		}
+
+		trim->set_gain_automation_buffer (&trim_automation[0]);
+		amp->set_gain_automation_buffer (&amp_automation[0]);
+	}
+
+	void setup_gain_automation (samplepos_t start)
+	{
+		trim->setup_gain_automation (start, start + n_samples, n_samples);
+		amp->setup_gain_automation (start, start + n_samples, n_samples);
+	}
+
+	void run (BufferSet& bufs, samplepos_t start)
+	{
+		for (vector<boost::shared_ptr<Processor> >::const_iterator i = stages.begin (); i != stages.end (); ++i) {
+			(*i)->run (bufs, start, start + n_samples, 1.0, n_samples, true);
+		}
+	}
+
+	boost::shared_ptr<PolarityProcessor> polarity;
+	boost::shared_ptr<Amp>               trim;
+	boost::shared_ptr<Amp>               amp;
+
+	vector<boost::shared_ptr<Processor> > stages;
+
+private:
+	vector<gain_t> trim_automation;
+	vector<gain_t> amp_automation;
+};
+
+void
+FusedGainTest::setUp ()
+{
+	TestNeedingSession::setUp ();
+
+	_phase_control.reset (new PhaseControl (*_session, "phase", AudioTime));
+	_trim_control.reset (new GainControl (*_session, TrimAutomation));
+	_gain_control.reset (new GainControl (*_session, GainAutomation));
+
+	_separate = new GainStages (*_session, _phase_control, _trim_control, _gain_control);
+	_fused    = new GainStages (*_session, _phase_control, _trim_control, _gain_control);
+	_position = 0;
+}
+
+void
+FusedGainTest::tearDown ()
+{
+	delete _separate;
+	delete _fused;
+	_phase_control.reset ();
+	_trim_control.reset ();
+	_gain_control.reset ();
+
+	TestNeedingSession::tearDown ();
+}
+
+/** Process @p n_cycles cycles with both sets of stages, like a route does,
+ *  and compare the results sample by sample.
+ *  @return the number of cycles that were processed in a single pass
+ */
+int
+FusedGainTest::compare (int n_cycles, bool automation)
+{
+	const ChanCount chn (DataType::AUDIO, n_channels);
+
+	BufferSet separate;
+	BufferSet fused;
+	separate.ensure_buffers (chn, n_samples);
+	fused.ensure_buffers (chn, n_samples);
+	separate.set_count (chn);
+	fused.set_count (chn);
+
+	vector<gain_t> curve (n_samples);
+	int n_fused = 0;
+
+	for (int c = 0; c < n_cycles; ++c, _position += n_samples) {
+
+		for (uint32_t n = 0; n < n_channels; ++n) {
+			Sample* s = separate.get_audio (n).data ();
+			Sample* f = fused.get_audio (n).data ();
+			for (pframes_t i = 0; i < n_samples; ++i) {
+				s[i] = f[i] = sinf (0.01f * (n + 1) * (_position + i));
+			}
+		}
+
+		if (automation) {
+			_separate->setup_gain_automation (_position);
+			_fused->setup_gain_automation (_position);
+		}
+
+		_separate->run (separate, _position);
+
+		if (Route::apply_fused_gain_stages (fused, _fused->stages, &curve[0], n_samples)) {
+			++n_fused;
+		} else {
+			_fused->run (fused, _position);
+		}
+
+		for (uint32_t n = 0; n < n_channels; ++n) {
+			Sample const* s = separate.get_audio (n).data ();
+			Sample const* f = fused.get_audio (n).data ();
+			for (pframes_t i = 0; i < n_samples; ++i) {
+				CPPUNIT_ASSERT_DOUBLES_EQUAL (s[i], f[i], 1e-5);
+			}
+			CPPUNIT_ASSERT_EQUAL (_separate->polarity->fused_gain (n), _fused->polarity->fused_gain (n));
+		}
+
+		CPPUNIT_ASSERT_EQUAL (_separate->trim->current_gain (), _fused->trim->current_gain ());
+		CPPUNIT_ASSERT_EQUAL (_separate->amp->current_gain (), _fused->amp->current_gain ());
+	}
+
+	return n_fused;
+}
+
+void
+FusedGainTest::constantGainTest ()
+{
+	_trim_control->set_value (2.0, PBD::Controllable::NoGroup);
+	_gain_control->set_value (0.5, PBD::Controllable::NoGroup);
+
+	/* the fader fades in from silence first */
+	CPPUNIT_ASSERT_EQUAL (32, compare (32, false));
+
+	CPPUNIT_ASSERT_EQUAL ((gain_t) 2.0, _fused->trim->current_gain ());
+	CPPUNIT_ASSERT_EQUAL ((gain_t) 0.5, _fused->amp->current_gain ());
+
+	CPPUNIT_ASSERT_EQUAL (8, compare (8, false));
+}
+
+void
+FusedGainTest::declickTest ()
+{
+	_gain_control->set_value (0.5, PBD::Controllable::NoGroup);
+	compare (32, false);
+	CPPUNIT_ASSERT_EQUAL ((gain_t) 0.5, _fused->amp->current_gain ());
+
+	/* trim and fader both fade to their new gain */
+	_trim_control->set_value (0.25, PBD::Controllable::NoGroup);
+	_gain_control->set_value (1.5, PBD::Controllable::NoGroup);
+
+	CPPUNIT_ASSERT_EQUAL (4, compare (4, false));
+	CPPUNIT_ASSERT (_fused->trim->current_gain () != 0.25f);
+	CPPUNIT_ASSERT (_fused->amp->current_gain () != 1.5f);
+
+	CPPUNIT_ASSERT_EQUAL (32, compare (32, false));
+}
+
+void
+FusedGainTest::automationTest ()
+{
+	/* gain automation is only played back while rolling */
+	_session->request_roll ();
+	for (int i = 0; i < 200 && !_session->transport_rolling (); ++i) {
+		Glib::usleep (10000);
+	}
+	CPPUNIT_ASSERT (_session->transport_rolling ());
+
+	boost::shared_ptr<AutomationList> al = _gain_control->alist ();
+	al->add (timepos_t (0), 0.1, false, false);
+	al->add (timepos_t (4 * n_samples), 1.5, false, false);
+	al->add (timepos_t (6 * n_samples), 0.7, false, false);
+	al->set_automation_state (Play);
+
+	_trim_control->set_value (0.5, PBD::Controllable::NoGroup);
+
+	CPPUNIT_ASSERT_EQUAL (16, compare (16, true));
+
+	/* and with trim automation, too */
+	al = _trim_control->alist ();
+	al->add (timepos_t (_position), 2.0, false, false);
+	al->add (timepos_t (_position + 3 * n_samples), 0.5, false, false);
+	al->set_automation_state (Play);
+
+	CPPUNIT_ASSERT_EQUAL (8, compare (8, true));
+}
+
+void
+FusedGainTest::polarityTest ()
+{
+	_phase_control->set_phase_invert (0, true);
+	_phase_control->set_phase_invert (2, true);
+	_gain_control->set_value (0.5, PBD::Controllable::NoGroup);
+
+	/* the polarity switch fades, during which stages run one by one */
+	const int n_fused = compare (32, false);
+	CPPUNIT_ASSERT (n_fused > 0 && n_fused < 32);
+
+	CPPUNIT_ASSERT_EQUAL ((gain_t) -1.0, _fused->polarity->fused_gain (0));
+	CPPUNIT_ASSERT_EQUAL ((gain_t) 1.0, _fused->polarity->fused_gain (1));
+	CPPUNIT_ASSERT_EQUAL ((gain_t) -1.0, _fused->polarity->fused_gain (2));
+
+	/* with a de-click of the fader */
+	_gain_control->set_value (1.0, PBD::Controllable::NoGroup);
+	CPPUNIT_ASSERT_EQUAL (8, compare (8, false));
+}
@@ -0,0 +1,44 @@
+#include <boost/shared_ptr.hpp>
+
+#include "ardour/types.h"
+
+#include "test_needing_session.h"
+
+namespace ARDOUR {
+	class GainControl;
+	class PhaseControl;
+}
+
+class GainStages;
+
+class FusedGainTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (FusedGainTest);
+	CPPUNIT_TEST (constantGainTest);
+	CPPUNIT_TEST (declickTest);
+	CPPUNIT_TEST (automationTest);
+	CPPUNIT_TEST (polarityTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void constantGainTest ();
+	void declickTest ();
+	void automationTest ();
+	void polarityTest ();
+
+private:
+	int compare (int n_cycles, bool automation);
+
+	boost::shared_ptr<ARDOUR::PhaseControl> _phase_control;
+	boost::shared_ptr<ARDOUR::GainControl>  _trim_control;
+	boost::shared_ptr<ARDOUR::GainControl>  _gain_control;
+
+	/* the same stages, run one by one and fused */
+	GainStages* _separate;
+	GainStages* _fused;
+
+	ARDOUR::samplepos_t _position;
+};
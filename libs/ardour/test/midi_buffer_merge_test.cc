@@ -0,0 +1,183 @@
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+
+#include "evoral/midi_events.h"
+
+#include "ardour/midi_buffer.h"
+#include "midi_buffer_merge_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (MidiBufferMergeTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+static void
+push_note (MidiBuffer& buf, MidiBuffer::TimeType t, uint8_t status, uint8_t note)
+{
+	uint8_t data[3] = { status, note, 0x40 };
+	CPPUNIT_ASSERT (buf.push_back (t, Evoral::MIDI_EVENT, 3, data));
+}
+
+static void
+push_event (MidiBuffer& buf, MidiBuffer::TimeType t, uint8_t status, uint8_t value)
+{
+	uint8_t data[3] = { status, value, 0x40 };
+	CPPUNIT_ASSERT (buf.push_back (t, Evoral::MIDI_EVENT, Evoral::midi_event_size (status), data));
+}
+
+static void
+assert_equal (MidiBuffer const& a, MidiBuffer const& b)
+{
+	CPPUNIT_ASSERT_EQUAL (a.size (), b.size ());
+	CPPUNIT_ASSERT (memcmp (a.data (), b.data (), a.size ()) == 0);
+}
+
+void
+MidiBufferMergeTest::orderTest ()
+{
+	MidiBuffer a (1024);
+	MidiBuffer b (1024);
+	MidiBuffer c (1024);
+	MidiBuffer out (1024);
+
+	push_note (a, 0, 0x90, 1);
+	push_note (a, 10, 0x90, 2);
+	push_note (b, 5, 0x90, 3);
+	push_note (c, 7, 0x90, 4);
+	push_note (c, 20, 0x90, 5);
+
+	MidiBufferMerger merger;
+	merger.add (a);
+	merger.add (b);
+	merger.add (c);
+	CPPUNIT_ASSERT (out.read_from (merger));
+
+	MidiBuffer::TimeType expected[] = { 0, 5, 7, 10, 20 };
+	uint8_t notes[] = { 1, 3, 4, 2, 5 };
+	int n = 0;
+
+	for (MidiBuffer::iterator i = out.begin (); i != out.end (); ++i, ++n) {
+		CPPUNIT_ASSERT (n < 5);
+		CPPUNIT_ASSERT_EQUAL (expected[n], (*i).time ());
+		CPPUNIT_ASSERT_EQUAL (notes[n], (*i).buffer ()[1]);
+	}
+
+	CPPUNIT_ASSERT_EQUAL (5, n);
+}
+
+void
+MidiBufferMergeTest::simultaneousTest ()
+{
+	MidiBuffer a (1024);
+	MidiBuffer b (1024);
+	MidiBuffer out (1024);
+
+	/* note-off must come before note-on at the same time */
+	push_note (a, 0, 0x90, 60);
+	push_note (b, 0, 0x80, 60);
+
+	MidiBufferMerger merger;
+	merger.add (a);
+	merger.add (b);
+	CPPUNIT_ASSERT (out.read_from (merger));
+
+	MidiBuffer::iterator i = out.begin ();
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 0x80, (*i).buffer ()[0]);
+	++i;
+	CPPUNIT_ASSERT_EQUAL ((uint8_t) 0x90, (*i).buffer ()[0]);
+}
+
+void
+MidiBufferMergeTest::compareWithMergeInPlaceTest ()
+{
+	const int n_sources = 16;
+	MidiBuffer* src[n_sources];
+
+	/* in the order of MidiBuffer::second_simultaneous_midi_byte_is_first () */
+	const uint8_t types[] = { 0xb0, 0xc0, 0x80, 0x90 };
+
+	srand (42);
+
+	/* many simultaneous events, on two channels. The first data byte
+	 * tells the source of an event.
+	 */
+	for (int s = 0; s < n_sources; ++s) {
+		src[s] = new MidiBuffer (4096);
+		MidiBuffer::TimeType t = 0;
+		int type = 0;
+		for (int e = 0; e < 32; ++e) {
+			const int dt = rand () % 4;
+			t += dt;
+			/* sources are valid buffers, ordered by type at the same time */
+			type = dt ? rand () % 4 : type + rand () % (4 - type);
+			push_event (*src[s], t, types[type] | (rand () & 1), s);
+		}
+	}
+
+	MidiBuffer reference (n_sources * 4096);
+	MidiBuffer merged (n_sources * 4096);
+	MidiBufferMerger merger;
+
+	for (int s = 0; s < n_sources; ++s) {
+		CPPUNIT_ASSERT (reference.merge_in_place (*src[s]));
+		CPPUNIT_ASSERT (merger.add (*src[s]));
+	}
+
+	CPPUNIT_ASSERT (merged.read_from (merger));
+	CPPUNIT_ASSERT_EQUAL (reference.size (), merged.size ());
+
+	/* merge_in_place() only orders an event with respect to one of the
+	 * simultaneous events already in the buffer, so simultaneous events
+	 * may be in a different order there. Compare the events of each time
+	 * in step, regardless of their order ...
+	 */
+	MidiBuffer::iterator r = reference.begin ();
+	MidiBuffer::iterator m = merged.begin ();
+
+	while (r != reference.end ()) {
+		CPPUNIT_ASSERT (m != merged.end ());
+
+		const MidiBuffer::TimeType t = (*r).time ();
+		std::multiset<std::string> ours;
+		std::multiset<std::string> theirs;
+
+		for (; r != reference.end () && (*r).time () == t; ++r) {
+			theirs.insert (std::string ((char const*) (*r).buffer (), (*r).size ()));
+		}
+		for (; m != merged.end () && (*m).time () == t; ++m) {
+			ours.insert (std::string ((char const*) (*m).buffer (), (*m).size ()));
+		}
+
+		CPPUNIT_ASSERT (ours == theirs);
+	}
+
+	CPPUNIT_ASSERT (m == merged.end ());
+
+	/* ... and check the order of simultaneous events from different
+	 * sources in the merged buffer.
+	 */
+	for (MidiBuffer::iterator i = merged.begin (); i != merged.end (); ++i) {
+		MidiBuffer::iterator j = i;
+		for (++j; j != merged.end () && (*j).time () == (*i).time (); ++j) {
+			const uint8_t* a = (*i).buffer ();
+			const uint8_t* b = (*j).buffer ();
+			if (a[1] == b[1]) {
+				continue;
+			}
+			/* b is after a, it must not need to precede it */
+			CPPUNIT_ASSERT (!MidiBuffer::second_simultaneous_midi_byte_is_first (a[0], b[0]) || MidiBuffer::second_simultaneous_midi_byte_is_first (b[0], a[0]));
+		}
+	}
+
+	/* a single source is copied verbatim */
+	merger.clear ();
+	merger.add (*src[0]);
+	CPPUNIT_ASSERT (merged.read_from (merger));
+	assert_equal (*src[0], merged);
+
+	for (int s = 0; s < n_sources; ++s) {
+		delete src[s];
+	}
+}
@@ -0,0 +1,20 @@
+#include <sigc++/sigc++.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class MidiBufferMergeTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (MidiBufferMergeTest);
+	CPPUNIT_TEST (orderTest);
+	CPPUNIT_TEST (simultaneousTest);
+	CPPUNIT_TEST (compareWithMergeInPlaceTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp () {}
+	void tearDown () {}
+
+	void orderTest ();
+	void simultaneousTest ();
+	void compareWithMergeInPlaceTest ();
+};
@@ -0,0 +1,176 @@
+#include <glib.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/file_utils.h"
+#include "pbd/xml++.h"
+
+#include "ardour/plugin_index.h"
+#include "plugin_index_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PluginIndexTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+void
+PluginIndexTest::setUp ()
+{
+	gchar* dir = g_dir_make_tmp ("plugin_index_test-XXXXXX", NULL);
+	CPPUNIT_ASSERT (dir);
+	_dir = dir;
+	g_free (dir);
+	_index = Glib::build_filename (_dir, "plugin_index.bin");
+}
+
+void
+PluginIndexTest::tearDown ()
+{
+	PBD::remove_directory (_dir);
+}
+
+/* write a cache file, similar to what vst2_scan_and_cache () does */
+string
+PluginIndexTest::write_cache_file (string const& name, int n_plugins)
+{
+	XMLNode* root = new XMLNode ("VST2Cache");
+	root->set_property ("version", 1);
+	root->set_property ("binary", string_compose ("/usr/lib/vst/%1.so", name));
+	root->set_property ("arch", "x86_64");
+
+	for (int i = 0; i < n_plugins; ++i) {
+		XMLNode* p = root->add_child ("VST2Info");
+		p->set_property ("id", i);
+		p->set_property ("name", string_compose ("%1 <%2> & \"more\"", name, i));
+		p->set_property ("category", "Effect");
+		p->add_content ("some content");
+	}
+
+	string path = Glib::build_filename (_dir, name + ".v2i");
+
+	XMLTree tree;
+	tree.set_root (root);
+	CPPUNIT_ASSERT (tree.write (path));
+	return path;
+}
+
+void
+PluginIndexTest::roundTripTest ()
+{
+	string a = write_cache_file ("a", 3);
+	string b = write_cache_file ("b", 1);
+
+	XMLTree ref_a;
+	XMLTree ref_b;
+	CPPUNIT_ASSERT (ref_a.read (a));
+	CPPUNIT_ASSERT (ref_b.read (b));
+
+	{
+		PluginIndex index;
+		index.load (_index);
+		CPPUNIT_ASSERT_EQUAL (size_t (0), index.size ());
+
+		XMLTree tree;
+		CPPUNIT_ASSERT (index.read (a, tree));
+		CPPUNIT_ASSERT (*tree.root () == *ref_a.root ());
+		CPPUNIT_ASSERT (index.read (b, tree));
+		CPPUNIT_ASSERT (*tree.root () == *ref_b.root ());
+		CPPUNIT_ASSERT_EQUAL (size_t (2), index.n_parsed ());
+		CPPUNIT_ASSERT_EQUAL (0, index.save ());
+	}
+
+	PluginIndex index;
+	index.load (_index);
+	CPPUNIT_ASSERT_EQUAL (size_t (2), index.size ());
+
+	/* read from the index, no parsing */
+	XMLTree tree;
+	CPPUNIT_ASSERT (index.read (a, tree));
+	CPPUNIT_ASSERT (*tree.root () == *ref_a.root ());
+	CPPUNIT_ASSERT (index.read (b, tree));
+	CPPUNIT_ASSERT (*tree.root () == *ref_b.root ());
+	CPPUNIT_ASSERT_EQUAL (size_t (0), index.n_parsed ());
+
+	/* forced re-read */
+	CPPUNIT_ASSERT (index.read (a, tree, true));
+	CPPUNIT_ASSERT_EQUAL (size_t (1), index.n_parsed ());
+	CPPUNIT_ASSERT (*tree.root () == *ref_a.root ());
+}
+
+void
+PluginIndexTest::invalidateTest ()
+{
+	string a = write_cache_file ("a", 3);
+	string b = write_cache_file ("b", 1);
+
+	{
+		PluginIndex index;
+		index.load (_index);
+		XMLTree tree;
+		CPPUNIT_ASSERT (index.read (a, tree));
+		CPPUNIT_ASSERT (index.read (b, tree));
+		index.save ();
+	}
+
+	/* a plugin was re-scanned, its cache file changed */
+	write_cache_file ("a", 5);
+
+	{
+		PluginIndex index;
+		index.load (_index);
+
+		XMLTree tree;
+		CPPUNIT_ASSERT (index.read (a, tree));
+		CPPUNIT_ASSERT_EQUAL (size_t (1), index.n_parsed ());
+		CPPUNIT_ASSERT_EQUAL (size_t (5), tree.root ()->children ().size ());
+
+		/* b is not used anymore, and dropped */
+		index.save ();
+	}
+
+	PluginIndex index;
+	index.load (_index);
+	CPPUNIT_ASSERT_EQUAL (size_t (1), index.size ());
+
+	XMLTree tree;
+	CPPUNIT_ASSERT (index.read (a, tree));
+	CPPUNIT_ASSERT_EQUAL (size_t (0), index.n_parsed ());
+	CPPUNIT_ASSERT_EQUAL (size_t (5), tree.root ()->children ().size ());
+
+	/* missing cache file */
+	::g_unlink (a.c_str ());
+	CPPUNIT_ASSERT (!index.read (a, tree));
+}
+
+void
+PluginIndexTest::corruptIndexTest ()
+{
+	string a = write_cache_file ("a", 3);
+
+	{
+		PluginIndex index;
+		index.load (_index);
+		XMLTree tree;
+		CPPUNIT_ASSERT (index.read (a, tree));
+		index.save ();
+	}
+
+	/* truncate the index */
+	string data = Glib::file_get_contents (_index);
+	Glib::file_set_contents (_index, data.substr (0, data.size () - 10));
+
+	PluginIndex index;
+	index.load (_index);
+	CPPUNIT_ASSERT_EQUAL (size_t (0), index.size ());
+
+	XMLTree tree;
+	CPPUNIT_ASSERT (index.read (a, tree));
+	CPPUNIT_ASSERT_EQUAL (size_t (1), index.n_parsed ());
+	CPPUNIT_ASSERT_EQUAL (size_t (3), tree.root ()->children ().size ());
+
+	/* garbage */
+	Glib::file_set_contents (_index, "not an index");
+	index.load (_index);
+	CPPUNIT_ASSERT_EQUAL (size_t (0), index.size ());
+}
@@ -0,0 +1,26 @@
+#include <sigc++/sigc++.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class PluginIndexTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (PluginIndexTest);
+	CPPUNIT_TEST (roundTripTest);
+	CPPUNIT_TEST (invalidateTest);
+	CPPUNIT_TEST (corruptIndexTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void roundTripTest ();
+	void invalidateTest ();
+	void corruptIndexTest ();
+
+private:
+	std::string write_cache_file (std::string const& name, int n_plugins);
+
+	std::string _dir;
+	std::string _index;
+};
@@ -0,0 +1,153 @@
+#include <glib.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+#include <glibmm/timer.h>
+
+#include "pbd/compose.h"
+#include "pbd/file_utils.h"
+
+#include "ardour/plugin_scan_queue.h"
+#include "plugin_scan_queue_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PluginScanQueueTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+/* The "plugins" are shell-scripts, and the "scanner" is the shell.
+ * This allows to test the queue without any real plugin or scanner app.
+ */
+
+static const char* shell = "/bin/sh";
+
+void
+PluginScanQueueTest::setUp ()
+{
+	gchar* dir = g_dir_make_tmp ("plugin_scan_queue_test-XXXXXX", NULL);
+	CPPUNIT_ASSERT (dir);
+	_dir = dir;
+	g_free (dir);
+}
+
+void
+PluginScanQueueTest::tearDown ()
+{
+	PBD::remove_directory (_dir);
+}
+
+string
+PluginScanQueueTest::fake_plugin (string const& name, string const& script)
+{
+	string path = Glib::build_filename (_dir, name);
+	Glib::file_set_contents (path, script);
+	return path;
+}
+
+static void
+add_job (PluginScanQueue& q, string const& path)
+{
+	q.add (path, shell, vector<string> (1, path));
+}
+
+/* drive the queue like PluginManager does */
+static void
+run (PluginScanQueue& q)
+{
+	while (q.process ()) {
+		Glib::usleep (100000);
+	}
+}
+
+void
+PluginScanQueueTest::concurrencyTest ()
+{
+#ifndef PLATFORM_WINDOWS
+	PluginScanQueue q (3, 0);
+
+	for (int i = 0; i < 6; ++i) {
+		add_job (q, fake_plugin (string_compose ("slow%1", i), "sleep 1\necho scanned\n"));
+	}
+
+	/* the first tick starts as many scans as allowed, no more */
+	CPPUNIT_ASSERT (q.process ());
+	CPPUNIT_ASSERT_EQUAL (size_t (3), q.n_running ());
+
+	run (q);
+
+	CPPUNIT_ASSERT_EQUAL (size_t (6), q.n_done ());
+	CPPUNIT_ASSERT_EQUAL (size_t (3), q.max_concurrency ());
+
+	vector<string> paths (q.paths ());
+	for (vector<string>::const_iterator i = paths.begin (); i != paths.end (); ++i) {
+		CPPUNIT_ASSERT_EQUAL (PluginScanQueue::Done, q.result (*i));
+		CPPUNIT_ASSERT (q.log (*i).find ("scanned") != string::npos);
+	}
+#endif
+}
+
+void
+PluginScanQueueTest::failureTest ()
+{
+#ifndef PLATFORM_WINDOWS
+	PluginScanQueue q (4, 10); /* 1 sec timeout */
+
+	string good1 = fake_plugin ("good1", "echo good1\n");
+	string crash = fake_plugin ("crash", "echo crashing\nkill -SEGV $$\n");
+	string hang  = fake_plugin ("hang", "sleep 30\n");
+	string good2 = fake_plugin ("good2", "sleep 0.5\necho good2\n");
+
+	add_job (q, good1);
+	add_job (q, crash);
+	add_job (q, hang);
+	add_job (q, good2);
+
+	run (q);
+
+	CPPUNIT_ASSERT_EQUAL (size_t (4), q.n_done ());
+	CPPUNIT_ASSERT_EQUAL (size_t (4), q.max_concurrency ());
+
+	CPPUNIT_ASSERT_EQUAL (PluginScanQueue::Done, q.result (good1));
+	CPPUNIT_ASSERT_EQUAL (PluginScanQueue::Done, q.result (good2));
+	CPPUNIT_ASSERT_EQUAL (PluginScanQueue::TimedOut, q.result (hang));
+	/* a crash is detected by the missing cache file */
+	CPPUNIT_ASSERT_EQUAL (PluginScanQueue::Done, q.result (crash));
+
+	CPPUNIT_ASSERT (q.log (good1).find ("good1") != string::npos);
+	CPPUNIT_ASSERT (q.log (good2).find ("good2") != string::npos);
+	CPPUNIT_ASSERT (q.log (crash).find ("good") == string::npos);
+#endif
+}
+
+void
+PluginScanQueueTest::cancelTest ()
+{
+#ifndef PLATFORM_WINDOWS
+	PluginScanQueue q (2, 0);
+
+	vector<string> hangs;
+	for (int i = 0; i < 5; ++i) {
+		hangs.push_back (fake_plugin (string_compose ("hang%1", i), "sleep 30\n"));
+		add_job (q, hangs.back ());
+	}
+
+	CPPUNIT_ASSERT (q.process ());
+	CPPUNIT_ASSERT_EQUAL (size_t (2), q.n_running ());
+
+	/* cancel_scan_one: running scans are terminated, pending ones continue */
+	q.cancel_running ();
+	CPPUNIT_ASSERT_EQUAL (PluginScanQueue::Cancelled, q.result (hangs[0]));
+	CPPUNIT_ASSERT_EQUAL (PluginScanQueue::Cancelled, q.result (hangs[1]));
+
+	CPPUNIT_ASSERT (q.process ());
+	CPPUNIT_ASSERT_EQUAL (size_t (2), q.n_running ());
+	CPPUNIT_ASSERT_EQUAL (PluginScanQueue::Running, q.result (hangs[2]));
+
+	/* cancel_scan_all: nothing else is started */
+	q.cancel_all ();
+	CPPUNIT_ASSERT (!q.process ());
+	CPPUNIT_ASSERT_EQUAL (size_t (0), q.n_running ());
+	CPPUNIT_ASSERT_EQUAL (PluginScanQueue::Cancelled, q.result (hangs[3]));
+	CPPUNIT_ASSERT_EQUAL (PluginScanQueue::Pending, q.result (hangs[4]));
+	CPPUNIT_ASSERT_EQUAL (size_t (4), q.n_done ());
+#endif
+}
@@ -0,0 +1,25 @@
+#include <sigc++/sigc++.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class PluginScanQueueTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (PluginScanQueueTest);
+	CPPUNIT_TEST (concurrencyTest);
+	CPPUNIT_TEST (failureTest);
+	CPPUNIT_TEST (cancelTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void concurrencyTest ();
+	void failureTest ();
+	void cancelTest ();
+
+private:
+	std::string fake_plugin (std::string const& name, std::string const& script);
+
+	std::string _dir;
+};
@@ -0,0 +1,80 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "pbd/compose.h"
+#include "pbd/timing.h"
+
+#include "ardour/midi_buffer.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static void
+fill (MidiBuffer& buf, int n_events, int nframes, uint8_t channel)
+{
+	buf.clear ();
+	for (int e = 0; e < n_events; ++e) {
+		uint8_t data[3] = { (uint8_t) ((e & 1 ? 0x80 : 0x90) | channel), (uint8_t) (e & 0x7f), 0x40 };
+		buf.push_back ((MidiBuffer::TimeType) (e * nframes / n_events), Evoral::MIDI_EVENT, 3, data);
+	}
+}
+
+static void
+run (int n_sources, int n_events, int cycles)
+{
+	const int nframes = 1024;
+	vector<MidiBuffer*> src;
+
+	for (int s = 0; s < n_sources; ++s) {
+		src.push_back (new MidiBuffer (8192));
+		fill (*src.back (), n_events, nframes, s & 0xf);
+	}
+
+	MidiBuffer dst (n_sources * 8192);
+	PBD::TimingStats merge_in_place;
+	PBD::TimingStats kway;
+
+	for (int c = 0; c < cycles; ++c) {
+		dst.clear ();
+		merge_in_place.start ();
+		for (int s = 0; s < n_sources; ++s) {
+			dst.merge_in_place (*src[s]);
+		}
+		merge_in_place.update ();
+
+		dst.clear ();
+		kway.start ();
+		MidiBufferMerger merger;
+		for (int s = 0; s < n_sources; ++s) {
+			merger.add (*src[s]);
+		}
+		dst.read_from (merger);
+		kway.update ();
+	}
+
+	PBD::microseconds_t min, max;
+	double avg, dev;
+
+	merge_in_place.get_stats (min, max, avg, dev);
+	cout << string_compose ("%1 sources x %2 events: merge_in_place avg %3 us max %4 us\n", n_sources, n_events, avg, max);
+	kway.get_stats (min, max, avg, dev);
+	cout << string_compose ("%1 sources x %2 events: k-way merge    avg %3 us max %4 us\n", n_sources, n_events, avg, max);
+
+	for (vector<MidiBuffer*>::iterator i = src.begin (); i != src.end (); ++i) {
+		delete *i;
+	}
+}
+
+int
+main (int argc, char* argv[])
+{
+	const int cycles = argc > 1 ? atoi (argv[1]) : 1000;
+
+	/* typical: a few busy sends */
+	run (4, 16, cycles);
+	/* stress: many dense sends */
+	run (32, 256, cycles);
+	run (64, 256, cycles);
+
+	return 0;
+}
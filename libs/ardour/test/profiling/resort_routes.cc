@@ -0,0 +1,102 @@
+#include <cstdlib>
+#include <iostream>
+
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/timing.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/io.h"
+#include "ardour/port.h"
+#include "ardour/route.h"
+#include "ardour/session.h"
+
+#include "test_ui.h"
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+/* Connect (or disconnect) the first output of `a' to the first input of `b',
+ * and report it to the session the way a backend would.
+ */
+static void
+reconnect (boost::shared_ptr<Route> a, boost::shared_ptr<Route> b, bool yn)
+{
+	boost::shared_ptr<Port> src = a->output ()->nth (0);
+	boost::shared_ptr<Port> dst = b->input ()->nth (0);
+
+	if (yn) {
+		a->output ()->connect (src, dst->name (), 0);
+	} else {
+		a->output ()->disconnect (src, dst->name (), 0);
+	}
+
+	AudioEngine::instance ()->connect_callback (src->name (), dst->name (), yn);
+}
+
+int
+main (int argc, char* argv[])
+{
+	int const n_routes  = argc > 1 ? atoi (argv[1]) : 1000;
+	int const n_changes = argc > 2 ? atoi (argv[2]) : 100;
+
+	ARDOUR::init (true, localedir);
+	TestUI* test_ui = new TestUI ();
+	create_and_start_dummy_backend ();
+
+	Session* session = load_session (Glib::build_filename (new_test_output_dir ("resort"), "resort_routes"), "resort_routes");
+
+	RouteList rl = session->new_audio_route (1, 1, 0, n_routes, "Bus", PresentationInfo::AudioBus, -1);
+	vector<boost::shared_ptr<Route> > r (rl.begin (), rl.end ());
+
+	/* chain every other bus to the next one */
+	for (int i = 0; i + 1 < n_routes; i += 2) {
+		reconnect (r[i], r[i + 1], true);
+	}
+
+	cout << string_compose ("INFO: %1 routes.\n", session->get_routes ()->size ());
+
+	PBD::TimingStats full;
+	PBD::TimingStats incremental;
+
+	/* The backend reports each change as well, and triggers an incremental
+	 * resort of its own, which usually finds that there is nothing left to do.
+	 */
+	for (int c = 0; c < n_changes; ++c) {
+		/* connect a pair of previously unconnected buses, and disconnect them again */
+		int const i = 1 + 2 * (c % ((n_routes - 1) / 2));
+
+		reconnect (r[i], r[i + 1], true);
+		incremental.start ();
+		session->resort_routes (true);
+		incremental.update ();
+
+		reconnect (r[i], r[i + 1], false);
+		incremental.start ();
+		session->resort_routes (true);
+		incremental.update ();
+
+		full.start ();
+		session->resort_routes ();
+		full.update ();
+	}
+
+	PBD::microseconds_t min, max;
+	double avg, dev;
+
+	full.get_stats (min, max, avg, dev);
+	cout << string_compose ("full resort:        avg %1 us max %2 us\n", avg, max);
+	incremental.get_stats (min, max, avg, dev);
+	cout << string_compose ("incremental resort: avg %1 us max %2 us\n", avg, max);
+
+	delete session;
+	stop_and_destroy_backend ();
+	delete test_ui;
+	ARDOUR::cleanup ();
+	return 0;
+}
@@ -0,0 +1,133 @@
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/gstdio_compat.h"
+#include "pbd/xml++.h"
+
+#include "ardour/state_journal.h"
+#include "state_journal_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (StateJournalTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+static boost::shared_ptr<XMLTree>
+make_tree ()
+{
+	XMLNode* root = new XMLNode ("Session");
+	root->set_property ("name", "test");
+	root->set_property ("version", 7000);
+
+	XMLNode* config = root->add_child ("Config");
+	config->add_child ("Option")->set_property ("value", 1);
+
+	XMLNode* routes = root->add_child ("Routes");
+	for (int i = 1; i <= 3; ++i) {
+		XMLNode* r = routes->add_child ("Route");
+		r->set_property ("id", i);
+		r->set_property ("name", string_compose ("Audio %1", i));
+	}
+
+	root->add_child ("Playlists");
+
+	boost::shared_ptr<XMLTree> tree (new XMLTree);
+	tree->set_root (root);
+	return tree;
+}
+
+static boost::shared_ptr<XMLTree>
+copy_tree (boost::shared_ptr<XMLTree> tree)
+{
+	return boost::shared_ptr<XMLTree> (new XMLTree (tree.get ()));
+}
+
+void
+StateJournalTest::setUp ()
+{
+	_path = Glib::build_filename (Glib::get_tmp_dir (), "state_journal_test.journal");
+}
+
+void
+StateJournalTest::tearDown ()
+{
+	::g_unlink (_path.c_str ());
+}
+
+void
+StateJournalTest::roundTripTest ()
+{
+	StateJournal journal;
+	boost::shared_ptr<XMLTree> base = make_tree ();
+
+	/* without a base, a full save is needed */
+	CPPUNIT_ASSERT_EQUAL (1, journal.append (copy_tree (base), _path));
+
+	journal.set_base (base);
+
+	/* the on-disk base, as written by a full save */
+	boost::shared_ptr<XMLTree> on_disk = copy_tree (base);
+
+	/* nothing changed */
+	CPPUNIT_ASSERT_EQUAL (0, journal.append (copy_tree (base), _path));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 0, journal.n_records ());
+
+	boost::shared_ptr<XMLTree> cur = copy_tree (base);
+	XMLNode* routes = cur->root ()->child ("Routes");
+
+	cur->root ()->set_property ("name", "renamed");
+	cur->root ()->remove_property ("version");
+	cur->root ()->child ("Config")->add_child ("Option")->set_property ("value", 2);
+	routes->children ()[1]->set_property ("name", "Vocals");
+	routes->remove_nodes_and_delete ("id", "3");
+	routes->add_child ("Route")->set_property ("id", 4);
+
+	CPPUNIT_ASSERT_EQUAL (0, journal.append (cur, _path));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, journal.n_records ());
+
+	cur = copy_tree (cur);
+	cur->root ()->child ("Playlists")->add_child ("Playlist")->set_property ("id", 5);
+
+	CPPUNIT_ASSERT_EQUAL (0, journal.append (cur, _path));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 2, journal.n_records ());
+
+	CPPUNIT_ASSERT_EQUAL (2, StateJournal::apply (*on_disk->root (), _path));
+	CPPUNIT_ASSERT (*on_disk->root () == *cur->root ());
+}
+
+void
+StateJournalTest::layoutChangeTest ()
+{
+	StateJournal journal;
+	boost::shared_ptr<XMLTree> base = make_tree ();
+
+	journal.set_base (base);
+
+	boost::shared_ptr<XMLTree> cur = copy_tree (base);
+	cur->root ()->add_child ("Locations");
+
+	CPPUNIT_ASSERT_EQUAL (1, journal.append (cur, _path));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 0, journal.n_records ());
+}
+
+void
+StateJournalTest::generationTest ()
+{
+	StateJournal journal;
+	boost::shared_ptr<XMLTree> base = make_tree ();
+
+	journal.set_base (base);
+
+	boost::shared_ptr<XMLTree> cur = copy_tree (base);
+	cur->root ()->set_property ("name", "changed");
+	CPPUNIT_ASSERT_EQUAL (0, journal.append (cur, _path));
+
+	/* a new base, the journal on disk is stale now */
+	boost::shared_ptr<XMLTree> next = copy_tree (cur);
+	journal.set_base (next);
+
+	boost::shared_ptr<XMLTree> on_disk = copy_tree (next);
+	CPPUNIT_ASSERT_EQUAL (0, StateJournal::apply (*on_disk->root (), _path));
+	CPPUNIT_ASSERT (*on_disk->root () == *next->root ());
+}
@@ -0,0 +1,23 @@
+#include <sigc++/sigc++.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class StateJournalTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (StateJournalTest);
+	CPPUNIT_TEST (roundTripTest);
+	CPPUNIT_TEST (layoutChangeTest);
+	CPPUNIT_TEST (generationTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void roundTripTest ();
+	void layoutChangeTest ();
+	void generationTest ();
+
+private:
+	std::string _path;
+};
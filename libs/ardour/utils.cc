@@ -51,9 +51,13 @@
 #include <glibmm/miscutils.h>
 #include <glibmm/fileutils.h>
 
+#include <boost/bind.hpp>
+
 #include "pbd/cpus.h"
 #include "pbd/control_math.h"
 #include "pbd/error.h"
+#include "pbd/g_atomic_compat.h"
+#include "pbd/pthread_utils.h"
 #include "pbd/xml++.h"
 #include "pbd/basename.h"
 #include "pbd/scoped_file_descriptor.h"
@@ -62,6 +66,7 @@
 
 #include "ardour/utils.h"
 #include "ardour/rc_configuration.h"
+#include "ardour/tempo.h"
 
 #include "pbd/i18n.h"
 
@@ -693,6 +698,57 @@ ARDOUR::how_many_dsp_threads ()
         return num_threads;
 }
 
+static void
+parallel_for_worker (size_t count, boost::function<void (size_t)> const* f, GATOMIC_QUAL gint* next, bool own_thread)
+{
+	if (own_thread) {
+		/* conversions may need a tempo map */
+		Temporal::TempoMap::fetch ();
+	}
+
+	for (;;) {
+		const size_t n = g_atomic_int_add (next, 1);
+		if (n >= count) {
+			break;
+		}
+		(*f) (n);
+	}
+}
+
+void
+ARDOUR::parallel_for (size_t count, boost::function<void (size_t)> const& f, uint32_t max_threads, size_t min_per_thread)
+{
+	if (count == 0) {
+		return;
+	}
+
+	if (max_threads == 0) {
+		max_threads = hardware_concurrency ();
+	}
+
+	const size_t n_threads = max ((size_t) 1, min ((size_t) max_threads, count / max (min_per_thread, (size_t) 1)));
+
+	GATOMIC_QUAL gint next = 0;
+	vector<PBD::Thread*> threads;
+
+	for (size_t i = 1; i < n_threads; ++i) {
+		PBD::Thread* t = PBD::Thread::create (boost::bind (&parallel_for_worker, count, &f, &next, true), "ParallelFor");
+		if (t) {
+			threads.push_back (t);
+		}
+	}
+
+	/* the calling thread takes its share, and does all the work if no
+	 * thread could be created.
+	 */
+	parallel_for_worker (count, &f, &next, false);
+
+	for (vector<PBD::Thread*>::iterator t = threads.begin (); t != threads.end (); ++t) {
+		(*t)->join ();
+		delete *t;
+	}
+}
+
 double
 ARDOUR::gain_to_slider_position_with_max (double g, double max_gain)
 {
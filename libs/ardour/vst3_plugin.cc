@@ -598,6 +598,13 @@ VST3Plugin::plugin_latency () const
 	return _plug->plugin_latency ();
 }
 
+samplecnt_t
+VST3Plugin::signal_tailtime () const
+{
+	uint32_t tail = _plug->plugin_tailtime ();
+	return tail == Vst::kInfiniteTail ? max_samplecnt : tail;
+}
+
 void
 VST3Plugin::add_slave (boost::shared_ptr<Plugin> p, bool rt)
 {
@@ -1537,6 +1544,7 @@ VST3PI::activate ()
 	}
 
 	_plugin_latency.reset ();
+	_plugin_tailtime.reset ();
 	_is_processing = true;
 	return true;
 }
@@ -1575,6 +1583,15 @@ VST3PI::plugin_latency ()
 	return _plugin_latency.value ();
 }
 
+uint32_t
+VST3PI::plugin_tailtime ()
+{
+	if (!_plugin_tailtime) {
+		_plugin_tailtime = _processor->getTailSamples ();
+	}
+	return _plugin_tailtime.value ();
+}
+
 void
 VST3PI::set_owner (SessionObject* o)
 {
@@ -0,0 +1,174 @@
+#ifndef AUDIOGRAPHER_MAPPED_TMP_FILE_H
+#define AUDIOGRAPHER_MAPPED_TMP_FILE_H
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+#include <boost/format.hpp>
+
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+#include "pbd/signals.h"
+
+#include "audiographer/flag_debuggable.h"
+#include "audiographer/sink.h"
+#include "audiographer/throwing.h"
+#include "audiographer/utils/listed_source.h"
+
+namespace AudioGrapher
+{
+
+/** A temporary file of raw samples, deleted after this class is destructed.
+ *
+ * Data is written without any encoding. Once the end of input was written,
+ * the file is mapped into memory and read() passes the mapped data on to
+ * the outputs without copying it.
+ */
+template<typename T = DefaultSampleType>
+class MappedTmpFile
+	: public ListedSource<T>
+	, public Sink<T>
+	, public Throwing<>
+	, public FlagDebuggable<>
+{
+  public:
+
+	/// \a filename_template must match the requirements for mkstemp, i.e. end in "XXXXXX"
+	MappedTmpFile (char * filename_template, ChannelCount channels)
+		: _channels (channels)
+		, _file (0)
+		, _map (0)
+		, _samples_written (0)
+		, _read_pos (0)
+	{
+		int fd = g_mkstemp (filename_template);
+		if (fd >= 0) {
+			g_close (fd, NULL);
+			_filename = filename_template;
+			_file = g_fopen (_filename.c_str (), "wb");
+		}
+		if (!_file) {
+			throw Exception (*this, boost::str (boost::format
+				("Could not create temporary file (%1%)") % filename_template));
+		}
+		/* data arrives in process-cycle sized chunks, write it in larger ones */
+		setvbuf (_file, NULL, _IOFBF, 1 << 20);
+		add_supported_flag (ProcessContext<T>::EndOfInput);
+	}
+
+	~MappedTmpFile ()
+	{
+		/* unmap and close first, some OS cannot delete files that are still open */
+		if (_map) {
+			g_mapped_file_unref (_map);
+		}
+		if (_file) {
+			fclose (_file);
+		}
+		if (!_filename.empty ()) {
+			std::remove (_filename.c_str ());
+		}
+	}
+
+	samplecnt_t get_samples_written () const { return _samples_written; }
+
+	/// Writes data to file, and maps it at the end of input
+	void process (ProcessContext<T> const & c)
+	{
+		check_flags (*this, c);
+
+		if (throw_level (ThrowStrict) && c.channels () != _channels) {
+			throw Exception (*this, boost::str (boost::format
+				("Wrong number of channels given to process(), %1% instead of %2%")
+				% c.channels () % _channels));
+		}
+
+		if (_file) {
+			samplecnt_t const written = fwrite (c.data (), sizeof (T), c.samples (), _file);
+			_samples_written += written;
+
+			if (throw_level (ThrowProcess) && written != c.samples ()) {
+				throw Exception (*this, "Could not write data to temporary file");
+			}
+		}
+
+		if (c.has_flag (ProcessContext<T>::EndOfInput)) {
+			map ();
+			FileWritten (_filename);
+		}
+	}
+
+	using Sink<T>::process;
+
+	/** Pass the next \a samples samples on to the outputs.
+	 *  The data is not copied, outputs see the mapped file.
+	 *  \return number of samples read
+	 */
+	samplecnt_t read (samplecnt_t samples)
+	{
+		if (throw_level (ThrowStrict) && samples % _channels != 0) {
+			throw Exception (*this, boost::str (boost::format
+				("Number of samples given to read() is not a multiple of channels, %1% samples, %2% channels")
+				% samples % _channels));
+		}
+
+		samplecnt_t const samples_read = std::max<samplecnt_t> (0, std::min (samples, _samples_written - _read_pos));
+		T* data = _map ? (T*) g_mapped_file_get_contents (_map) + _read_pos : 0;
+
+		ProcessContext<T> c_out (data, samples_read, _channels);
+		if (samples_read < samples) {
+			c_out.set_flag (ProcessContext<T>::EndOfInput);
+		}
+
+		_read_pos += samples_read;
+		this->output (c_out);
+		return samples_read;
+	}
+
+	/// Restart reading at the beginning of the file
+	void rewind () { _read_pos = 0; }
+
+	PBD::Signal1<void, std::string> FileWritten;
+
+  private:
+	void map ()
+	{
+		if (!_file) {
+			return;
+		}
+
+		int const err_close = fclose (_file);
+		_file = 0;
+
+		if (err_close) {
+			_samples_written = 0;
+			throw Exception (*this, "Could not write data to temporary file");
+		}
+
+		/* a private, writable mapping, outputs may modify the data in place */
+		GError* err = NULL;
+		_map = g_mapped_file_new (_filename.c_str (), true, &err);
+
+		if (!_map) {
+			std::string const msg (err->message);
+			g_error_free (err);
+			_samples_written = 0;
+			throw Exception (*this, boost::str (boost::format
+				("Could not map temporary file (%1%)") % msg));
+		}
+	}
+
+	std::string  _filename;
+	ChannelCount _channels;
+	FILE*        _file;
+	GMappedFile* _map;
+	samplecnt_t  _samples_written;
+	samplecnt_t  _read_pos;
+
+	MappedTmpFile (MappedTmpFile const &);
+};
+
+} // namespace
+
+#endif // AUDIOGRAPHER_MAPPED_TMP_FILE_H
@@ -6,6 +6,10 @@
 #include "audiographer/utils/listed_source.h"
 #include "private/gdither/gdither_types.h"
 
+namespace AudioGrapherDSP {
+	class SampleConverter;
+}
+
 namespace AudioGrapher
 {
 
@@ -59,6 +63,7 @@ class LIBAUDIOGRAPHER_API SampleFormatConverter
 
 	ChannelCount channels;
 	GDither      dither;
+	AudioGrapherDSP::SampleConverter* converter; // used instead of gdither for common formats
 	samplecnt_t   data_out_size;
 	TOut *       data_out;
 
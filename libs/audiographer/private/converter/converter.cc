@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cmath>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "private/converter/converter.h"
+#include "private/gdither/gdither_types.h"
+
+using namespace AudioGrapherDSP;
+
+/* Lipshitz's minimally audible FIR, as used by gdither */
+static const float shaped_bs[] = { 2.033f, -2.165f, 1.959f, -1.590f, 0.6149f };
+
+SampleConverter::SampleConverter (Format format, int type, uint32_t channels, int64_t max_samples)
+	: _format (format)
+	, _type (type)
+	, _channels (channels)
+	, _shift (0)
+	, _history (0)
+	, _dither (0)
+{
+	switch (format) {
+		case S16:
+			_scale   = 32768.f;
+			_clamp_u = 32767.f;
+			_clamp_l = -32768.f;
+			break;
+		case S24in32:
+			_scale   = 8388608.f;
+			_clamp_u = 8388607.f;
+			_clamp_l = -8388608.f;
+			_shift   = 8;
+			break;
+	}
+
+	switch (type) {
+		case GDitherTri:
+			_history = channels;
+			break;
+		case GDitherShaped:
+			_history = 4 * channels;
+			break;
+		default:
+			break;
+	}
+
+	_noise = new float[_history + max_samples];
+
+	/* gdither starts with no previous noise, for triangular dither
+	 * that is a noise sample of 0.5 */
+	for (int64_t i = 0; i < _history; ++i) {
+		_noise[i] = type == GDitherTri ? .5f : 0.f;
+	}
+
+	if (type != GDitherNone) {
+		_dither = new float[max_samples];
+	}
+
+	_rng[0] = 23232323;
+	_rng[1] = 0x9e3779b9;
+	_rng[2] = 0x7f4a7c15;
+	_rng[3] = 0x2545f491;
+}
+
+SampleConverter::~SampleConverter ()
+{
+	delete[] _noise;
+	delete[] _dither;
+}
+
+void
+SampleConverter::run (float const* in, void* out, int64_t n_samples)
+{
+	if (_type != GDitherNone) {
+		make_dither (n_samples);
+	}
+
+	switch (_format) {
+		case S16:
+			convert (in, (int16_t*)out, n_samples);
+			break;
+		case S24in32:
+			convert (in, (int32_t*)out, n_samples);
+			break;
+	}
+}
+
+/* Uniform white noise in [0, 1), from four interleaved xorshift generators */
+void
+SampleConverter::make_noise (float* noise, int64_t n)
+{
+	int64_t i = 0;
+
+#ifdef __SSE2__
+	__m128i       s    = _mm_loadu_si128 ((__m128i const*)_rng);
+	__m128 const  norm = _mm_set1_ps (1.f / 16777216.f);
+
+	for (; i + 4 <= n; i += 4) {
+		s = _mm_xor_si128 (s, _mm_slli_epi32 (s, 13));
+		s = _mm_xor_si128 (s, _mm_srli_epi32 (s, 17));
+		s = _mm_xor_si128 (s, _mm_slli_epi32 (s, 5));
+		_mm_storeu_ps (&noise[i], _mm_mul_ps (_mm_cvtepi32_ps (_mm_srli_epi32 (s, 8)), norm));
+	}
+
+	_mm_storeu_si128 ((__m128i*)_rng, s);
+#endif
+
+	for (; i < n; ++i) {
+		uint32_t& r (_rng[i & 3]);
+		r ^= r << 13;
+		r ^= r >> 17;
+		r ^= r << 5;
+		noise[i] = (r >> 8) / 16777216.f;
+	}
+}
+
+void
+SampleConverter::make_dither (int64_t n)
+{
+	float* const  u = _noise + _history;
+	int64_t const c = _channels;
+	int64_t       i = 0;
+
+	make_noise (u, n);
+
+	switch (_type) {
+		case GDitherRect:
+			for (; i < n; ++i) {
+				_dither[i] = -u[i];
+			}
+			break;
+
+		case GDitherTri:
+			/* difference of the current and previous noise sample of each channel */
+#ifdef __SSE2__
+			for (; i + 4 <= n; i += 4) {
+				_mm_storeu_ps (&_dither[i], _mm_sub_ps (_mm_loadu_ps (&u[i - c]), _mm_loadu_ps (&u[i])));
+			}
+#endif
+			for (; i < n; ++i) {
+				_dither[i] = u[i - c] - u[i];
+			}
+			break;
+
+		case GDitherShaped:
+			/* FIR over the noise of each channel */
+#ifdef __SSE2__
+			{
+				__m128 const b0 = _mm_set1_ps (.5f * shaped_bs[0]);
+				__m128 const b1 = _mm_set1_ps (.5f * shaped_bs[1]);
+				__m128 const b2 = _mm_set1_ps (.5f * shaped_bs[2]);
+				__m128 const b3 = _mm_set1_ps (.5f * shaped_bs[3]);
+				__m128 const b4 = _mm_set1_ps (.5f * shaped_bs[4]);
+				for (; i + 4 <= n; i += 4) {
+					__m128 d = _mm_mul_ps (_mm_loadu_ps (&u[i]), b0);
+					d        = _mm_add_ps (d, _mm_mul_ps (_mm_loadu_ps (&u[i - c]), b1));
+					d        = _mm_add_ps (d, _mm_mul_ps (_mm_loadu_ps (&u[i - 2 * c]), b2));
+					d        = _mm_add_ps (d, _mm_mul_ps (_mm_loadu_ps (&u[i - 3 * c]), b3));
+					d        = _mm_add_ps (d, _mm_mul_ps (_mm_loadu_ps (&u[i - 4 * c]), b4));
+					_mm_storeu_ps (&_dither[i], d);
+				}
+			}
+#endif
+			for (; i < n; ++i) {
+				_dither[i] = .5f * (u[i] * shaped_bs[0] + u[i - c] * shaped_bs[1] + u[i - 2 * c] * shaped_bs[2] + u[i - 3 * c] * shaped_bs[3] + u[i - 4 * c] * shaped_bs[4]);
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	/* keep the most recent noise of each channel for the next block */
+	if (_history > 0) {
+		memmove (_noise, _noise + n, _history * sizeof (float));
+	}
+}
+
+#ifdef __SSE2__
+static inline __m128i
+convert4 (float const* x, float const* d, __m128 scale, __m128 lo, __m128 hi)
+{
+	__m128 v = _mm_mul_ps (_mm_loadu_ps (x), scale);
+	if (d) {
+		v = _mm_add_ps (v, _mm_loadu_ps (d));
+	}
+	/* max/min return the second operand for NaN */
+	return _mm_cvtps_epi32 (_mm_min_ps (_mm_max_ps (v, lo), hi));
+}
+#endif
+
+/* Clamping before rounding gives the same result as gdither's clamping of
+ * the rounded value, NaN is clamped to the lower limit in both cases.
+ */
+template <typename T>
+void
+SampleConverter::convert (float const* in, T* out, int64_t n)
+{
+	float const* d = _type != GDitherNone ? _dither : 0;
+	int64_t      i = 0;
+
+#ifdef __SSE2__
+	__m128 const scale = _mm_set1_ps (_scale);
+	__m128 const lo    = _mm_set1_ps (_clamp_l);
+	__m128 const hi    = _mm_set1_ps (_clamp_u);
+
+	__m128i const shift = _mm_cvtsi32_si128 (_shift);
+
+	switch (sizeof (T)) {
+		case 4:
+			for (; i + 4 <= n; i += 4) {
+				_mm_storeu_si128 ((__m128i*)&out[i], _mm_sll_epi32 (convert4 (&in[i], d ? &d[i] : 0, scale, lo, hi), shift));
+			}
+			break;
+		case 2:
+			for (; i + 8 <= n; i += 8) {
+				__m128i a = convert4 (&in[i], d ? &d[i] : 0, scale, lo, hi);
+				__m128i b = convert4 (&in[i + 4], d ? &d[i + 4] : 0, scale, lo, hi);
+				_mm_storeu_si128 ((__m128i*)&out[i], _mm_packs_epi32 (a, b));
+			}
+			break;
+	}
+
+#endif
+
+	long const post = 1L << _shift;
+
+	for (; i < n; ++i) {
+		float v = in[i] * _scale;
+		if (d) {
+			v += d[i];
+		}
+		v      = v > _clamp_l ? v : _clamp_l;
+		v      = v < _clamp_u ? v : _clamp_u;
+		out[i] = (T) (lrintf (v) * post);
+	}
+}
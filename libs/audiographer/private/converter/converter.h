@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _AUDIOGRAPHER_CONVERTER_H
+#define _AUDIOGRAPHER_CONVERTER_H
+
+#include <stdint.h>
+
+namespace AudioGrapherDSP {
+
+/** Block-wise conversion of interleaved float samples to integers.
+ *
+ * This covers signed 16 bit, and 24 bit in the upper bits of a 32 bit
+ * word, and uses SSE2 when available. Unsigned 8 bit is left to gdither.
+ *
+ * Without dither the result is identical to gdither for finite input.
+ * The dither types match gdither's, but use a different noise generator:
+ * every dither type is a filter over white noise of each channel, so
+ * the noise for a block is generated first, and then added to all
+ * samples at once.
+ */
+class SampleConverter
+{
+public:
+	enum Format {
+		S16,
+		S24in32
+	};
+
+	/** @param type gdither dither type
+	 * @param max_samples maximum number of samples (all channels) per call to run()
+	 */
+	SampleConverter (Format format, int type, uint32_t channels, int64_t max_samples);
+	~SampleConverter ();
+
+	/** Convert @p n_samples interleaved samples (all channels) */
+	void run (float const* in, void* out, int64_t n_samples);
+
+private:
+	void make_dither (int64_t n_samples);
+	void make_noise (float* noise, int64_t n);
+
+	template <typename T>
+	void convert (float const* in, T* out, int64_t n_samples);
+
+	Format   _format;
+	int      _type;
+	uint32_t _channels;
+	float    _scale;
+	float    _clamp_u;
+	float    _clamp_l;
+	int      _shift;
+
+	int64_t  _history; /* noise samples kept for the filter */
+	float*   _noise;   /* history followed by the noise of the current block */
+	float*   _dither;
+	uint32_t _rng[4];
+};
+
+} // namespace AudioGrapherDSP
+
+#endif
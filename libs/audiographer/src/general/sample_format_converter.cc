@@ -23,6 +23,7 @@
 
 #include "audiographer/exception.h"
 #include "audiographer/type_utils.h"
+#include "private/converter/converter.h"
 #include "private/gdither/gdither.h"
 
 #include <boost/format.hpp>
@@ -34,6 +35,7 @@ template <typename TOut>
 SampleFormatConverter<TOut>::SampleFormatConverter (ChannelCount channels) :
   channels (channels),
   dither (0),
+  converter (0),
   data_out_size (0),
   data_out (0),
   clip_floats (false)
@@ -65,6 +67,10 @@ SampleFormatConverter<int32_t>::init (samplecnt_t max_samples, int type, int dat
 
 	init_common (max_samples);
 	dither = gdither_new ((GDitherType) type, channels, GDither32bit, data_width);
+
+	if (data_width == 24) {
+		converter = new AudioGrapherDSP::SampleConverter (AudioGrapherDSP::SampleConverter::S24in32, type, channels, data_out_size);
+	}
 }
 
 template <>
@@ -78,6 +84,10 @@ SampleFormatConverter<int16_t>::init (samplecnt_t max_samples, int type, int dat
 	}
 	init_common (max_samples);
 	dither = gdither_new ((GDitherType) type, channels, GDither16bit, data_width);
+
+	if (data_width == 16) {
+		converter = new AudioGrapherDSP::SampleConverter (AudioGrapherDSP::SampleConverter::S16, type, channels, data_out_size);
+	}
 }
 
 template <>
@@ -122,6 +132,9 @@ SampleFormatConverter<TOut>::reset()
 		dither = 0;
 	}
 
+	delete converter;
+	converter = 0;
+
 	delete[] data_out;
 	data_out_size = 0;
 	data_out = 0;
@@ -140,8 +153,12 @@ SampleFormatConverter<TOut>::process (ProcessContext<float> const & c_in)
 
 	/* Do conversion */
 
-	for (uint32_t chn = 0; chn < c_in.channels(); ++chn) {
-		gdither_runf (dither, chn, c_in.samples_per_channel (), data, data_out);
+	if (converter) {
+		converter->run (data, data_out, c_in.samples ());
+	} else {
+		for (uint32_t chn = 0; chn < c_in.channels(); ++chn) {
+			gdither_runf (dither, chn, c_in.samples_per_channel (), data, data_out);
+		}
 	}
 
 	/* Write forward */
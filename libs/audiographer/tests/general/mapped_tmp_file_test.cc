@@ -0,0 +1,78 @@
+#include <glib.h>
+
+#include "tests/utils.h"
+#include "audiographer/general/mapped_tmp_file.h"
+
+using namespace AudioGrapher;
+
+class MappedTmpFileTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE (MappedTmpFileTest);
+  CPPUNIT_TEST (testProcess);
+  CPPUNIT_TEST (testRead);
+  CPPUNIT_TEST_SUITE_END ();
+
+  public:
+	void setUp()
+	{
+		samples = 128;
+		channels = 2;
+		random_data = TestUtils::init_random_data(samples);
+
+		gchar* path = g_build_filename (g_get_tmp_dir (), "agtestXXXXXX", NULL);
+		file.reset (new MappedTmpFile<float> (path, channels));
+		g_free (path);
+	}
+
+	void tearDown()
+	{
+		file.reset ();
+		delete [] random_data;
+	}
+
+	void testProcess()
+	{
+		ProcessContext<float> c (random_data, samples / 2, channels);
+		file->process (c);
+		CPPUNIT_ASSERT_EQUAL (samples / 2, file->get_samples_written ());
+
+		ProcessContext<float> c2 (random_data + samples / 2, samples / 2, channels);
+		c2.set_flag (ProcessContext<float>::EndOfInput);
+		file->process (c2);
+		CPPUNIT_ASSERT_EQUAL (samples, file->get_samples_written ());
+	}
+
+	void testRead()
+	{
+		boost::shared_ptr<VectorSink<float> > sink (new VectorSink<float>());
+		file->add_output (sink);
+
+		ProcessContext<float> c (random_data, samples, channels);
+		c.set_flag (ProcessContext<float>::EndOfInput);
+		file->process (c);
+
+		/* read in two chunks, the second one is short */
+		samplecnt_t const chunk = 100;
+		CPPUNIT_ASSERT_EQUAL (chunk, file->read (chunk));
+		CPPUNIT_ASSERT (TestUtils::array_equals (random_data, sink->get_array(), chunk));
+
+		CPPUNIT_ASSERT_EQUAL (samples - chunk, file->read (chunk));
+		CPPUNIT_ASSERT_EQUAL (samples - chunk, (samplecnt_t) sink->get_data().size());
+		CPPUNIT_ASSERT (TestUtils::array_equals (random_data + chunk, sink->get_array(), samples - chunk));
+
+		CPPUNIT_ASSERT_EQUAL ((samplecnt_t) 0, file->read (chunk));
+
+		file->rewind ();
+		CPPUNIT_ASSERT_EQUAL (chunk, file->read (chunk));
+		CPPUNIT_ASSERT (TestUtils::array_equals (random_data, sink->get_array(), chunk));
+	}
+
+  private:
+	boost::shared_ptr<MappedTmpFile<float> > file;
+
+	float * random_data;
+	samplecnt_t samples;
+	ChannelCount channels;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION (MappedTmpFileTest);
@@ -1,6 +1,8 @@
+
 #include "tests/utils.h"
 
 #include "audiographer/general/sample_format_converter.h"
+#include "private/gdither/gdither.h"
 
 using namespace AudioGrapher;
 
@@ -15,6 +17,8 @@ class SampleFormatConverterTest : public CppUnit::TestFixture
   CPPUNIT_TEST (testInt16);
   CPPUNIT_TEST (testUint8);
   CPPUNIT_TEST (testChannelCount);
+  CPPUNIT_TEST (testUndithered);
+  CPPUNIT_TEST (testDitherRange);
   CPPUNIT_TEST_SUITE_END ();
 
   public:
@@ -204,8 +208,114 @@ class SampleFormatConverterTest : public CppUnit::TestFixture
 		CPPUNIT_ASSERT (TestUtils::array_filled(sink->get_array(), pc.samples()));
 	}
 
+	void testUndithered()
+	{
+		ChannelCount const channels[] = { 1, 2, 6 };
+
+		for (size_t c = 0; c < sizeof (channels) / sizeof (channels[0]); ++c) {
+			checkUndithered<int32_t> (channels[c], 24, GDither32bit, 8388608.f);
+			checkUndithered<int16_t> (channels[c], 16, GDither16bit, 32768.f);
+		}
+	}
+
+	void testDitherRange()
+	{
+		int const types[] = { D_Rect, D_Tri, D_Shaped };
+
+		for (size_t t = 0; t < sizeof (types) / sizeof (types[0]); ++t) {
+			checkDitherRange<int32_t> (types[t], 24, 256);
+			checkDitherRange<int16_t> (types[t], 16, 1);
+			checkDitherRange<uint8_t> (types[t], 8, 1);
+		}
+	}
+
   private:
 
+	/* compare to gdither, which is used for all other formats */
+	template<typename TOut>
+	void checkUndithered (ChannelCount chn, int data_width, GDitherSize size, float scale)
+	{
+		/* odd lengths to also exercise the remainder of vectorized loops */
+		samplecnt_t const n = chn * 37;
+		float* data = new float[n];
+
+		for (samplecnt_t i = 0; i < n; ++i) {
+			data[i] = random_data[i % samples] * 1.5f;
+		}
+
+		data[0] = 1.f;
+		data[1 % n] = -1.f;
+		data[2 % n] = 0.5f / scale; // ties round to even
+		data[3 % n] = 1.5f / scale;
+		data[4 % n] = -2.5f / scale;
+
+		boost::shared_ptr<SampleFormatConverter<TOut> > converter (new SampleFormatConverter<TOut>(chn));
+		boost::shared_ptr<VectorSink<TOut> > sink (new VectorSink<TOut>());
+
+		converter->init (n, D_None, data_width);
+		converter->add_output (sink);
+		converter->process (ProcessContext<float> (data, n, chn));
+
+		CPPUNIT_ASSERT_EQUAL (n, (samplecnt_t) sink->get_data().size());
+
+		TOut* expected = new TOut[n];
+		GDither dither = gdither_new (GDitherNone, chn, size, data_width);
+
+		for (ChannelCount c = 0; c < chn; ++c) {
+			gdither_runf (dither, c, n / chn, data, expected);
+		}
+		gdither_free (dither);
+
+		for (samplecnt_t i = 0; i < n; ++i) {
+			CPPUNIT_ASSERT_EQUAL ((long) expected[i], (long) sink->get_data()[i]);
+		}
+
+		delete [] expected;
+		delete [] data;
+	}
+
+	template<typename TOut>
+	void checkDitherRange (int type, int data_width, long lsb)
+	{
+		ChannelCount const chn = 2;
+		samplecnt_t const  n   = chn * 1001;
+		float* data = new float[n];
+
+		for (samplecnt_t i = 0; i < n; ++i) {
+			data[i] = random_data[i % samples] * .9f;
+		}
+
+		/* rectangular and triangular dither stays within +/- 1 LSB, noise shaping
+		 * adds up to 2.3 LSB, both plus rounding of the float sum */
+		long const max_diff = (type == D_Shaped ? 4 : 2) * lsb;
+
+		boost::shared_ptr<SampleFormatConverter<TOut> > plain (new SampleFormatConverter<TOut>(chn));
+		boost::shared_ptr<SampleFormatConverter<TOut> > dithered (new SampleFormatConverter<TOut>(chn));
+		boost::shared_ptr<VectorSink<TOut> > plain_sink (new VectorSink<TOut>());
+		boost::shared_ptr<VectorSink<TOut> > dithered_sink (new VectorSink<TOut>());
+
+		plain->init (n, D_None, data_width);
+		plain->add_output (plain_sink);
+		dithered->init (n, type, data_width);
+		dithered->add_output (dithered_sink);
+
+		/* several cycles, the dither filters keep state across them */
+		for (int cycle = 0; cycle < 3; ++cycle) {
+			plain->process (ProcessContext<float> (data, n, chn));
+			dithered->process (ProcessContext<float> (data, n, chn));
+
+			bool differs = false;
+			for (samplecnt_t i = 0; i < n; ++i) {
+				long d = (long) dithered_sink->get_data()[i] - (long) plain_sink->get_data()[i];
+				CPPUNIT_ASSERT (labs (d) <= max_diff);
+				differs |= d != 0;
+			}
+			CPPUNIT_ASSERT (differs);
+		}
+
+		delete [] data;
+	}
+
 	float * random_data;
 	samplecnt_t samples;
 };
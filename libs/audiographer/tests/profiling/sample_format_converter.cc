@@ -0,0 +1,49 @@
+#include <cstdlib>
+#include <iostream>
+
+#include <glib.h>
+
+#include "audiographer/general/sample_format_converter.h"
+
+using namespace std;
+using namespace AudioGrapher;
+
+/* Time `iterations' conversions of `n' samples to 24 bit in a 32 bit word */
+static gint64
+time_conversion (float* data, samplecnt_t n, ChannelCount chn, int type, int data_width, int iterations)
+{
+	SampleFormatConverter<int32_t> converter (chn);
+	converter.init (n, type, data_width);
+
+	gint64 const start = g_get_monotonic_time ();
+	for (int i = 0; i < iterations; ++i) {
+		converter.process (ProcessContext<float> (data, n, chn));
+	}
+	return g_get_monotonic_time () - start;
+}
+
+int
+main (int argc, char* argv[])
+{
+	int const          iterations = argc > 1 ? atoi (argv[1]) : 100;
+	ChannelCount const chn        = 6;
+	samplecnt_t const  n          = chn * 8192;
+	int const          types[]    = { D_None, D_Rect, D_Tri, D_Shaped };
+
+	float* data = new float[n];
+	for (samplecnt_t i = 0; i < n; ++i) {
+		data[i] = (rand () / (float) RAND_MAX) * 2.f - 1.f;
+	}
+
+	for (size_t t = 0; t < sizeof (types) / sizeof (types[0]); ++t) {
+		/* 23 bit is not handled by the vectorized converter,
+		 * and takes the same path in gdither as 24 bit did */
+		cout << "dither type " << types[t]
+		     << ": gdither " << time_conversion (data, n, chn, types[t], 23, iterations)
+		     << " us, vectorized " << time_conversion (data, n, chn, types[t], 24, iterations)
+		     << " us" << endl;
+	}
+
+	delete[] data;
+	return 0;
+}
@@ -46,6 +46,7 @@ SMF::SMF()
 	: _smf (0)
 	, _smf_track (0)
 	, _empty (true)
+	, _file_in_sync (false)
 	, _n_note_on_events (0)
 	, _has_pgm_change (false)
 	, _num_channels (0)
@@ -160,6 +161,8 @@ SMF::open(const std::string& path, int track, bool scan)
 
 	fclose(f);
 
+	_file_in_sync = true;
+
 	lm.release ();
 	if (!_empty && scan) {
 		/* scan the file, set meta-data w/o loading the model */
@@ -270,6 +273,7 @@ SMF::create(const std::string& path, int track, uint16_t ppqn)
 	}
 
 	_empty = true;
+	_file_in_sync = true;
 	_num_channels = 0;
 
 	return 0;
@@ -286,6 +290,8 @@ SMF::close()
 		_smf_track = 0;
 		_num_channels = 0;
 	}
+
+	_file_in_sync = false;
 }
 
 void
@@ -484,6 +490,7 @@ SMF::append_event_delta(uint32_t delta_t, uint32_t size, const uint8_t* buf, eve
 	assert(_smf_track);
 	smf_track_add_event_delta_pulses(_smf_track, event, delta_t);
 	_empty = false;
+	_file_in_sync = false;
 }
 
 void
@@ -499,6 +506,8 @@ SMF::begin_write()
 
 	smf_add_track(_smf, _smf_track);
 	assert(_smf->number_of_tracks == 1);
+
+	_file_in_sync = false;
 }
 
 void
@@ -521,6 +530,8 @@ SMF::end_write(string const & path)
 	}
 
 	fclose(f);
+
+	_file_in_sync = true;
 }
 
 double
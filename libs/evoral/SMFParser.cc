@@ -0,0 +1,415 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+#include <glib/gstdio.h>
+
+#include "evoral/SMFParser.h"
+#include "evoral/midi_util.h"
+
+using namespace std;
+
+namespace Evoral {
+
+static uint32_t
+read_be (uint8_t const * p, int n)
+{
+	uint32_t v = 0;
+	for (int i = 0; i < n; ++i) {
+		v = (v << 8) | p[i];
+	}
+	return v;
+}
+
+SMFParser::Track::Track (long s, long l)
+	: start (s)
+	, end (s + l)
+	, offset (s)
+	, pos (0)
+	, len (0)
+	, status (0)
+	, done (false)
+	, time (0)
+	, id (-1)
+{
+}
+
+SMFParser::SMFParser ()
+	: _file (0)
+	, _format (0)
+	, _ppqn (0)
+	, _consumed (0)
+{
+}
+
+SMFParser::~SMFParser ()
+{
+	close ();
+}
+
+void
+SMFParser::close ()
+{
+	if (_file) {
+		fclose (_file);
+		_file = 0;
+	}
+	_tracks.clear ();
+	_consumed = 0;
+}
+
+int
+SMFParser::open (std::string const & path)
+{
+	close ();
+
+	if ((_file = g_fopen (path.c_str(), "rb")) == 0) {
+		return -1;
+	}
+
+	uint8_t hdr[14];
+
+	if (fread (hdr, 1, sizeof (hdr), _file) != sizeof (hdr) || memcmp (hdr, "MThd", 4)) {
+		close ();
+		return -1;
+	}
+
+	const uint32_t hdr_len  = read_be (&hdr[4], 4);
+	const uint16_t ntracks  = read_be (&hdr[10], 2);
+	const uint16_t division = read_be (&hdr[12], 2);
+
+	_format = read_be (&hdr[8], 2);
+
+	if (hdr_len < 6 || (division & 0x8000) || division == 0) {
+		/* SMPTE based time is not supported */
+		close ();
+		return -1;
+	}
+
+	_ppqn = division;
+
+	/* locate all track chunks, skipping unknown chunk types */
+
+	long offset = 8 + hdr_len;
+
+	while (_tracks.size () < ntracks) {
+		uint8_t chunk[8];
+
+		if (fseek (_file, offset, SEEK_SET) || fread (chunk, 1, sizeof (chunk), _file) != sizeof (chunk)) {
+			break;
+		}
+
+		const uint32_t len = read_be (&chunk[4], 4);
+
+		if (!memcmp (chunk, "MTrk", 4)) {
+			_tracks.push_back (Track (offset + 8, len));
+		}
+
+		offset += 8 + len;
+	}
+
+	if (_tracks.empty ()) {
+		close ();
+		return -1;
+	}
+
+	seek_to_start ();
+
+	return 0;
+}
+
+void
+SMFParser::seek_to_start ()
+{
+	for (vector<Track>::iterator t = _tracks.begin (); t != _tracks.end (); ++t) {
+		reset (*t);
+		advance (*t);
+	}
+	_consumed = 0;
+}
+
+void
+SMFParser::reset (Track& t)
+{
+	t.offset = t.start;
+	t.pos    = 0;
+	t.len    = 0;
+	t.status = 0;
+	t.done   = false;
+	t.time   = 0;
+	t.id     = -1;
+}
+
+bool
+SMFParser::get_byte (Track& t, uint8_t& b)
+{
+	if (t.pos == t.len) {
+		t.offset += t.len;
+		t.pos = 0;
+		t.len = 0;
+
+		if (t.offset >= t.end) {
+			return false;
+		}
+
+		const size_t want = min ((long) sizeof (t.window), t.end - t.offset);
+
+		if (fseek (_file, t.offset, SEEK_SET)) {
+			return false;
+		}
+
+		t.len = fread (t.window, 1, want, _file);
+
+		if (t.len == 0) {
+			return false;
+		}
+	}
+
+	b = t.window[t.pos++];
+	return true;
+}
+
+bool
+SMFParser::get_vlq (Track& t, uint32_t& val)
+{
+	uint8_t b;
+
+	val = 0;
+
+	for (int i = 0; i < 4; ++i) {
+		if (!get_byte (t, b)) {
+			return false;
+		}
+		val = (val << 7) | (b & 0x7f);
+		if (!(b & 0x80)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool
+SMFParser::skip (Track& t, uint32_t n)
+{
+	uint8_t b;
+	while (n--) {
+		if (!get_byte (t, b)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Decode the next MIDI event of @p t into t.data/t.time/t.id, handling
+ * (and consuming) any meta-events before it. Sets t.done at the end of the
+ * track.
+ */
+void
+SMFParser::advance (Track& t)
+{
+	event_id_t pending_id = -1;
+
+	t.data.clear ();
+
+	while (!t.done) {
+
+		uint32_t delta;
+		uint8_t  b;
+
+		if (!get_vlq (t, delta) || !get_byte (t, b)) {
+			t.done = true;
+			break;
+		}
+
+		t.time += delta;
+
+		if (b == 0xff) {
+			/* meta-event */
+			uint8_t  type;
+			uint32_t len;
+
+			if (!get_byte (t, type) || !get_vlq (t, len)) {
+				t.done = true;
+				break;
+			}
+
+			if (type == 0x2f) {
+				/* end of track */
+				t.done = true;
+				break;
+			}
+
+			if (type == 0x7f && len >= 3) {
+				/* sequencer specific: check for Evoral Note ID */
+				uint8_t  mfg;
+				uint8_t  kind;
+				uint32_t id;
+
+				if (!get_byte (t, mfg) || !get_byte (t, kind)) {
+					t.done = true;
+					break;
+				}
+				len -= 2;
+
+				if (mfg == 0x99 && kind == 0x1) {
+					uint32_t before = t.offset + t.pos;
+					if (!get_vlq (t, id)) {
+						t.done = true;
+						break;
+					}
+					pending_id = id;
+					len -= min (len, (uint32_t) (t.offset + t.pos - before));
+				}
+			}
+
+			if (!skip (t, len)) {
+				t.done = true;
+			}
+			continue;
+		}
+
+		if (b == 0xf0 || b == 0xf7) {
+			/* SysEx, or escaped data */
+			uint32_t len;
+
+			if (!get_vlq (t, len)) {
+				t.done = true;
+				break;
+			}
+
+			if (b == 0xf0) {
+				t.data.push_back (b);
+			}
+
+			for (uint32_t n = 0; n < len; ++n) {
+				if (!get_byte (t, b)) {
+					t.done = true;
+					break;
+				}
+				t.data.push_back (b);
+			}
+
+		} else {
+
+			uint8_t status = b;
+
+			if (!(b & 0x80)) {
+				/* running status, @p b is the first data byte */
+				status = t.status;
+			} else if (b < 0xf0) {
+				t.status = b;
+			}
+
+			if (!(status & 0x80)) {
+				cerr << "WARNING: SMF ignoring data without status byte" << endl;
+				continue;
+			}
+
+			const int sz = midi_event_size (status);
+
+			if (sz < 1) {
+				cerr << "WARNING: SMF ignoring unknown status byte" << endl;
+				t.done = true;
+				break;
+			}
+
+			t.data.push_back (status);
+
+			if (!(b & 0x80)) {
+				t.data.push_back (b);
+			}
+
+			while (t.data.size () < (size_t) sz) {
+				if (!get_byte (t, b)) {
+					t.done = true;
+					break;
+				}
+				t.data.push_back (b);
+			}
+
+			if ((status & 0xf0) == 0x90 && sz == 3 && t.data[2] == 0) {
+				/* normalize note on with velocity 0 to proper note off */
+				t.data[0] = 0x80 | (status & 0x0f);
+				t.data[2] = 0x40;
+			}
+		}
+
+		if (t.done) {
+			t.data.clear ();
+			break;
+		}
+
+		if (!midi_event_is_valid (&t.data[0], t.data.size ())) {
+			cerr << "WARNING: SMF ignoring illegal MIDI event" << endl;
+			t.data.clear ();
+			pending_id = -1;
+			continue;
+		}
+
+		t.id = pending_id;
+		return;
+	}
+}
+
+int
+SMFParser::read_event (uint64_t* time, uint32_t* size, uint8_t const ** buf, event_id_t* note_id)
+{
+	assert (time && size && buf && note_id);
+
+	if (_consumed) {
+		advance (*_consumed);
+		_consumed = 0;
+	}
+
+	Track* next = 0;
+
+	if (_tracks.size () == 1) {
+		/* type 0, or type 1 with a single track */
+		if (!_tracks.front ().done) {
+			next = &_tracks.front ();
+		}
+	} else {
+		/* pick the earliest event across all tracks. On equal time,
+		 * lower track numbers come first.
+		 */
+		for (vector<Track>::iterator t = _tracks.begin (); t != _tracks.end (); ++t) {
+			if (!t->done && (!next || t->time < next->time)) {
+				next = &(*t);
+			}
+		}
+	}
+
+	if (!next) {
+		return -1;
+	}
+
+	*time    = next->time;
+	*size    = next->data.size ();
+	*buf     = &next->data[0];
+	*note_id = next->id;
+
+	_consumed = next;
+
+	return *size;
+}
+
+} /* namespace Evoral */
@@ -78,6 +78,11 @@ public:
 	uint16_t ppqn()       const;
 	bool     is_empty()   const { return _empty; }
 
+	/** @return true if the file on disk holds the same data as this object,
+	 * i.e. no events were added since the last open() or end_write().
+	 */
+	bool     file_in_sync () const { return _file_in_sync; }
+
 	void begin_write();
 	void append_event_delta(uint32_t delta_t, uint32_t size, const uint8_t* buf, event_id_t note_id);
 	void end_write(std::string const &);
@@ -140,6 +145,7 @@ public:
 	smf_t*       _smf;
 	smf_track_t* _smf_track;
 	bool         _empty; ///< true iff file contains(non-empty) events
+	bool         _file_in_sync;
 
 	mutable Glib::Threads::Mutex _smf_lock;
 
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef EVORAL_SMF_PARSER_HPP
+#define EVORAL_SMF_PARSER_HPP
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "evoral/visibility.h"
+#include "evoral/types.h"
+
+namespace Evoral {
+
+/** Streaming reader for Standard MIDI Files.
+ *
+ * Unlike Evoral::SMF (which uses libsmf), this never builds an in-memory
+ * representation of the file. Each track is decoded incrementally through
+ * a small read-ahead window, and events of all tracks are returned merged
+ * in time order, so they can be appended to a Sequence (or any other
+ * time-ordered sink) as they are read.
+ *
+ * Meta-events are consumed internally; Evoral note IDs (sequencer-specific
+ * meta-events) are attached to the event that follows them in the same
+ * track.
+ *
+ * Only tempo-based (PPQN) time division is supported.
+ */
+class LIBEVORAL_API SMFParser {
+public:
+	SMFParser ();
+	~SMFParser ();
+
+	/** @return 0 on success, -1 if the file cannot be opened or is not a
+	 * supported SMF.
+	 */
+	int  open (std::string const & path);
+	void close ();
+
+	int      smf_format () const { return _format; }
+	uint16_t num_tracks () const { return _tracks.size (); }
+	uint16_t ppqn ()       const { return _ppqn; }
+
+	/** Restart reading from the beginning of all tracks */
+	void seek_to_start ();
+
+	/** Read the next (non-meta) event, in time order across all tracks.
+	 *
+	 * @param time set to the absolute time of the event in SMF ticks
+	 * @param size set to the size of the event
+	 * @param buf set to the event data. It remains valid until the next
+	 * call to read_event(), seek_to_start() or close().
+	 * @param note_id set to the Evoral note ID stored in the file for this
+	 * event, or -1 if there is none.
+	 *
+	 * @return event size on success, -1 on EOF
+	 */
+	int read_event (uint64_t* time, uint32_t* size, uint8_t const ** buf, event_id_t* note_id);
+
+private:
+	struct Track {
+		Track (long start, long length);
+
+		long     start;    ///< file offset of the first event
+		long     end;      ///< file offset of the end of the chunk
+		long     offset;   ///< file offset of the read-ahead window
+		uint32_t pos;      ///< read position within the window
+		uint32_t len;      ///< valid bytes in the window
+		uint8_t  status;   ///< running status
+		bool     done;
+
+		/* the next event to be returned */
+		uint64_t             time;
+		event_id_t           id;
+		std::vector<uint8_t> data;
+
+		uint8_t  window[512];
+	};
+
+	bool get_byte (Track&, uint8_t&);
+	bool get_vlq (Track&, uint32_t&);
+	bool skip (Track&, uint32_t);
+	void reset (Track&);
+	void advance (Track&);
+
+	FILE*              _file;
+	int                _format;
+	uint16_t           _ppqn;
+	std::vector<Track> _tracks;
+	Track*             _consumed;
+};
+
+} /* namespace Evoral */
+
+#endif /* EVORAL_SMF_PARSER_HPP */
@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include "SMFTest.h"
 
 #include <glibmm/fileutils.h>
@@ -5,6 +7,8 @@
 
 #include "pbd/file_utils.h"
 
+#include "evoral/midi_events.h"
+
 using namespace std;
 
 CPPUNIT_TEST_SUITE_REGISTRATION( SMFTest );
@@ -116,3 +120,68 @@ SMFTest::writeTest ()
 
 	// TODO: Check files are actually equivalent
 }
+
+void
+SMFTest::streamingReadTest ()
+{
+	TestSMF smf;
+	SMFParser parser;
+	string testdata_path;
+	CPPUNIT_ASSERT (find_file (test_search_path (), "TakeFive.mid", testdata_path));
+
+	CPPUNIT_ASSERT_EQUAL (0, smf.open(testdata_path));
+	CPPUNIT_ASSERT_EQUAL (0, parser.open(testdata_path));
+
+	CPPUNIT_ASSERT_EQUAL (smf.smf_format(), parser.smf_format());
+	CPPUNIT_ASSERT_EQUAL (smf.num_tracks(), parser.num_tracks());
+	CPPUNIT_ASSERT_EQUAL (smf.ppqn(), parser.ppqn());
+
+	/* both readers must produce identical events at identical times */
+
+	uint64_t smf_time = 0;
+	uint32_t delta_t  = 0;
+	uint32_t size     = 0;
+	uint8_t* buf      = NULL;
+	size_t   n_events = 0;
+	int ret;
+
+	while ((ret = smf.read_event(&delta_t, &size, &buf)) >= 0) {
+		smf_time += delta_t;
+
+		if (ret == 0) {
+			continue;
+		}
+
+		uint64_t           time;
+		uint32_t           psize;
+		uint8_t const *    pbuf;
+		event_id_t         id;
+
+		CPPUNIT_ASSERT (parser.read_event (&time, &psize, &pbuf, &id) > 0);
+		CPPUNIT_ASSERT_EQUAL (smf_time, time);
+		CPPUNIT_ASSERT_EQUAL (size, psize);
+		CPPUNIT_ASSERT (!memcmp (buf, pbuf, size));
+		++n_events;
+	}
+
+	uint64_t           time;
+	uint32_t           psize;
+	uint8_t const *    pbuf;
+	event_id_t         id;
+
+	CPPUNIT_ASSERT_EQUAL (-1, parser.read_event (&time, &psize, &pbuf, &id));
+	CPPUNIT_ASSERT (n_events > 0);
+
+	/* and again, after rewinding */
+	parser.seek_to_start ();
+
+	size_t num_notes = 0;
+	while (parser.read_event (&time, &psize, &pbuf, &id) > 0) {
+		if ((pbuf[0] & 0xf0) == MIDI_CMD_NOTE_ON) {
+			++num_notes;
+		}
+	}
+	CPPUNIT_ASSERT_EQUAL (size_t(3833), num_notes);
+
+	free (buf);
+}
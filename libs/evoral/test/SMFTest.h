@@ -26,6 +26,7 @@
 #include "temporal/beats.h"
 #include "temporal/tempo.h"
 #include "evoral/SMF.h"
+#include "evoral/SMFParser.h"
 #include "SequenceTest.h"
 
 using namespace Evoral;
@@ -58,6 +59,7 @@ class SMFTest : public CppUnit::TestFixture
 	CPPUNIT_TEST(createNewFileTest);
 	CPPUNIT_TEST(takeFiveTest);
 	CPPUNIT_TEST(writeTest);
+	CPPUNIT_TEST(streamingReadTest);
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -79,6 +81,7 @@ public:
 	void createNewFileTest();
 	void takeFiveTest();
 	void writeTest();
+	void streamingReadTest();
 
 private:
 	DummyTypeMap*     type_map;
@@ -25,10 +25,16 @@
 
 #include <string>
 
+#include <boost/shared_ptr.hpp>
+
 #include "pbd/libpbd_visibility.h"
 #include "pbd/signals.h"
 #include "pbd/statefuldestructible.h"
 
+namespace PBD {
+	class UndoSpillFile;
+}
+
 /** Base class for Undo/Redo commands and changesets */
 class LIBPBD_API Command : public PBD::StatefulDestructible, public PBD::ScopedConnectionList
 {
@@ -50,6 +56,14 @@ public:
 		return false;
 	}
 
+	/** @return bytes of memory used by the undo/redo state of this
+	 * command, as far as it is known
+	 */
+	virtual size_t memory_size () const { return 0; }
+
+	/** Move as much undo/redo state as possible out of memory, to a file */
+	virtual void spill (boost::shared_ptr<PBD::UndoSpillFile>) {}
+
 protected:
 	Command() {}
 	Command(const std::string& name) : _name(name) {}
@@ -25,10 +25,13 @@
 
 #include <iostream>
 
+#include <boost/scoped_ptr.hpp>
+
 #include "pbd/libpbd_visibility.h"
 #include "pbd/command.h"
 #include "pbd/xml++.h"
 #include "pbd/demangle.h"
+#include "pbd/undo_memento.h"
 
 #include <sigc++/slot.h>
 #include <typeinfo>
@@ -99,20 +102,23 @@ private:
 /** This command class is initialized with before and after mementos
  * (from Stateful::get_state()), so undo becomes restoring the before
  * memento, and redo is restoring the after memento.
+ *
+ * The mementos are kept in serialized form (see PBD::UndoMemento), and
+ * only turned back into XML when they are used.
  */
 template <class obj_T>
 class LIBPBD_TEMPLATE_API MementoCommand : public Command
 {
 public:
 	MementoCommand (obj_T& a_object, XMLNode* a_before, XMLNode* a_after)
-		: _binder (new SimpleMementoCommandBinder<obj_T> (a_object)), before (a_before), after (a_after)
+		: _binder (new SimpleMementoCommandBinder<obj_T> (a_object)), before (encode (a_before)), after (encode (a_after))
 	{
 		/* The binder's object died, so we must die */
 		_binder->DropReferences.connect_same_thread (_binder_death_connection, boost::bind (&MementoCommand::binder_dying, this));
 	}
 
 	MementoCommand (MementoCommandBinder<obj_T>* b, XMLNode* a_before, XMLNode* a_after)
-		: _binder (b), before (a_before), after (a_after)
+		: _binder (b), before (encode (a_before)), after (encode (a_after))
 	{
 		/* The binder's object died, so we must die */
 		_binder->DropReferences.connect_same_thread (_binder_death_connection, boost::bind (&MementoCommand::binder_dying, this));
@@ -130,14 +136,23 @@ public:
 	}
 
 	void operator() () {
-		if (after) {
-			_binder->set_state(*after, Stateful::current_state_version);
-		}
+		restore (after);
 	}
 
 	void undo() {
+		restore (before);
+	}
+
+	size_t memory_size () const {
+		return sizeof (*this) + (before ? before->memory_size () : 0) + (after ? after->memory_size () : 0);
+	}
+
+	void spill (boost::shared_ptr<PBD::UndoSpillFile> file) {
 		if (before) {
-			_binder->set_state(*before, Stateful::current_state_version);
+			before->spill (file);
+		}
+		if (after) {
+			after->spill (file);
 		}
 	}
 
@@ -156,12 +171,14 @@ public:
 
 		node->set_property ("type-name", _binder->type_name ());
 
-		if (before) {
-			node->add_child_copy(*before);
+		XMLNode* child;
+
+		if (before && (child = before->get ())) {
+			node->add_child_nocopy(*child);
 		}
 
-		if (after) {
-			node->add_child_copy(*after);
+		if (after && (child = after->get ())) {
+			node->add_child_nocopy(*child);
 		}
 
 		return *node;
@@ -169,9 +186,24 @@ public:
 
 protected:
 	MementoCommandBinder<obj_T>* _binder;
-	XMLNode* before;
-	XMLNode* after;
+	PBD::UndoMemento* before;
+	PBD::UndoMemento* after;
 	PBD::ScopedConnection _binder_death_connection;
+
+private:
+	static PBD::UndoMemento* encode (XMLNode* node) {
+		return node ? new PBD::UndoMemento (node) : 0;
+	}
+
+	void restore (PBD::UndoMemento const* m) {
+		if (!m) {
+			return;
+		}
+		boost::scoped_ptr<XMLNode> node (m->get ());
+		if (node) {
+			_binder->set_state(*node, Stateful::current_state_version);
+		}
+	}
 };
 
 #endif // __lib_pbd_memento_h__
@@ -27,6 +27,9 @@
 #include <map>
 #include <string>
 
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+
 #include <sigc++/bind.h>
 #include <sigc++/slot.h>
 
@@ -41,6 +44,10 @@
 
 typedef sigc::slot<void> UndoAction;
 
+namespace PBD {
+	class UndoMemento;
+}
+
 class LIBPBD_API UndoTransaction : public Command
 {
 public:
@@ -58,12 +65,24 @@ public:
 	void add_command (Command* const);
 	void remove_command (Command* const);
 
+	typedef boost::function<void (UndoTransaction&, XMLNode const&)> CommandBuilder;
+
+	/** Defer creating the commands of this transaction until they are
+	 * needed (for undo or redo). @p build will then be called with
+	 * @p state (as returned by get_state()) to add them. Takes ownership
+	 * of @p state.
+	 */
+	void set_deferred_state (XMLNode* state, CommandBuilder build);
+
 	void operator() ();
 	void undo ();
 	void redo ();
 
 	XMLNode& get_state () const;
 
+	size_t memory_size () const;
+	void   spill (boost::shared_ptr<PBD::UndoSpillFile>);
+
 	void set_timestamp (struct timeval& t)
 	{
 		_timestamp = t;
@@ -78,8 +97,12 @@ private:
 	std::list<Command*> actions;
 	struct timeval      _timestamp;
 	bool                _clearing;
+	PBD::UndoMemento*   _deferred;
+	CommandBuilder      _build;
 
 	void about_to_explicitly_delete ();
+	void copy_deferred_state (UndoTransaction const&);
+	void materialize ();
 };
 
 class LIBPBD_API UndoHistory : public PBD::ScopedConnectionList
@@ -127,6 +150,17 @@ public:
 
 	void set_depth (uint32_t);
 
+	/** Limit the memory used by the undo state of the history to about
+	 * @p bytes (0: unlimited). When the limit is exceeded, the state of the
+	 * oldest transactions is moved to a temporary file, and if that does
+	 * not suffice, the oldest transactions are dropped. The most recent
+	 * transaction is always kept in memory.
+	 */
+	void set_memory_limit (size_t bytes);
+
+	/** @return bytes of memory used by the undo and redo state */
+	size_t memory_size () const;
+
 	PBD::Signal0<void> Changed;
 	PBD::Signal0<void> BeginUndoRedo;
 	PBD::Signal0<void> EndUndoRedo;
@@ -134,10 +168,14 @@ public:
 private:
 	bool                        _clearing;
 	uint32_t                    _depth;
+	size_t                      _memory_limit;
 	std::list<UndoTransaction*> UndoList;
 	std::list<UndoTransaction*> RedoList;
 
+	boost::shared_ptr<PBD::UndoSpillFile> _spill_file;
+
 	void remove (UndoTransaction*);
+	void enforce_memory_limit ();
 };
 
 #endif /* __lib_pbd_undo_h__ */
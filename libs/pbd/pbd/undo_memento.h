@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __libpbd_undo_memento_h__
+#define __libpbd_undo_memento_h__
+
+#include <string>
+
+#include <stdint.h>
+
+#include <boost/shared_ptr.hpp>
+
+#include "pbd/libpbd_visibility.h"
+
+class XMLNode;
+
+namespace PBD {
+
+/** Anonymous temporary file that holds undo state which was moved out of
+ * memory. Space is only reclaimed when the file is destroyed, which happens
+ * once nothing refers to it anymore.
+ */
+class LIBPBD_API UndoSpillFile
+{
+public:
+	UndoSpillFile ();
+	~UndoSpillFile ();
+
+	/** @return offset of @p data in the file, or -1 on error */
+	int64_t write (std::string const& data);
+	bool    read (int64_t offset, size_t len, std::string& data) const;
+
+	/** Mark @p len bytes as no longer used */
+	void release (size_t len);
+
+	/** @return true if most of the file is no longer in use, and a new
+	 * file should be used for future writes.
+	 */
+	bool wasteful () const;
+
+private:
+	int         _fd;
+	std::string _path;
+	int64_t     _size;
+	int64_t     _live;
+};
+
+/** The state of an object (as returned by Stateful::get_state()), kept in
+ * serialized form. Large states are compressed, and can be moved to an
+ * UndoSpillFile.
+ */
+class LIBPBD_API UndoMemento
+{
+public:
+	/** Take ownership of @p node, which is deleted after it was encoded */
+	UndoMemento (XMLNode* node);
+	~UndoMemento ();
+
+	/** @return the decoded state, owned by the caller, or 0 on error */
+	XMLNode* get () const;
+
+	/** @return bytes of memory used by the encoded state */
+	size_t memory_size () const { return _file ? 0 : _data.size (); }
+
+	bool spilled () const { return _file != 0; }
+
+	/** Move the encoded state to @p file */
+	bool spill (boost::shared_ptr<UndoSpillFile> file);
+
+	/** Mementos larger than this are compressed */
+	static const size_t compression_threshold = 4096;
+
+private:
+	std::string _data;
+	size_t      _length;
+	bool        _compressed;
+	int64_t     _offset;
+
+	boost::shared_ptr<UndoSpillFile> _file;
+};
+
+} // namespace PBD
+
+#endif /* __libpbd_undo_memento_h__ */
@@ -79,7 +79,7 @@ public:
 	~XMLTree();
 
 	XMLNode* root() const         { return _root; }
-	XMLNode* set_root(XMLNode* n) { return _root = n; }
+	XMLNode* set_root(XMLNode* n) { free_doc (); return _root = n; }
 
 	const std::string& filename() const               { return _filename; }
 	const std::string& set_filename(const std::string& fn) { return _filename = fn; }
@@ -104,10 +104,15 @@ public:
 
 private:
 	bool read_internal(bool validate);
+	void free_doc () const;
 
 	std::string _filename;
 	XMLNode*    _root;
-	xmlDocPtr   _doc;
+	/** The document of the tree, if it was kept when reading, or as built
+	 * by find(). Like the tree read from it, it is not updated when
+	 * the tree's nodes are modified.
+	 */
+	mutable xmlDocPtr _doc;
 	int         _compression;
 };
 
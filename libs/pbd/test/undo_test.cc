@@ -0,0 +1,115 @@
+#include "undo_test.h"
+
+#include <boost/scoped_ptr.hpp>
+
+#include "pbd/undo.h"
+#include "pbd/undo_memento.h"
+#include "pbd/xml++.h"
+
+using namespace std;
+using namespace PBD;
+
+CPPUNIT_TEST_SUITE_REGISTRATION (UndoTest);
+
+namespace {
+
+XMLNode*
+make_state (int n_children)
+{
+	XMLNode* node = new XMLNode ("State");
+	node->set_property ("name", "a & b < c");
+
+	for (int i = 0; i < n_children; ++i) {
+		XMLNode* child = node->add_child ("Child");
+		child->set_property ("id", i);
+		child->set_property ("value", i * 0.5);
+	}
+
+	return node;
+}
+
+/** A command which only holds a memento */
+class MementoHolder : public Command
+{
+public:
+	MementoHolder (XMLNode* node) : _memento (node) {}
+	~MementoHolder () { drop_references (); }
+
+	void operator() () {}
+	void undo () {}
+
+	size_t memory_size () const { return _memento.memory_size (); }
+	void   spill (boost::shared_ptr<UndoSpillFile> file) { _memento.spill (file); }
+
+	UndoMemento const& memento () const { return _memento; }
+
+private:
+	UndoMemento _memento;
+};
+
+}
+
+void
+UndoTest::testMemento ()
+{
+	/* small and large (compressed) mementos */
+	int const sizes[] = { 1, 5000 };
+
+	for (size_t n = 0; n < sizeof (sizes) / sizeof (int); ++n) {
+		boost::scoped_ptr<XMLNode> state (make_state (sizes[n]));
+
+		UndoMemento m (new XMLNode (*state));
+		CPPUNIT_ASSERT (m.memory_size () > 0);
+		CPPUNIT_ASSERT (!m.spilled ());
+
+		boost::scoped_ptr<XMLNode> decoded (m.get ());
+		CPPUNIT_ASSERT (decoded);
+		CPPUNIT_ASSERT (*decoded == *state);
+
+		boost::shared_ptr<UndoSpillFile> file (new UndoSpillFile);
+		CPPUNIT_ASSERT (m.spill (file));
+		CPPUNIT_ASSERT (m.spilled ());
+		CPPUNIT_ASSERT_EQUAL ((size_t) 0, m.memory_size ());
+
+		decoded.reset (m.get ());
+		CPPUNIT_ASSERT (decoded);
+		CPPUNIT_ASSERT (*decoded == *state);
+	}
+}
+
+void
+UndoTest::testMemoryLimit ()
+{
+	UndoHistory history;
+
+	std::vector<MementoHolder*> commands;
+
+	for (int i = 0; i < 10; ++i) {
+		UndoTransaction* ut = new UndoTransaction;
+		MementoHolder*   mh = new MementoHolder (make_state (2000));
+		ut->add_command (mh);
+		commands.push_back (mh);
+		history.add (ut);
+	}
+
+	const size_t one = commands.back ()->memory_size ();
+
+	CPPUNIT_ASSERT_EQUAL ((unsigned long) 10, history.undo_depth ());
+	CPPUNIT_ASSERT_EQUAL (10 * one, history.memory_size ());
+
+	/* only the most recent transaction fits */
+	history.set_memory_limit (one + one / 2);
+
+	CPPUNIT_ASSERT_EQUAL ((unsigned long) 10, history.undo_depth ());
+	CPPUNIT_ASSERT_EQUAL (one, history.memory_size ());
+	CPPUNIT_ASSERT (commands.front ()->memento ().spilled ());
+	CPPUNIT_ASSERT (!commands.back ()->memento ().spilled ());
+
+	/* spilled state is still available */
+	boost::scoped_ptr<XMLNode> state (make_state (2000));
+	boost::scoped_ptr<XMLNode> decoded (commands.front ()->memento ().get ());
+	CPPUNIT_ASSERT (decoded);
+	CPPUNIT_ASSERT (*decoded == *state);
+
+	history.clear ();
+}
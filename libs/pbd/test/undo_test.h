@@ -0,0 +1,14 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class UndoTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (UndoTest);
+	CPPUNIT_TEST (testMemento);
+	CPPUNIT_TEST (testMemoryLimit);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void testMemento ();
+	void testMemoryLimit ();
+};
@@ -83,6 +83,64 @@ XMLTest::testXMLFilenameEncoding ()
 	}
 }
 
+/* XMLTree::read() builds the tree while parsing, check that the result is
+ * identical to the tree built from a parsed document.
+ */
+static void
+check_streaming_read (std::string const& path)
+{
+	std::string contents = Glib::file_get_contents (path);
+
+	XMLTree dom;
+	CPPUNIT_ASSERT (dom.read_buffer (contents.c_str (), true));
+
+	XMLTree streamed;
+	CPPUNIT_ASSERT (streamed.read (path));
+
+	CPPUNIT_ASSERT (*dom.root () == *streamed.root ());
+
+	/* XPath queries on the streamed tree use a document built (once)
+	 * from the tree, the results are the same.
+	 */
+	for (int i = 0; i < 2; ++i) {
+		CPPUNIT_ASSERT_EQUAL (dom.find ("//*")->size (), streamed.find ("//*")->size ());
+	}
+}
+
+void
+XMLTest::testStreamingRead ()
+{
+	std::string path;
+
+	CPPUNIT_ASSERT (find_file (test_search_path (), "TestSession.ardour", path));
+	check_streaming_read (path);
+
+	CPPUNIT_ASSERT (find_file (test_search_path (), "ProtoolsPatchFile.midnam", path));
+	check_streaming_read (path);
+
+	/* entities, comments, CDATA, mixed content and whitespace handling */
+	const std::string output_path = Glib::build_filename (test_output_directory ("XMLStreamingRead"), "streaming.xml");
+
+	Glib::file_set_contents (output_path,
+			"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+			"<!-- comment before the root -->\n"
+			"<Session name=\"a &amp; b &lt;c&gt; &quot;d&quot;&#10;\">\n"
+			"  <Child>text &amp; more<!-- comment -->tail<![CDATA[raw <data>]]></Child>\n"
+			"  <Empty/>\n"
+			"  <Blank>   </Blank>\n"
+			"  <Mixed><A/> text <B/>\n  <C/></Mixed>\n"
+			"  <Preserve xml:space=\"preserve\">\n    <A/>\n  </Preserve>\n"
+			"  <Events>0 1\n1 2\n</Events>\n"
+			"</Session>\n");
+
+	check_streaming_read (output_path);
+
+	XMLTree truncated;
+	CPPUNIT_ASSERT (!truncated.read_buffer ("<Session><Child></Session>"));
+	CPPUNIT_ASSERT (!truncated.root ());
+
+	CPPUNIT_ASSERT (g_remove (output_path.c_str ()) == 0);
+}
 
 static const char * const root_node_name = "Session";
 static const char * const child_node_name = "Child";
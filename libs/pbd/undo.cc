@@ -26,6 +26,7 @@
 #include <time.h>
 
 #include "pbd/undo.h"
+#include "pbd/undo_memento.h"
 #include "pbd/xml++.h"
 
 using namespace std;
@@ -33,6 +34,7 @@ using namespace sigc;
 
 UndoTransaction::UndoTransaction ()
 	: _clearing (false)
+	, _deferred (0)
 {
 	gettimeofday (&_timestamp, 0);
 }
@@ -40,16 +42,19 @@ UndoTransaction::UndoTransaction ()
 UndoTransaction::UndoTransaction (const UndoTransaction& rhs)
 	: Command (rhs._name)
 	, _clearing (false)
+	, _deferred (0)
 {
 	_timestamp = rhs._timestamp;
 	clear ();
 	actions.insert (actions.end (), rhs.actions.begin (), rhs.actions.end ());
+	copy_deferred_state (rhs);
 }
 
 UndoTransaction::~UndoTransaction ()
 {
 	drop_references ();
 	clear ();
+	delete _deferred;
 }
 
 static void
@@ -75,9 +80,51 @@ UndoTransaction::operator= (const UndoTransaction& rhs)
 	_name = rhs._name;
 	clear ();
 	actions.insert (actions.end (), rhs.actions.begin (), rhs.actions.end ());
+	copy_deferred_state (rhs);
 	return *this;
 }
 
+void
+UndoTransaction::copy_deferred_state (UndoTransaction const& rhs)
+{
+	delete _deferred;
+	_deferred = 0;
+	_build    = rhs._build;
+
+	XMLNode* state;
+
+	if (rhs._deferred && (state = rhs._deferred->get ())) {
+		_deferred = new PBD::UndoMemento (state);
+	}
+}
+
+void
+UndoTransaction::set_deferred_state (XMLNode* state, CommandBuilder build)
+{
+	delete _deferred;
+	_deferred = new PBD::UndoMemento (state);
+	_build    = build;
+}
+
+/** Create the commands of a transaction with deferred state */
+void
+UndoTransaction::materialize ()
+{
+	if (!_deferred) {
+		return;
+	}
+
+	XMLNode* state = _deferred->get ();
+
+	delete _deferred;
+	_deferred = 0;
+
+	if (state) {
+		_build (*this, *state);
+		delete state;
+	}
+}
+
 void
 UndoTransaction::add_command (Command* const cmd)
 {
@@ -104,7 +151,7 @@ UndoTransaction::remove_command (Command* const action)
 bool
 UndoTransaction::empty () const
 {
-	return actions.empty ();
+	return actions.empty () && !_deferred;
 }
 
 void
@@ -121,6 +168,8 @@ UndoTransaction::clear ()
 void
 UndoTransaction::operator() ()
 {
+	materialize ();
+
 	for (list<Command*>::iterator i = actions.begin (); i != actions.end (); ++i) {
 		(*(*i)) ();
 	}
@@ -129,6 +178,8 @@ UndoTransaction::operator() ()
 void
 UndoTransaction::undo ()
 {
+	materialize ();
+
 	for (list<Command*>::reverse_iterator i = actions.rbegin (); i != actions.rend (); ++i) {
 		(*i)->undo ();
 	}
@@ -143,7 +194,14 @@ UndoTransaction::redo ()
 XMLNode&
 UndoTransaction::get_state () const
 {
-	XMLNode* node = new XMLNode ("UndoTransaction");
+	XMLNode* node;
+
+	if (_deferred && (node = _deferred->get ())) {
+		/* no need to create the commands */
+		return *node;
+	}
+
+	node = new XMLNode ("UndoTransaction");
 	node->set_property ("tv-sec", (int64_t)_timestamp.tv_sec);
 	node->set_property ("tv-usec", (int64_t)_timestamp.tv_usec);
 	node->set_property ("name", _name);
@@ -156,6 +214,27 @@ UndoTransaction::get_state () const
 	return *node;
 }
 
+size_t
+UndoTransaction::memory_size () const
+{
+	size_t size = _deferred ? _deferred->memory_size () : 0;
+	for (list<Command*>::const_iterator i = actions.begin (); i != actions.end (); ++i) {
+		size += (*i)->memory_size ();
+	}
+	return size;
+}
+
+void
+UndoTransaction::spill (boost::shared_ptr<PBD::UndoSpillFile> file)
+{
+	if (_deferred) {
+		_deferred->spill (file);
+	}
+	for (list<Command*>::iterator i = actions.begin (); i != actions.end (); ++i) {
+		(*i)->spill (file);
+	}
+}
+
 class UndoRedoSignaller
 {
 public:
@@ -176,8 +255,9 @@ private:
 
 UndoHistory::UndoHistory ()
 {
-	_clearing = false;
-	_depth    = 0;
+	_clearing     = false;
+	_depth        = 0;
+	_memory_limit = 0;
 }
 
 void
@@ -203,6 +283,71 @@ UndoHistory::set_depth (uint32_t d)
 	}
 }
 
+void
+UndoHistory::set_memory_limit (size_t bytes)
+{
+	_memory_limit = bytes;
+
+	if (!UndoList.empty ()) {
+		enforce_memory_limit ();
+		Changed (); /* EMIT SIGNAL */
+	}
+}
+
+size_t
+UndoHistory::memory_size () const
+{
+	size_t size = 0;
+	for (std::list<UndoTransaction*>::const_iterator i = UndoList.begin (); i != UndoList.end (); ++i) {
+		size += (*i)->memory_size ();
+	}
+	for (std::list<UndoTransaction*>::const_iterator i = RedoList.begin (); i != RedoList.end (); ++i) {
+		size += (*i)->memory_size ();
+	}
+	return size;
+}
+
+void
+UndoHistory::enforce_memory_limit ()
+{
+	if (_memory_limit == 0 || UndoList.size () < 2) {
+		return;
+	}
+
+	size_t size = memory_size ();
+
+	if (size <= _memory_limit) {
+		return;
+	}
+
+	if (!_spill_file || _spill_file->wasteful ()) {
+		/* the old file goes away with the last state that uses it */
+		_spill_file.reset (new PBD::UndoSpillFile);
+	}
+
+	/* move the state of the oldest transactions out of memory */
+
+	std::list<UndoTransaction*>::iterator newest = UndoList.end ();
+	--newest;
+
+	for (std::list<UndoTransaction*>::iterator i = UndoList.begin (); i != newest && size > _memory_limit; ++i) {
+		const size_t before = (*i)->memory_size ();
+		(*i)->spill (_spill_file);
+		size -= before - (*i)->memory_size ();
+	}
+
+	/* if that did not help enough (e.g. because the commands cannot spill
+	 * their state), drop the oldest transactions.
+	 */
+
+	while (size > _memory_limit && UndoList.size () > 1) {
+		UndoTransaction* ut = UndoList.front ();
+		size -= ut->memory_size ();
+		UndoList.pop_front ();
+		delete ut;
+	}
+}
+
 void
 UndoHistory::add (UndoTransaction* const ut)
 {
@@ -235,6 +380,8 @@ UndoHistory::add (UndoTransaction* const ut)
 	RedoList.clear ();
 	_clearing = false;
 
+	enforce_memory_limit ();
+
 	/* we are now owners of the transaction and must delete it when finished with it */
 
 	Changed (); /* EMIT SIGNAL */
@@ -336,6 +483,8 @@ UndoHistory::clear ()
 	clear_undo ();
 	clear_redo ();
 
+	_spill_file.reset ();
+
 	Changed (); /* EMIT SIGNAL */
 }
 
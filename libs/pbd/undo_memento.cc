@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef PLATFORM_WINDOWS
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "pbd/gstdio_compat.h"
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+#include "pbd/undo_memento.h"
+#include "pbd/xml++.h"
+
+#include "pbd/i18n.h"
+
+using namespace PBD;
+using std::string;
+
+static int64_t
+seek_to (int fd, int64_t offset)
+{
+#ifdef PLATFORM_WINDOWS
+	return _lseeki64 (fd, offset, SEEK_SET);
+#else
+	return ::lseek (fd, offset, SEEK_SET);
+#endif
+}
+
+UndoSpillFile::UndoSpillFile ()
+	: _fd (-1)
+	, _size (0)
+	, _live (0)
+{
+}
+
+UndoSpillFile::~UndoSpillFile ()
+{
+	if (_fd >= 0) {
+		::close (_fd);
+	}
+	if (!_path.empty ()) {
+		::g_unlink (_path.c_str ());
+	}
+}
+
+int64_t
+UndoSpillFile::write (string const& data)
+{
+	if (_fd < 0) {
+		GError* err  = NULL;
+		gchar*  path = NULL;
+
+		_fd = g_file_open_tmp ("undo-XXXXXX", &path, &err);
+
+		if (_fd < 0) {
+			error << string_compose (_("Cannot create temporary file for undo history (%1)"), err->message) << endmsg;
+			g_error_free (err);
+			return -1;
+		}
+
+#ifdef PLATFORM_WINDOWS
+		/* open files cannot be removed, do it in the destructor */
+		_path = path;
+#else
+		::g_unlink (path);
+#endif
+		g_free (path);
+	}
+
+	const int64_t offset = _size;
+	size_t        done   = 0;
+
+	if (seek_to (_fd, offset) != offset) {
+		return -1;
+	}
+
+	while (done < data.size ()) {
+		const int n = ::write (_fd, data.data () + done, data.size () - done);
+		if (n <= 0) {
+			error << string_compose (_("Cannot write undo history to temporary file (%1)"), strerror (errno)) << endmsg;
+			/* do not reuse the partially written space */
+			_size += done;
+			return -1;
+		}
+		done += n;
+	}
+
+	_size += data.size ();
+	_live += data.size ();
+
+	return offset;
+}
+
+bool
+UndoSpillFile::read (int64_t offset, size_t len, string& data) const
+{
+	data.resize (len);
+
+	if (_fd < 0 || seek_to (_fd, offset) != offset) {
+		return false;
+	}
+
+	size_t done = 0;
+
+	while (done < len) {
+		const int n = ::read (_fd, &data[done], len - done);
+		if (n <= 0) {
+			error << string_compose (_("Cannot read undo history from temporary file (%1)"), strerror (errno)) << endmsg;
+			return false;
+		}
+		done += n;
+	}
+
+	return true;
+}
+
+void
+UndoSpillFile::release (size_t len)
+{
+	_live -= len;
+}
+
+bool
+UndoSpillFile::wasteful () const
+{
+	return _size > (64 << 20) && _live < _size / 4;
+}
+
+/** Run @p in through @p conv, replacing the contents of @p out */
+static bool
+convert (GConverter* conv, string const& in, string& out)
+{
+	char   buf[65536];
+	size_t pos = 0;
+
+	out.clear ();
+
+	for (;;) {
+		gsize   bytes_read;
+		gsize   bytes_written;
+		GError* err = NULL;
+
+		GConverterResult r = g_converter_convert (conv, in.data () + pos, in.size () - pos, buf, sizeof (buf),
+		                                          G_CONVERTER_INPUT_AT_END, &bytes_read, &bytes_written, &err);
+
+		if (r == G_CONVERTER_ERROR) {
+			g_error_free (err);
+			return false;
+		}
+
+		pos += bytes_read;
+		out.append (buf, bytes_written);
+
+		if (r == G_CONVERTER_FINISHED) {
+			return true;
+		}
+	}
+}
+
+UndoMemento::UndoMemento (XMLNode* node)
+	: _length (0)
+	, _compressed (false)
+	, _offset (-1)
+{
+	XMLTree tree;
+	tree.set_root (node); /* takes ownership */
+
+	string const& xml (tree.write_buffer ());
+
+	if (xml.size () > compression_threshold) {
+		GZlibCompressor* c = g_zlib_compressor_new (G_ZLIB_COMPRESSOR_FORMAT_RAW, 1);
+		_compressed        = convert (G_CONVERTER (c), xml, _data);
+		g_object_unref (c);
+	}
+
+	if (!_compressed) {
+		_data = xml;
+	}
+
+	/* do not keep the slack of a growing buffer */
+	string (_data).swap (_data);
+
+	_length = _data.size ();
+}
+
+UndoMemento::~UndoMemento ()
+{
+	if (_file) {
+		_file->release (_length);
+	}
+}
+
+bool
+UndoMemento::spill (boost::shared_ptr<UndoSpillFile> file)
+{
+	if (_file) {
+		return true;
+	}
+
+	_offset = file->write (_data);
+
+	if (_offset < 0) {
+		return false;
+	}
+
+	_file = file;
+	string ().swap (_data);
+
+	return true;
+}
+
+XMLNode*
+UndoMemento::get () const
+{
+	string        spilled;
+	string const* data = &_data;
+
+	if (_file) {
+		if (!_file->read (_offset, _length, spilled)) {
+			return 0;
+		}
+		data = &spilled;
+	}
+
+	string xml;
+
+	if (_compressed) {
+		GZlibDecompressor* d = g_zlib_decompressor_new (G_ZLIB_COMPRESSOR_FORMAT_RAW);
+		const bool         ok = convert (G_CONVERTER (d), *data, xml);
+		g_object_unref (d);
+		if (!ok) {
+			error << _("Cannot decode undo history") << endmsg;
+			return 0;
+		}
+		data = &xml;
+	}
+
+	XMLTree tree;
+
+	if (!tree.read_buffer (data->c_str ())) {
+		error << _("Cannot decode undo history") << endmsg;
+		return 0;
+	}
+
+	XMLNode* root = tree.root ();
+	tree.set_root (0); /* take ownership of the root */
+
+	return root;
+}
@@ -11,6 +11,7 @@
 #include "pbd/xml++.h"
 
 #include <libxml/debugXML.h>
+#include <libxml/parserInternals.h>
 #include <libxml/xpath.h>
 #include <libxml/xpathInternals.h>
 
@@ -19,6 +20,7 @@ xmlChar* xml_version = xmlCharStrdup("1.0");
 using namespace std;
 
 static XMLNode*           readnode(xmlNodePtr);
+static XMLNode*           readsax(xmlParserCtxtPtr);
 static void               writenode(xmlDocPtr, XMLNode*, xmlNodePtr, int);
 static XMLSharedNodeList* find_impl(xmlXPathContext* ctxt, const string& xpath);
 
@@ -51,9 +53,15 @@ XMLTree::XMLTree(const XMLTree* from)
 XMLTree::~XMLTree()
 {
 	delete _root;
+	free_doc ();
+}
 
+void
+XMLTree::free_doc () const
+{
 	if (_doc) {
 		xmlFreeDoc (_doc);
+		_doc = 0;
 	}
 }
 
@@ -80,9 +88,19 @@ XMLTree::read_internal(bool validate)
 	delete _root;
 	_root = 0;
 
-	if (_doc) {
-		xmlFreeDoc (_doc);
-		_doc = 0;
+	free_doc ();
+
+	if (!validate) {
+		/* build the tree directly while parsing, without an intermediate
+		 * xmlDoc. This halves peak memory use for large files.
+		 */
+		xmlParserCtxtPtr ctxt = xmlCreateFileParserCtxt (_filename.c_str());
+		if (ctxt == NULL) {
+			return false;
+		}
+		_root = readsax (ctxt);
+		xmlFreeParserCtxt (ctxt);
+		return _root != 0;
 	}
 
 	/* Calling this prevents libxml2 from treating whitespace as active
@@ -97,11 +115,7 @@ XMLTree::read_internal(bool validate)
 	}
 
 	/* parse the file, activating the DTD validation option */
-	if (validate) {
-		_doc = xmlCtxtReadFile(ctxt, _filename.c_str(), NULL, XML_PARSE_DTDVALID);
-	} else {
-		_doc = xmlCtxtReadFile(ctxt, _filename.c_str(), NULL, XML_PARSE_HUGE);
-	}
+	_doc = xmlCtxtReadFile(ctxt, _filename.c_str(), NULL, XML_PARSE_DTDVALID);
 
 	/* check if parsing succeeded */
 	if (_doc == NULL) {
@@ -109,7 +123,7 @@ XMLTree::read_internal(bool validate)
 		return false;
 	} else {
 		/* check if validation succeeded */
-		if (validate && ctxt->valid == 0) {
+		if (ctxt->valid == 0) {
 			xmlFreeParserCtxt(ctxt);
 			throw XMLException("Failed to validate document " + _filename);
 		}
@@ -133,6 +147,18 @@ XMLTree::read_buffer (char const* buffer, bool to_tree_doc)
 	delete _root;
 	_root = 0;
 
+	free_doc ();
+
+	if (!to_tree_doc) {
+		xmlParserCtxtPtr ctxt = xmlCreateMemoryParserCtxt (buffer, ::strlen(buffer));
+		if (ctxt == NULL) {
+			return false;
+		}
+		_root = readsax (ctxt);
+		xmlFreeParserCtxt (ctxt);
+		return _root != 0;
+	}
+
 	xmlKeepBlanksDefault(0);
 
 	doc = xmlParseMemory (buffer, ::strlen(buffer));
@@ -141,14 +167,7 @@ XMLTree::read_buffer (char const* buffer, bool to_tree_doc)
 	}
 
 	_root = readnode(xmlDocGetRootElement(doc));
-	if (to_tree_doc) {
-		if (_doc) {
-			xmlFreeDoc (_doc);
-		}
-		_doc = doc;
-	} else {
-		xmlFreeDoc (doc);
-	}
+	_doc  = doc;
 
 	return true;
 }
@@ -469,6 +488,14 @@ XMLTree::find(const string xpath, XMLNode* node) const
 	xmlXPathContext* ctxt;
 	xmlDocPtr doc = 0;
 
+	if (!node && !_doc && _root) {
+		/* the tree was read without keeping the document. Build it
+		 * once, callers usually run several queries on the same tree.
+		 */
+		_doc = xmlNewDoc(xml_version);
+		writenode(_doc, _root, _doc->children, 1);
+	}
+
 	if (node) {
 		doc = xmlNewDoc(xml_version);
 		writenode(doc, node, doc->children, 1);
@@ -756,6 +783,218 @@ readnode(xmlNodePtr node)
 	return tmp;
 }
 
+namespace {
+
+/** State of a SAX parse, building an XMLNode tree equivalent to what
+ * readnode() creates from a parsed document.
+ */
+struct SAXState {
+	SAXState () : root (0), text (0) {}
+	~SAXState () { delete root; }
+
+	std::vector<XMLNode*> stack;
+	std::vector<bool>     mixed; ///< for each element on the stack, if text was added
+	XMLNode*              root;
+	XMLNode*              text; ///< text node that characters are appended to
+	std::string           content;
+
+	void add (XMLNode* node) {
+		flush ();
+		if (!stack.empty ()) {
+			stack.back()->add_child_nocopy (*node);
+		} else if (!root && !node->is_content ()) {
+			root = node;
+		} else {
+			/* content outside of the root element */
+			delete node;
+		}
+	}
+
+	void flush () {
+		if (text) {
+			text->set_content (content);
+			text = 0;
+		}
+	}
+};
+
+}
+
+static void
+sax_start_element (void* ctx, const xmlChar* localname, const xmlChar*, const xmlChar*, int, const xmlChar**, int nb_attributes, int, const xmlChar** attributes)
+{
+	SAXState* state = (SAXState*) ((xmlParserCtxtPtr) ctx)->_private;
+
+	XMLNode* node = new XMLNode ((const char*) localname);
+
+	/* attributes come as (localname, prefix, URI, value, end) */
+	for (int i = 0; i < nb_attributes; ++i, attributes += 5) {
+		std::string value ((const char*) attributes[3], attributes[4] - attributes[3]);
+		/* without entity substitution, libxml2 passes '&' as "&#38;" */
+		for (std::string::size_type pos = 0; (pos = value.find ("&#38;", pos)) != std::string::npos; ++pos) {
+			value.replace (pos, 5, 1, '&');
+		}
+		node->set_property ((const char*) attributes[0], value);
+	}
+
+	state->add (node);
+	state->stack.push_back (node);
+	state->mixed.push_back (false);
+}
+
+static void
+sax_end_element (void* ctx, const xmlChar*, const xmlChar*, const xmlChar*)
+{
+	SAXState* state = (SAXState*) ((xmlParserCtxtPtr) ctx)->_private;
+	state->flush ();
+	if (!state->stack.empty ()) {
+		state->stack.pop_back ();
+		state->mixed.pop_back ();
+	}
+}
+
+static bool
+sax_is_text (SAXState const* state, XMLNode const* node)
+{
+	return node == state->text || (node->is_content () && node->name () == "text");
+}
+
+/** libxml2 decides which whitespace to drop (areBlanks() in parser.c)
+ * by looking at the document tree, which is not built here. Apply the
+ * same rules to the XMLNode tree instead. The parser's own record of
+ * mixed content (ctxt->space == -2) is not usable, since it is based on
+ * its (tree-less) decision, so it is tracked separately.
+ */
+static bool
+sax_ignorable (xmlParserCtxtPtr ctxt, SAXState const* state, const xmlChar* ch, int len)
+{
+	if ((ctxt->space && *ctxt->space == 1) || state->mixed.back ()) {
+		/* xml:space="preserve", or mixed content */
+		return false;
+	}
+
+	for (int i = 0; i < len; ++i) {
+		if (!IS_BLANK_CH (ch[i])) {
+			return false;
+		}
+	}
+
+	const xmlChar* cur = ctxt->input->cur;
+
+	if (cur[0] != '<' && cur[0] != 0xd) {
+		return false;
+	}
+
+	XMLNodeList const& children (state->stack.back()->children ());
+
+	if (children.empty ()) {
+		return !(cur[0] == '<' && cur[1] == '/');
+	}
+
+	return !sax_is_text (state, children.back ()) && !sax_is_text (state, children.front ());
+}
+
+static void
+sax_characters (void* ctx, const xmlChar* ch, int len)
+{
+	xmlParserCtxtPtr ctxt = (xmlParserCtxtPtr) ctx;
+	SAXState* state = (SAXState*) ctxt->_private;
+
+	if (state->stack.empty () || sax_ignorable (ctxt, state, ch, len)) {
+		return;
+	}
+
+	if (IS_BLANK_CH (ch[0]) || ch[0] >= 0x80) {
+		state->mixed.back () = true;
+	}
+
+	/* text may be delivered in several chunks */
+	if (!state->text) {
+		XMLNode* node = new XMLNode ("text");
+		state->add (node);
+		state->text = node;
+		state->content.clear ();
+	}
+
+	state->content.append ((const char*) ch, len);
+}
+
+static void
+sax_cdata (void* ctx, const xmlChar* value, int len)
+{
+	SAXState* state = (SAXState*) ((xmlParserCtxtPtr) ctx)->_private;
+
+	if (state->stack.empty ()) {
+		return;
+	}
+
+	/* CDATA is a separate node, not merged with surrounding text */
+	XMLNode* node = new XMLNode ("text");
+	node->set_content (std::string ((const char*) value, len));
+	state->add (node);
+}
+
+static void
+sax_comment (void* ctx, const xmlChar* value)
+{
+	SAXState* state = (SAXState*) ((xmlParserCtxtPtr) ctx)->_private;
+
+	if (state->stack.empty ()) {
+		return;
+	}
+
+	XMLNode* node = new XMLNode ("comment");
+	node->set_content ((const char*) value);
+	state->add (node);
+}
+
+/** Parse the document of @p ctxt without building an intermediate xmlDoc.
+ * @return the root node, or 0 on error
+ */
+static XMLNode*
+readsax (xmlParserCtxtPtr ctxt)
+{
+	SAXState state;
+
+	xmlCtxtUseOptions (ctxt, XML_PARSE_HUGE | XML_PARSE_NOBLANKS);
+
+	/* keep the default handlers for entities, DTDs etc. but build
+	 * the tree ourselves.
+	 */
+	xmlSAXHandlerPtr sax = ctxt->sax;
+	sax->initialized         = XML_SAX2_MAGIC;
+	sax->startElementNs      = sax_start_element;
+	sax->endElementNs        = sax_end_element;
+	sax->startElement        = NULL;
+	sax->endElement          = NULL;
+	sax->characters          = sax_characters;
+	sax->cdataBlock          = sax_cdata;
+	sax->comment             = sax_comment;
+	sax->ignorableWhitespace = NULL;
+	sax->internalSubset      = NULL;
+	sax->externalSubset      = NULL;
+	sax->processingInstruction = NULL;
+
+	ctxt->_private = &state;
+
+	if (xmlParseDocument (ctxt) != 0 || !ctxt->wellFormed || !state.stack.empty ()) {
+		if (ctxt->myDoc) {
+			xmlFreeDoc (ctxt->myDoc);
+			ctxt->myDoc = NULL;
+		}
+		return 0;
+	}
+
+	if (ctxt->myDoc) {
+		xmlFreeDoc (ctxt->myDoc);
+		ctxt->myDoc = NULL;
+	}
+
+	XMLNode* root = state.root;
+	state.root = 0;
+	return root;
+}
+
 static void
 writenode(xmlDocPtr doc, XMLNode* n, xmlNodePtr p, int root = 0)
 {
@@ -722,6 +722,8 @@ TempoMap::TempoMap (Tempo const & initial_tempo, Meter const & initial_meter)
 
 	_points.push_back (*tp);
 	_points.push_back (*mp);
+
+	rebuild_lookup ();
 }
 
 TempoMap::~TempoMap()
@@ -731,17 +733,20 @@ TempoMap::~TempoMap()
 TempoMap::TempoMap (XMLNode const & node, int version)
 {
 	set_state (node, version);
+	rebuild_lookup ();
 }
 
 TempoMap::TempoMap (TempoMap const & other)
 {
 	copy_points (other);
+	rebuild_lookup ();
 }
 
 TempoMap&
 TempoMap::operator= (TempoMap const & other)
 {
 	copy_points (other);
+	rebuild_lookup ();
 	return *this;
 }
 
@@ -750,6 +755,8 @@ TempoMap::copy_points (TempoMap const & other)
 {
 	std::vector<Point*> p;
 
+	invalidate_lookup ();
+
 	p.reserve (other._meters.size() + other._tempos.size() + other._bartimes.size());
 
 	for (Meters::const_iterator m = other._meters.begin(); m != other._meters.end(); ++m) {
@@ -875,6 +882,8 @@ TempoMap::core_add_point (Point* pp)
 	Points::iterator p;
 	const Beats beats_limit = pp->beats();
 
+	invalidate_lookup ();
+
 	for (p = _points.begin(); p != _points.end() && p->beats() < beats_limit; ++p);
 	_points.insert (p, *pp);
 }
@@ -884,6 +893,8 @@ TempoMap::core_add_tempo (TempoPoint* tp, bool& replaced)
 {
 	Tempos::iterator t;
 	const superclock_t sclock_limit = tp->sclock();
+
+	invalidate_lookup ();
 	const Beats beats_limit = tp->beats ();
 
 	for (t = _tempos.begin(); t != _tempos.end() && t->beats() < beats_limit; ++t);
@@ -910,6 +921,8 @@ TempoMap::core_add_meter (MeterPoint* mp, bool& replaced)
 {
 	Meters::iterator m;
 	const superclock_t sclock_limit = mp->sclock();
+
+	invalidate_lookup ();
 	const Beats beats_limit = mp->beats ();
 
 	for (m = _meters.begin(); m != _meters.end() && m->beats() < beats_limit; ++m);
@@ -934,6 +947,8 @@ TempoMap::core_add_bartime (MusicTimePoint* mtp, bool& replaced)
 	MusicTimes::iterator m;
 	const superclock_t sclock_limit = mtp->sclock();
 
+	invalidate_lookup ();
+
 	for (m = _bartimes.begin(); m != _bartimes.end() && m->sclock() < sclock_limit; ++m);
 
 	if (m != _bartimes.end()) {
@@ -1100,6 +1115,8 @@ TempoMap::remove_point (Point const & point)
 	Points::iterator p;
 	Point const * tpp (&point);
 
+	invalidate_lookup ();
+
 	/* note that the point passed here must be an element of the _points
 	 * list, which is not true for the point passed to the callees
 	 * (remove_tempo(), remove_meter(), remove_bartime().
@@ -1130,6 +1147,7 @@ TempoMap::reset_starting_at (superclock_t sc)
 	assert (!_tempos.empty());
 	assert (!_meters.empty());
 
+	invalidate_lookup ();
 
 	TempoPoint*     tp;
 	TempoPoint*     nxt_tempo = 0;
@@ -1346,6 +1364,7 @@ TempoMap::move_meter (MeterPoint const & mp, timepos_t const & when, bool earlie
 	const superclock_t old_sc = mp.sclock();
 
 	/* reset position of this meter */
+	invalidate_lookup ();
 	const_cast<MeterPoint*> (&mp)->set (sc, beats, bbt);
 
 	{
@@ -1450,6 +1469,7 @@ TempoMap::move_tempo (TempoPoint const & tp, timepos_t const & when, bool push)
 
 	const superclock_t old_sc = tp.sclock();
 	/* reset position of this tempo */
+	invalidate_lookup ();
 	const_cast<TempoPoint*> (&tp)->set (sc, beats, bbt);
 
 	/* move to correct position in tempo list */
@@ -1710,6 +1730,8 @@ TempoMap::sample_rate_changed (samplecnt_t new_sr)
 {
 	const double ratio = new_sr / (double) TEMPORAL_SAMPLE_RATE;
 
+	invalidate_lookup ();
+
 	for (Tempos::iterator t = _tempos.begin(); t != _tempos.end(); ++t) {
 		t->map_reset_set_sclock_for_sr_change (llrint (ratio * t->sclock()));
 	}
@@ -2452,6 +2474,8 @@ TempoMap::get_state () const
 int
 TempoMap::set_state (XMLNode const & node, int version)
 {
+	invalidate_lookup ();
+
 	if (version <= 6000) {
 		return set_state_3x (node);
 	}
@@ -2719,6 +2743,8 @@ TempoMap::insert_time (timepos_t const & pos, timecnt_t const & duration)
 		return;
 	}
 
+	invalidate_lookup ();
+
 	Tempos::iterator     t (_tempos.begin());
 	Meters::iterator     m (_meters.begin());
 	MusicTimes::iterator b (_bartimes.begin());
@@ -2854,6 +2880,8 @@ TempoMap::remove_time (timepos_t const & pos, timecnt_t const & duration)
 
 	bool moved = false;
 
+	invalidate_lookup ();
+
 	for (Tempos::iterator t = _tempos.begin(); t != _tempos.end(); ) {
 
 		if (t->sclock() >= start && t->sclock() < end) {
@@ -2955,6 +2983,269 @@ TempoMap::meter_at (timepos_t const & pos) const
 	return pos.is_beats() ? meter_at (pos.beats()) : meter_at (pos.superclocks());
 }
 
+void
+TempoMap::invalidate_lookup ()
+{
+	_lookup_sclock.clear ();
+	_lookup_beats.clear ();
+	_lookup_bbt.clear ();
+	_lookup_metric.clear ();
+}
+
+void
+TempoMap::rebuild_lookup ()
+{
+	invalidate_lookup ();
+
+	if (_tempos.empty() || _meters.empty()) {
+		return;
+	}
+
+	const size_t npoints = _points.size();
+
+	_lookup_sclock.reserve (npoints);
+	_lookup_beats.reserve (npoints);
+	_lookup_bbt.reserve (npoints);
+	_lookup_metric.reserve (npoints);
+
+	LookupMetric metric;
+
+	metric.tempo = &_tempos.front();
+	metric.meter = &_meters.front();
+
+	for (Points::const_iterator p = _points.begin(); p != _points.end(); ++p) {
+
+		TempoPoint const * tp;
+		MeterPoint const * mp;
+
+		if ((tp = dynamic_cast<TempoPoint const *> (&*p)) != 0) {
+			metric.tempo = tp;
+		}
+
+		if ((mp = dynamic_cast<MeterPoint const *> (&*p)) != 0) {
+			metric.meter = mp;
+		}
+
+		_lookup_sclock.push_back (p->sclock());
+		_lookup_beats.push_back (p->beats());
+		_lookup_bbt.push_back (p->bbt());
+		_lookup_metric.push_back (metric);
+	}
+}
+
+/** @return the number of points positioned before @p arg (or at it, if
+ * @p can_match is true), using the same rules as ::_get_tempo_and_meter().
+ */
+template<typename T> size_t
+TempoMap::lookup_count (std::vector<T> const & positions, T const & arg, bool can_match) const
+{
+	if (can_match || arg == T()) {
+		return std::upper_bound (positions.begin(), positions.end(), arg) - positions.begin();
+	}
+
+	return std::lower_bound (positions.begin(), positions.end(), arg) - positions.begin();
+}
+
+TempoMetric
+TempoMap::lookup_metric (size_t n) const
+{
+	if (n == 0) {
+		return TempoMetric (_tempos.front(), _meters.front());
+	}
+
+	LookupMetric const & lm (_lookup_metric[n-1]);
+
+	return TempoMetric (*lm.tempo, *lm.meter);
+}
+
+void
+TempoMap::superclock_at (Beats const * in, superclock_t* out, size_t n) const
+{
+	if (!have_lookup ()) {
+		for (size_t i = 0; i < n; ++i) {
+			out[i] = superclock_at (in[i]);
+		}
+		return;
+	}
+
+	const size_t npoints = _lookup_beats.size();
+	size_t cnt = 0;
+
+	for (size_t i = 0; i < n; ++i) {
+		if (i == 0 || in[i] < in[i-1]) {
+			/* first or unsorted value: start over */
+			cnt = lookup_count (_lookup_beats, in[i], true);
+		} else {
+			while (cnt < npoints && _lookup_beats[cnt] <= in[i]) {
+				++cnt;
+			}
+		}
+		out[i] = lookup_metric (cnt).superclock_at (in[i]);
+	}
+}
+
+void
+TempoMap::quarters_at_superclock (superclock_t const * in, Beats* out, size_t n) const
+{
+	if (!have_lookup ()) {
+		for (size_t i = 0; i < n; ++i) {
+			out[i] = quarters_at_superclock (in[i]);
+		}
+		return;
+	}
+
+	const size_t npoints = _lookup_sclock.size();
+	size_t cnt = 0;
+
+	for (size_t i = 0; i < n; ++i) {
+		if (i == 0 || in[i] < in[i-1]) {
+			cnt = lookup_count (_lookup_sclock, in[i], true);
+		} else {
+			while (cnt < npoints && _lookup_sclock[cnt] <= in[i]) {
+				++cnt;
+			}
+		}
+		out[i] = lookup_metric (cnt).quarters_at_superclock (in[i]);
+	}
+}
+
+void
+TempoMap::bbt_at (Beats const * in, BBT_Time* out, size_t n) const
+{
+	if (!have_lookup ()) {
+		for (size_t i = 0; i < n; ++i) {
+			out[i] = bbt_at (in[i]);
+		}
+		return;
+	}
+
+	const size_t npoints = _lookup_beats.size();
+	size_t cnt = 0;
+
+	for (size_t i = 0; i < n; ++i) {
+		if (i == 0 || in[i] < in[i-1]) {
+			cnt = lookup_count (_lookup_beats, in[i], true);
+		} else {
+			while (cnt < npoints && _lookup_beats[cnt] <= in[i]) {
+				++cnt;
+			}
+		}
+		out[i] = lookup_metric (cnt).bbt_at (in[i]);
+	}
+}
+
+/* these two do not allocate, so that they can be used in realtime context */
+
+void
+TempoMap::sample_at (Beats const * in, samplepos_t* out, size_t n) const
+{
+	/* samplepos_t and superclock_t are the same type: convert in place */
+
+	superclock_at (in, out, n);
+
+	for (size_t i = 0; i < n; ++i) {
+		out[i] = superclock_to_samples (out[i], TEMPORAL_SAMPLE_RATE);
+	}
+}
+
+void
+TempoMap::quarters_at_sample (samplepos_t const * in, Beats* out, size_t n) const
+{
+	superclock_t sc[128];
+
+	while (n) {
+		const size_t chunk = std::min (n, sizeof (sc) / sizeof (sc[0]));
+
+		for (size_t i = 0; i < chunk; ++i) {
+			sc[i] = samples_to_superclock (in[i], TEMPORAL_SAMPLE_RATE);
+		}
+
+		quarters_at_superclock (sc, out, chunk);
+
+		in  += chunk;
+		out += chunk;
+		n   -= chunk;
+	}
+}
+
+void
+TempoMap::add_duration (timepos_t* pos, size_t n, timecnt_t const & distance) const
+{
+	const bool beat_distance = (distance.time_domain() == BeatTime);
+
+	/* positions in the same time domain as @p distance need no conversion.
+	 * Collect the others, and convert those via the batch methods. This
+	 * follows ::convert_duration() (including its rounding to samples)
+	 * so that the result is identical to timepos_t::operator+().
+	 */
+
+	std::vector<size_t> idx;
+
+	for (size_t i = 0; i < n; ++i) {
+		if (pos[i].is_beats() == beat_distance) {
+			pos[i] = pos[i] + distance;
+		} else {
+			idx.push_back (i);
+		}
+	}
+
+	const size_t cnt = idx.size();
+
+	if (cnt == 0) {
+		return;
+	}
+
+	if (beat_distance) {
+
+		/* audio time positions: add beats, then convert back */
+
+		const Beats d (distance.beats());
+		std::vector<superclock_t> sc (cnt);
+		std::vector<Beats> qn (cnt);
+
+		for (size_t i = 0; i < cnt; ++i) {
+			sc[i] = pos[idx[i]].superclocks();
+		}
+
+		quarters_at_superclock (&sc[0], &qn[0], cnt);
+
+		for (size_t i = 0; i < cnt; ++i) {
+			qn[i] += d;
+		}
+
+		superclock_at (&qn[0], &sc[0], cnt);
+
+		for (size_t i = 0; i < cnt; ++i) {
+			pos[idx[i]] = timepos_t::from_superclock (sc[i]);
+		}
+
+	} else {
+
+		/* music time positions: add superclocks, then convert back */
+
+		const superclock_t d (distance.superclocks());
+		std::vector<Beats> qn (cnt);
+		std::vector<samplepos_t> s (cnt);
+		std::vector<superclock_t> sc (cnt);
+
+		for (size_t i = 0; i < cnt; ++i) {
+			qn[i] = pos[idx[i]].beats();
+		}
+
+		sample_at (&qn[0], &s[0], cnt);
+
+		for (size_t i = 0; i < cnt; ++i) {
+			sc[i] = samples_to_superclock (s[i], TEMPORAL_SAMPLE_RATE) + d;
+		}
+
+		quarters_at_superclock (&sc[0], &qn[0], cnt);
+
+		for (size_t i = 0; i < cnt; ++i) {
+			pos[idx[i]] = timepos_t (qn[i]);
+		}
+	}
+}
+
 TempoMetric
 TempoMap::metric_at (timepos_t const & pos) const
 {
@@ -2968,6 +3259,10 @@ TempoMap::metric_at (timepos_t const & pos) const
 TempoMetric
 TempoMap::metric_at (superclock_t sc, bool can_match) const
 {
+	if (have_lookup ()) {
+		return lookup_metric (lookup_count (_lookup_sclock, sc, can_match));
+	}
+
 	TempoPoint const * tp = 0;
 	MeterPoint const * mp = 0;
 
@@ -2979,6 +3274,10 @@ TempoMap::metric_at (superclock_t sc, bool can_match) const
 TempoMetric
 TempoMap::metric_at (Beats const & b, bool can_match) const
 {
+	if (have_lookup ()) {
+		return lookup_metric (lookup_count (_lookup_beats, b, can_match));
+	}
+
 	TempoPoint const * tp = 0;
 	MeterPoint const * mp = 0;
 
@@ -2990,6 +3289,10 @@ TempoMap::metric_at (Beats const & b, bool can_match) const
 TempoMetric
 TempoMap::metric_at (BBT_Time const & bbt, bool can_match) const
 {
+	if (have_lookup ()) {
+		return lookup_metric (lookup_count (_lookup_bbt, bbt, can_match));
+	}
+
 	TempoPoint const * tp = 0;
 	MeterPoint const * mp = 0;
 
@@ -3312,6 +3615,11 @@ TempoMap::write_copy()
 int
 TempoMap::update (TempoMap::WritableSharedPtr m)
 {
+	/* the index must be complete before any other thread can see the
+	 * new map.
+	 */
+	m->rebuild_lookup ();
+
 	if (!_map_mgr.update (m)) {
 		return -1;
 	}
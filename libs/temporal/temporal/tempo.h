@@ -862,6 +862,23 @@ class /*LIBTEMPORAL_API*/ TempoMap : public PBD::StatefulDestructible
 	LIBTEMPORAL_API	samplepos_t sample_at (BBT_Time const & b) const { return superclock_to_samples (superclock_at (b), TEMPORAL_SAMPLE_RATE); }
 	LIBTEMPORAL_API	samplepos_t sample_at (timepos_t const & t) const { return superclock_to_samples (superclock_at (t), TEMPORAL_SAMPLE_RATE); }
 
+	/* batch conversions: each is equivalent to calling the single value
+	 * version for every element of @p in, but when @p in is sorted
+	 * (ascending), the map is walked just once.
+	 */
+
+	LIBTEMPORAL_API	void superclock_at (Beats const * in, superclock_t* out, size_t n) const;
+	LIBTEMPORAL_API	void quarters_at_superclock (superclock_t const * in, Beats* out, size_t n) const;
+	LIBTEMPORAL_API	void bbt_at (Beats const * in, BBT_Time* out, size_t n) const;
+	LIBTEMPORAL_API	void sample_at (Beats const * in, samplepos_t* out, size_t n) const;
+	LIBTEMPORAL_API	void quarters_at_sample (samplepos_t const * in, Beats* out, size_t n) const;
+
+	/* equivalent to pos[i] = pos[i] + distance for all @p n positions,
+	 * but any time domain conversions are done using the batch methods
+	 * above, so @p pos should be sorted.
+	 */
+	LIBTEMPORAL_API	void add_duration (timepos_t* pos, size_t n, timecnt_t const & distance) const;
+
 	/* ways to walk along the tempo map, measure distance between points,
 	 * etc.
 	 */
@@ -910,6 +927,31 @@ class /*LIBTEMPORAL_API*/ TempoMap : public PBD::StatefulDestructible
 	MusicTimes   _bartimes;
 	Points       _points;
 
+	/* Lookup index used to binary search _points, with one entry per
+	 * point: its position in all three time domains, and the tempo and
+	 * meter in effect at (and after) it. The index is built for every new
+	 * version of the map before it is published via ::update(), and is
+	 * dropped as soon as a (writable) map is modified, in which case
+	 * lookups fall back to walking _points.
+	 */
+
+	struct LookupMetric {
+		TempoPoint const * tempo;
+		MeterPoint const * meter;
+	};
+
+	std::vector<superclock_t> _lookup_sclock;
+	std::vector<Beats>        _lookup_beats;
+	std::vector<BBT_Time>     _lookup_bbt;
+	std::vector<LookupMetric> _lookup_metric;
+
+	void rebuild_lookup ();
+	void invalidate_lookup ();
+	bool have_lookup () const { return !_lookup_metric.empty(); }
+
+	template<typename T> size_t lookup_count (std::vector<T> const &, T const &, bool can_match) const;
+	TempoMetric lookup_metric (size_t) const;
+
 	int set_tempos_from_state (XMLNode const &);
 	int set_meters_from_state (XMLNode const &);
 	int set_music_times_from_state (XMLNode const &);
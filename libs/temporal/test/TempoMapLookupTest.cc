@@ -0,0 +1,155 @@
+#include <vector>
+
+#include "temporal/tempo.h"
+
+#include "TempoMapLookupTest.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TempoMapLookupTest);
+
+using namespace std;
+using namespace Temporal;
+
+/* A map built with (non-const) modifying methods has no lookup index and
+ * uses the linear search. A copy of it does have an index, so comparing the
+ * two compares both implementations.
+ */
+
+static void
+build_map (TempoMap& map, int bars)
+{
+	for (int bar = 1; bar < bars; bar += 4) {
+		map.set_tempo (Tempo (90 + (bar % 60), 4), BBT_Time (bar, 1, 0));
+		if ((bar % 16) == 1) {
+			map.set_meter (Meter ((bar % 32) == 1 ? 3 : 4, 4), BBT_Time (bar, 1, 0));
+		}
+	}
+}
+
+static void
+make_positions (vector<Beats>& beats, int bars)
+{
+	/* 3 positions per beat, sorted */
+	for (int64_t ticks = 0; ticks < bars * 4 * Beats::PPQN; ticks += Beats::PPQN / 3) {
+		beats.push_back (Beats::ticks (ticks));
+	}
+}
+
+void
+TempoMapLookupTest::lookupTest ()
+{
+	TempoMap linear (Tempo (120, 4), Meter (4, 4));
+	build_map (linear, 400);
+	TempoMap indexed (linear);
+
+	vector<Beats> beats;
+	make_positions (beats, 400);
+
+	for (vector<Beats>::const_iterator b = beats.begin(); b != beats.end(); ++b) {
+		const superclock_t sc = linear.superclock_at (*b);
+		CPPUNIT_ASSERT_EQUAL (sc, indexed.superclock_at (*b));
+		CPPUNIT_ASSERT_EQUAL (linear.quarters_at_superclock (sc), indexed.quarters_at_superclock (sc));
+		CPPUNIT_ASSERT_EQUAL (linear.bbt_at (*b), indexed.bbt_at (*b));
+
+		const BBT_Time bbt (linear.bbt_at (*b));
+		CPPUNIT_ASSERT_EQUAL (linear.quarters_at (bbt), indexed.quarters_at (bbt));
+
+		/* and the metric "before" a position */
+		CPPUNIT_ASSERT_EQUAL (linear.metric_at (*b, false).tempo().sclock(), indexed.metric_at (*b, false).tempo().sclock());
+		CPPUNIT_ASSERT_EQUAL (linear.metric_at (sc, false).meter().sclock(), indexed.metric_at (sc, false).meter().sclock());
+	}
+}
+
+void
+TempoMapLookupTest::batchTest ()
+{
+	TempoMap linear (Tempo (120, 4), Meter (4, 4));
+	build_map (linear, 400);
+	TempoMap indexed (linear);
+
+	vector<Beats> beats;
+	make_positions (beats, 400);
+
+	/* unsorted input must work too */
+	beats.push_back (Beats (17, 0));
+	beats.push_back (Beats ());
+
+	const size_t n = beats.size();
+	vector<superclock_t> sc (n);
+	vector<Beats> qn (n);
+	vector<BBT_Time> bbt (n);
+
+	indexed.superclock_at (&beats[0], &sc[0], n);
+	indexed.quarters_at_superclock (&sc[0], &qn[0], n);
+	indexed.bbt_at (&beats[0], &bbt[0], n);
+
+	for (size_t i = 0; i < n; ++i) {
+		CPPUNIT_ASSERT_EQUAL (linear.superclock_at (beats[i]), sc[i]);
+		CPPUNIT_ASSERT_EQUAL (linear.quarters_at_superclock (sc[i]), qn[i]);
+		CPPUNIT_ASSERT_EQUAL (linear.bbt_at (beats[i]), bbt[i]);
+	}
+}
+
+void
+TempoMapLookupTest::durationTest ()
+{
+	TempoMap linear (Tempo (120, 4), Meter (4, 4));
+	build_map (linear, 400);
+	TempoMap indexed (linear);
+
+	vector<Beats> beats;
+	make_positions (beats, 400);
+
+	vector<timepos_t> pos;
+
+	for (size_t i = 0; i < beats.size(); i += 7) {
+		/* mixed time domains */
+		if (i & 1) {
+			pos.push_back (timepos_t (beats[i]));
+		} else {
+			pos.push_back (timepos_t::from_superclock (indexed.superclock_at (beats[i])));
+		}
+	}
+
+	const timecnt_t distances[] = {
+		timecnt_t (Beats (3, 17)),
+		timecnt_t::from_superclock (superclock_ticks_per_second() * 5 / 3)
+	};
+
+	for (size_t d = 0; d < sizeof (distances) / sizeof (distances[0]); ++d) {
+
+		vector<timepos_t> moved (pos);
+
+		indexed.add_duration (&moved[0], moved.size(), distances[d]);
+
+		for (size_t i = 0; i < pos.size(); ++i) {
+			/* this is what timepos_t::operator+() does */
+			const timepos_t expected = pos[i] + linear.convert_duration (distances[d], pos[i], pos[i].time_domain());
+			CPPUNIT_ASSERT (expected == moved[i]);
+			CPPUNIT_ASSERT (pos[i].time_domain() == moved[i].time_domain());
+		}
+	}
+}
+
+void
+TempoMapLookupTest::largeMapTest ()
+{
+	const int bars = 4000;
+
+	TempoMap linear (Tempo (120, 4), Meter (4, 4));
+	build_map (linear, bars);
+	TempoMap indexed (linear);
+
+	vector<Beats> beats;
+	make_positions (beats, bars);
+
+	const size_t n = beats.size();
+	vector<superclock_t> sc (n);
+
+	indexed.superclock_at (&beats[0], &sc[0], n);
+
+	for (size_t i = 0; i < n; ++i) {
+		const superclock_t expected = linear.superclock_at (beats[i]);
+		CPPUNIT_ASSERT_EQUAL (expected, sc[i]);
+		CPPUNIT_ASSERT_EQUAL (expected, indexed.superclock_at (beats[i]));
+	}
+}
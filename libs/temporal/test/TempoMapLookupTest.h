@@ -0,0 +1,18 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class TempoMapLookupTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE(TempoMapLookupTest);
+	CPPUNIT_TEST(lookupTest);
+	CPPUNIT_TEST(batchTest);
+	CPPUNIT_TEST(durationTest);
+	CPPUNIT_TEST(largeMapTest);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void lookupTest();
+	void batchTest();
+	void durationTest();
+	void largeMapTest();
+};
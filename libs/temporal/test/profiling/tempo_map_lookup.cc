@@ -0,0 +1,79 @@
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "pbd/pbd.h"
+#include "pbd/timing.h"
+
+#include "temporal/tempo.h"
+
+using namespace std;
+using namespace Temporal;
+
+/* Compare Beats -> superclock conversions of the linear search (a map built
+ * with modifying methods), the lookup index (a copy of it) and the batch
+ * conversion. The same map and positions as TempoMapLookupTest, with more
+ * bars.
+ */
+
+static void
+build_map (TempoMap& map, int bars)
+{
+	for (int bar = 1; bar < bars; bar += 4) {
+		map.set_tempo (Tempo (90 + (bar % 60), 4), BBT_Time (bar, 1, 0));
+		if ((bar % 16) == 1) {
+			map.set_meter (Meter ((bar % 32) == 1 ? 3 : 4, 4), BBT_Time (bar, 1, 0));
+		}
+	}
+}
+
+int
+main (int argc, char* argv[])
+{
+	const int bars = argc > 1 ? atoi (argv[1]) : 4000;
+
+	if (!PBD::init ()) {
+		return 1;
+	}
+	Temporal::init ();
+
+	TempoMap linear (Tempo (120, 4), Meter (4, 4));
+	build_map (linear, bars);
+	TempoMap indexed (linear);
+
+	/* 3 positions per beat, sorted */
+	vector<Beats> beats;
+	for (int64_t ticks = 0; ticks < bars * 4 * Beats::PPQN; ticks += Beats::PPQN / 3) {
+		beats.push_back (Beats::ticks (ticks));
+	}
+
+	const size_t n = beats.size ();
+	vector<superclock_t> sc (n);
+	PBD::Timing timer;
+
+	timer.start ();
+	for (size_t i = 0; i < n; ++i) {
+		sc[i] = linear.superclock_at (beats[i]);
+	}
+	timer.update ();
+	const PBD::microseconds_t t_linear = timer.elapsed ();
+
+	timer.start ();
+	for (size_t i = 0; i < n; ++i) {
+		sc[i] = indexed.superclock_at (beats[i]);
+	}
+	timer.update ();
+	const PBD::microseconds_t t_indexed = timer.elapsed ();
+
+	timer.start ();
+	indexed.superclock_at (&beats[0], &sc[0], n);
+	timer.update ();
+	const PBD::microseconds_t t_batch = timer.elapsed ();
+
+	cout << "TempoMap: " << linear.tempos ().size () << " tempos, " << n << " Beats -> superclock conversions" << endl
+	     << "  linear search: " << t_linear << " us" << endl
+	     << "  lookup index:  " << t_indexed << " us" << endl
+	     << "  batch:         " << t_batch << " us" << endl;
+
+	return 0;
+}